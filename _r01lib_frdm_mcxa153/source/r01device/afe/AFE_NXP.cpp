@@ -9,6 +9,7 @@
 #include	"AFE_NXP.h"
 #include	"r01lib.h"
 #include	<math.h>
+#include	<stddef.h>
 
 using enum	NAFE13388_Base::Register16;
 using enum	NAFE13388_Base::Register24;
@@ -70,12 +71,20 @@ void NAFE13388_Base::LogicalChannel::configure( uint16_t cc0, uint16_t cc1, uint
 	afe_ptr->open_logical_channel( ch_number, tmp_ch_config );
 }
 
+void NAFE13388_Base::LogicalChannel::configure( const channel_setting &s )
+{
+	afe_ptr->open_logical_channel( ch_number, s );
+}
+
 
 
 /* AFE_base class ******************************************/
 
 AFE_base::AFE_base( SPI& spi, bool spi_addr, bool hsv, int nINT, int DRDY, int SYN, int nRESET, int SYNCDAC ) : 
-	SPI_for_AFE( spi, spi_addr ), highspeed_variant( hsv ), pin_nINT( nINT ), pin_DRDY( DRDY ), pin_SYN( SYN ), pin_nRESET( nRESET, 1 ), pin_SYNCDAC( SYNCDAC ), enabled_channels( 0 )
+	SPI_for_AFE( spi, spi_addr ), highspeed_variant( hsv ), pin_nINT( nINT ), pin_DRDY( DRDY ), pin_SYN( SYN ), pin_nRESET( nRESET, 1 ), pin_SYNCDAC( SYNCDAC ), enabled_channels( 0 ),
+	configured_channels( 0 ), shadow_enabled( true ), selected_page( -1 ), drdy_timestamp( 0 ), cbf_DRDY( nullptr ),
+	stream_reading( false ), stream_overrun( 0 ), stream_timestamp( 0 ), stream_sequence( 0 ), stream_channels( 0 ),
+	alarm_running( false ), alarm_pending( false ), alarm_missed( 0 ), mcu_threshold( 0 ), mcu_alarm_state( 0 ), cbf_nINT( nullptr ), nint_timestamp( 0 )
 {
 }
 
@@ -85,8 +94,10 @@ AFE_base::~AFE_base()
 
 void AFE_base::init( void )
 {
-	pin_DRDY.rise( DRDY_cb );
+	pin_DRDY.rise( [ this ](){ DRDY_cb(); } );
 	drdy_flag		= false;
+	drdy_count		= 0;
+	drdy_interval_reset();
 	set_DRDY_callback( [this](void){ default_drdy_cb(); } );
 }
 
@@ -104,6 +115,8 @@ void AFE_base::set_DRDY_callback( callback_fp_t func )
 
 void AFE_base::DRDY_cb( void )
 {
+	drdy_timestamp	= us_ticker_read();
+
 	if ( cbf_DRDY )
 		cbf_DRDY();
 }
@@ -111,9 +124,88 @@ void AFE_base::DRDY_cb( void )
 void AFE_base::default_drdy_cb( void )
 {
 	drdy_count++;
+	drdy_timing_update();
 	drdy_flag		= true;
 }
 
+void AFE_base::drdy_timing_update( void )
+{
+	uint32_t	t	= drdy_timestamp;
+	
+	if ( drdy_time_valid )
+	{
+		uint32_t	interval	= t - drdy_time;
+
+		interval_min	 = std::min( interval_min, interval );
+		interval_max	 = std::max( interval_max, interval );
+		interval_sum	+= interval;
+		interval_count++;
+	}
+	
+	drdy_time		= t;
+	drdy_time_valid	= true;
+}
+
+AFE_base::interval_stats_t AFE_base::drdy_latency( int ch, int n )
+{
+	interval_stats_t	st	= { 0, 0, 0, 0 };
+
+#if defined( DWT )
+	static volatile uint32_t	cycles;
+	callback_fp_t				saved	= cbf_DRDY;
+	uint64_t					sum		= 0;
+
+	st.min	= UINT32_MAX;
+	set_DRDY_callback( [ this ](){ cycles = DWT->CYCCNT - InterruptIn::irq_entry_cycles(); drdy_flag = true; } );
+
+	for ( auto i = 0; i < n; i++ )
+	{
+		drdy_flag	= false;
+		start( ch );
+
+		if ( wait_conversion_complete() )
+			break;
+
+		st.min	 = std::min( st.min, (uint32_t)cycles );
+		st.max	 = std::max( st.max, (uint32_t)cycles );
+		sum		+= cycles;
+		st.count++;
+	}
+
+	set_DRDY_callback( saved );
+
+	st.min	= st.count ? st.min : 0;
+	st.mean	= st.count ? (uint32_t)(sum / st.count) : 0;
+#endif
+
+	return st;
+}
+
+AFE_base::interval_stats_t AFE_base::drdy_interval_stats( void )
+{
+	interval_stats_t	st;
+
+	uint32_t	mask	= DisableGlobalIRQ();
+	st.count	= interval_count;
+	st.min		= interval_count ? interval_min : 0;
+	st.max		= interval_max;
+	st.mean		= interval_count ? (uint32_t)(interval_sum / interval_count) : 0;
+	EnableGlobalIRQ( mask );
+
+	return st;
+}
+
+void AFE_base::drdy_interval_reset( void )
+{
+	uint32_t	mask	= DisableGlobalIRQ();
+	interval_count	= 0;
+	interval_min	= UINT32_MAX;
+	interval_max	= 0;
+	interval_sum	= 0;
+	drdy_time_valid	= false;
+	EnableGlobalIRQ( mask );
+}
+
 int32_t AFE_base::start_and_read( int ch )
 {
 	double	wait_time	= cbf_DRDY ? -1.0 : ch_delay[ ch ] * delay_accuracy;
@@ -149,6 +241,20 @@ template void AFE_base::start_and_read( raw_t* data );
 template void AFE_base::start_and_read( std::vector<raw_t>& data );
 #endif
 
+void AFE_base::start_and_read( frame_t &frame )
+{
+	double	wait_time	= cbf_DRDY ? -1.0 : total_delay * delay_accuracy;
+	
+	start();
+	wait_conversion_complete( wait_time );
+	
+	frame.timestamp	= cbf_DRDY ? drdy_time : us_ticker_read();
+	frame.sequence	= drdy_count;
+	frame.count		= enabled_channels;
+
+	read( frame.data );
+}
+
 int AFE_base::bit_count( uint32_t value )
 {
 	constexpr int	bit_length	= 32;
@@ -166,18 +272,15 @@ int AFE_base::wait_conversion_complete( double delay )
 {
 	if ( 0 < delay )
 	{
-		wait( delay * delay_accuracy );
+		wait_sleep( delay * delay_accuracy );
 		return	0;
 	}
 
-	auto	timeout_count	= timeout_limit;
-
-	while ( !drdy_flag && --timeout_count )
-		;
+	bool	done	= wait_flag( drdy_flag, timeout_limit + total_delay * delay_accuracy );
 
 	drdy_flag	= false;
 
-	if ( !timeout_count )
+	if ( !done )
 	{
 		printf( "DRDY signal wait timeout\r\n" );
 		return	-1;
@@ -185,6 +288,26 @@ int AFE_base::wait_conversion_complete( double delay )
 	return	0;
 }
 
+void AFE_base::apply_setting( int ch, const channel_setting &s )
+{
+	coeff_uV[ ch ]		= s.coeff_uV;
+	mux_setting[ ch ]	= s.mux;
+	nv_scale[ ch ]		= s.nv_scale;
+	nv_offset[ ch ]		= s.nv_offset;
+	nv_shift[ ch ]		= s.nv_shift;
+	ch_delay[ ch ]		= highspeed_variant ? s.delay / 2.00 : s.delay;	//	double frequency and half delay
+
+	for ( auto i = 0; i < 4; i++ )
+		ch_config[ ch ][ i ]	= s.cc[ i ];
+
+	configured_channels	|= 1 << ch;
+}
+
+void AFE_base::channel_config_error( const char *reason )
+{
+	panic( reason );
+}
+
 void AFE_base::use_DRDY_trigger( bool use )
 {
 	if ( use )
@@ -193,6 +316,438 @@ void AFE_base::use_DRDY_trigger( bool use )
 		set_DRDY_callback( nullptr );
 }
 
+void AFE_base::start_streaming( frame_t *buffer, int depth )
+{
+	stop_streaming();
+
+	stream_buffer.storage( buffer, depth );
+	stream_overrun	= 0;
+	stream_channels	= enabled_channels;
+
+	uint32_t	mask	= DisableGlobalIRQ();
+	set_DRDY_callback( [this](void){ stream_drdy_cb(); } );
+	EnableGlobalIRQ( mask );
+
+	start_continuous_conversion();
+}
+
+void AFE_base::stop_streaming( void )
+{
+	stop_continuous_conversion();
+
+	uint32_t	mask	= DisableGlobalIRQ();
+	set_DRDY_callback( [this](void){ default_drdy_cb(); } );
+	EnableGlobalIRQ( mask );
+
+	while ( stream_reading )
+		;
+}
+
+void AFE_base::register_cache( bool enable )
+{
+	shadow_enabled	= enable;
+	shadow.clear();
+}
+
+void AFE_base::register_cache_resync( void )
+{
+	shadow.clear();
+	selected_page	= -1;
+}
+
+bool AFE_base::snapshot( snapshot_t &s )
+{
+	uint16_t	addr[ 32 ];
+	int			n;
+
+	memset( &s, 0, sizeof( s ) );
+
+	s.configured	= configured_channels;
+
+	for ( auto i = 0; i < enabled_channels; i++ )
+		s.enabled	|= 1 << sequence_order[ i ];
+
+	for ( auto ch = 0; ch < 16; ch++ )
+		for ( auto i = 0; i < 4; i++ )
+			s.cc[ ch ][ i ]	= ch_config[ ch ][ i ];
+
+	n	= config_registers( addr );
+
+	for ( auto i = 0; i < n; i++ )
+		s.config[ i ]	= read_r16( addr[ i ] );
+
+	n	= coefficient_registers( addr );
+
+	for ( auto i = 0; i < n; i++ )
+	{
+		int32_t	v	= read_r24( addr[ i ] );
+
+		s.coef[ i ][ 0 ]	= (uint8_t)(v >> 16);
+		s.coef[ i ][ 1 ]	= (uint8_t)(v >>  8);
+		s.coef[ i ][ 2 ]	= (uint8_t)(v >>  0);
+	}
+
+	//	without device CRCs, warm_start() cannot tell if the device kept the configuration: snapshot is left invalid
+
+	if ( !device_crc( s.crc_config, s.crc_coef ) )
+		return false;
+
+	s.magic	= snapshot_magic;
+	s.crc	= crc16( (const uint8_t *)&s, offsetof( snapshot_t, crc ) );
+
+	return true;
+}
+
+bool AFE_base::crc_result( uint16_t addr, uint16_t &value )
+{
+	//	CMD_CALC_CRC_* has no completion flag in status registers.
+	//	Result register is polled and taken when it reads same value in consecutive polls
+
+	constexpr auto	RETRY	= 30;
+	constexpr auto	STABLE	= 3;
+	uint16_t		prev	= read_r16( addr );
+	int				same	= 0;
+
+	for ( auto i = 0; i < RETRY; i++ )
+	{
+		wait( 0.0001 );
+		value	= read_r16( addr );
+		same	= (value == prev) ? same + 1 : 0;
+		prev	= value;
+
+		if ( STABLE <= same )
+			return true;
+	}
+
+	return false;
+}
+
+int AFE_base::warm_start( const snapshot_t &s )
+{
+	if ( (snapshot_magic != s.magic) || (s.crc != crc16( (const uint8_t *)&s, offsetof( snapshot_t, crc ) )) )
+	{
+		begin();
+		return -1;
+	}
+
+	uint16_t	addr[ 32 ];
+	uint16_t	crc_config	= 0;
+	uint16_t	crc_coef	= 0;
+	int			result		= 0;
+	int			n;
+
+	init();
+	register_cache_resync();
+
+	if ( !device_crc( crc_config, crc_coef ) )
+	{
+		reset();
+		boot();
+		result	|= WARM_RESET | WARM_CONFIG_REPLAY | WARM_COEF_REPLAY;
+	}
+
+	if ( crc_config != s.crc_config )
+		result	|= WARM_CONFIG_REPLAY;
+
+	if ( crc_coef != s.crc_coef )
+		result	|= WARM_COEF_REPLAY;
+
+	if ( result & WARM_CONFIG_REPLAY )
+	{
+		if ( !(result & WARM_RESET) )
+			boot();
+
+		n	= config_registers( addr );
+
+		for ( auto i = 0; i < n; i++ )
+			write_r16( addr[ i ], s.config[ i ] );
+	}
+
+	//	channel settings: written to the device only when configuration differs. Driver side information is always restored
+
+	for ( auto ch = 0; ch < 16; ch++ )
+	{
+		if ( !(s.configured & (1 << ch)) )
+			continue;
+
+		if ( result & WARM_CONFIG_REPLAY )
+			open_logical_channel( ch, make_channel_setting( s.cc[ ch ] ) );
+		else
+			apply_setting( ch, make_channel_setting( s.cc[ ch ] ) );
+	}
+
+	select_logical_channels( s.enabled );
+
+	if ( result & WARM_COEF_REPLAY )
+	{
+		n	= coefficient_registers( addr );
+
+		for ( auto i = 0; i < n; i++ )
+			write_r24( addr[ i ], (s.coef[ i ][ 0 ] << 16) | (s.coef[ i ][ 1 ] << 8) | s.coef[ i ][ 2 ] );
+	}
+
+	register_cache_resync();
+
+	if ( result )
+	{
+		device_crc( crc_config, crc_coef );
+
+		if ( (crc_config != s.crc_config) || (crc_coef != s.crc_coef) )
+			result	|= WARM_MISMATCH;
+	}
+
+	return result;
+}
+
+bool AFE_base::shadow_load( uint16_t addr, uint32_t &value )
+{
+	if ( !shadow_enabled )
+		return false;
+
+	switch ( register_attribute( addr ) )
+	{
+		case REG_CACHEABLE:
+			return shadow.load( addr, shadow.global_page, value );
+		case REG_PER_CHANNEL:
+			return (0 <= selected_page) && shadow.load( addr, selected_page, value );
+		default:
+			return false;
+	}
+}
+
+void AFE_base::shadow_store( uint16_t addr, uint32_t value )
+{
+	if ( !shadow_enabled )
+		return;
+
+	switch ( register_attribute( addr ) )
+	{
+		case REG_CACHEABLE:
+			shadow.store( addr, shadow.global_page, value );
+			break;
+		case REG_PER_CHANNEL:
+			if ( 0 <= selected_page )
+				shadow.store( addr, selected_page, value );
+			break;
+	}
+}
+
+void AFE_base::shadow_page( int ch )
+{
+	selected_page	= ch;
+}
+
+int AFE_base::frames_available( void )
+{
+	return stream_buffer.available();
+}
+
+int AFE_base::read_frames( frame_t *dst, int max )
+{
+	return stream_buffer.pop( dst, max );
+}
+
+uint32_t AFE_base::overrun_count( void )
+{
+	return stream_overrun;
+}
+
+bool AFE_base::set_threshold( int ch, raw_t over, raw_t under )
+{
+	uint16_t	bit	= 1 << ch;
+	bool		hw	= hardware_threshold( ch, true, over, under );
+
+	uint32_t	mask	= DisableGlobalIRQ();
+
+	threshold_over[ ch ]	 = over;
+	threshold_under[ ch ]	 = under;
+	mcu_alarm_state			&= ~bit;
+	mcu_threshold			 = hw ? (mcu_threshold & ~bit) : (mcu_threshold | bit);
+
+	EnableGlobalIRQ( mask );
+
+	return hw;
+}
+
+void AFE_base::clear_threshold( int ch )
+{
+	uint16_t	bit	= 1 << ch;
+
+	hardware_threshold( ch, false, 0, 0 );
+
+	uint32_t	mask	= DisableGlobalIRQ();
+	mcu_threshold	&= ~bit;
+	mcu_alarm_state	&= ~bit;
+	EnableGlobalIRQ( mask );
+}
+
+void AFE_base::start_alarm_events( alarm_event_t *buffer, int depth, uint16_t enable )
+{
+	stop_alarm_events();
+
+	alarm_buffer.storage( buffer, depth );
+	alarm_missed	= 0;
+	alarm_pending	= false;
+	alarm_running	= true;
+
+	uint32_t	mask	= DisableGlobalIRQ();
+	cbf_nINT	= [this](void){ alarm_pending = true; alarm_service(); };
+	EnableGlobalIRQ( mask );
+
+	pin_nINT.fall( [ this ](){ nINT_cb(); } );
+	alarm_enable( enable );
+}
+
+void AFE_base::stop_alarm_events( void )
+{
+	if ( !alarm_running )
+		return;
+
+	alarm_enable( 0x0000 );
+
+	uint32_t	mask	= DisableGlobalIRQ();
+	cbf_nINT	= nullptr;
+	EnableGlobalIRQ( mask );
+
+	alarm_running	= false;
+}
+
+int AFE_base::alarm_events_available( void )
+{
+	if ( alarm_pending )	//	retry alarm service which couldn't start in ISR
+		alarm_service();
+
+	return alarm_buffer.available();
+}
+
+int AFE_base::read_alarm_events( alarm_event_t *dst, int max )
+{
+	if ( alarm_pending )
+		alarm_service();
+
+	return alarm_buffer.pop( dst, max );
+}
+
+uint32_t AFE_base::alarm_missed_count( void )
+{
+	return alarm_missed;
+}
+
+bool AFE_base::hardware_threshold( int, bool, raw_t, raw_t )
+{
+	return false;
+}
+
+void AFE_base::alarm_enable( uint16_t )
+{
+}
+
+void AFE_base::alarm_service( void )
+{
+	alarm_pending	= false;
+}
+
+void AFE_base::post_alarm( uint32_t timestamp, int ch, uint8_t type, raw_t data )
+{
+	alarm_event_t	e	= { timestamp, (uint8_t)ch, type, data };
+
+	uint32_t	mask	= DisableGlobalIRQ();	//	events come from nINT and DRDY interrupts
+	bool		posted	= alarm_buffer.push( e );
+	EnableGlobalIRQ( mask );
+
+	if ( !posted )
+		alarm_missed++;
+}
+
+void AFE_base::compare_thresholds( const raw_t *data, int count, uint32_t timestamp )
+{
+	//	event is posted when a channel goes out of range. It is re-armed when the channel comes back
+
+	for ( auto i = 0; i < count; i++ )
+	{
+		int			ch	= sequence_order[ i ];
+		uint16_t	bit	= 1 << ch;
+
+		if ( !(mcu_threshold & bit) )
+			continue;
+
+		uint8_t	type	= (threshold_over[ ch ] < data[ i ]) ? ALARM_OVER : (data[ i ] < threshold_under[ ch ]) ? ALARM_UNDER : 0;
+
+		if ( !type )
+			mcu_alarm_state	&= ~bit;
+		else if ( !(mcu_alarm_state & bit) )
+		{
+			mcu_alarm_state	|= bit;
+
+			if ( alarm_running )
+				post_alarm( timestamp, ch, type, data[ i ] );
+		}
+	}
+}
+
+void AFE_base::nINT_cb( void )
+{
+	nint_timestamp	= us_ticker_read();
+
+	if ( cbf_nINT )
+		cbf_nINT();
+}
+
+void AFE_base::stream_drdy_cb( void )
+{
+	drdy_count++;
+	drdy_timing_update();
+
+	if ( stream_reading )
+	{
+		stream_overrun++;
+		return;
+	}
+
+	stream_timestamp	= drdy_time;
+	stream_sequence		= drdy_count;
+	stream_reading		= true;
+
+	if ( kStatus_Success != burst_nonblocking( stream_data, stream_channels, [this]( status_t status ){ stream_read_done( status ); } ) )
+	{
+		stream_reading	= false;
+		stream_overrun++;
+	}
+}
+
+void AFE_base::stream_read_done( status_t status )
+{
+	frame_t	*fp	= stream_buffer.reserve();
+
+	if ( (kStatus_Success != status) || !fp )
+	{
+		stream_overrun++;
+
+		if ( (kStatus_Success == status) && mcu_threshold )	//	alarm is checked even if the frame is lost
+		{
+			raw_t	data[ 16 ];
+
+			decode24( stream_data + command_length, data, stream_channels );
+			compare_thresholds( data, stream_channels, stream_timestamp );
+		}
+	}
+	else
+	{
+		fp->timestamp	= stream_timestamp;
+		fp->sequence	= stream_sequence;
+		fp->count		= stream_channels;
+
+		decode24( stream_data + command_length, fp->data, stream_channels );
+
+		if ( mcu_threshold )
+			compare_thresholds( fp->data, stream_channels, stream_timestamp );
+
+		stream_buffer.commit();
+	}
+
+	stream_reading	= false;
+}
+
 void AFE_base::table_view( int length, int cols, std::function<void(int)> value, std::function<void(void)> linefeed )
 {
 	const auto	raws	= (int)(length + cols - 1) / cols;
@@ -223,12 +778,11 @@ void AFE_base::table_view( int length, int cols, std::function<void(int)> value,
 }
 
 
-AFE_base::callback_fp_t	AFE_base::cbf_DRDY		= nullptr;
 
 /* NAFE13388_Base class ******************************************/
 
 NAFE13388_Base::NAFE13388_Base( SPI& spi, bool spi_addr, bool hsv, int nINT, int DRDY, int SYN, int nRESET ) 
-	: AFE_base( spi, spi_addr, hsv, nINT, DRDY, SYN, nRESET, DISABLED_PIN )
+	: AFE_base( spi, spi_addr, hsv, nINT, DRDY, SYN, nRESET, DISABLED_PIN ), alarm_state( 0 )
 {
 	for ( auto i = 0; i < 16; i++ )
 	{
@@ -256,6 +810,7 @@ void NAFE13388_Base::reset( bool hardware_reset )
 		pin_nRESET	= 0;
 		wait( 0.001 );
 		pin_nRESET	= 1;
+		register_cache_resync();
 	}
 	else
 	{
@@ -277,25 +832,21 @@ void NAFE13388_Base::reset( bool hardware_reset )
 
 void NAFE13388_Base::open_logical_channel( int ch, const uint16_t (&cc)[ 4 ] )
 {	
+	open_logical_channel( ch, make_setting( cc ) );
+}
+
+void NAFE13388_Base::open_logical_channel( int ch, const channel_setting &s )
+{	
+	batch_begin();
 	command( ch );
 
-	if ( cc[ 0 ] & 0x0010 )
-	{
-		coeff_uV[ ch ]		= ((10.0 / (double)(1L << 24)) / pga_gain[ (cc[ 0 ] >> 5) & 0x7 ]);
-		mux_setting[ ch ]	= HV_MUX;
-	}
-	else
-	{
-		coeff_uV[ ch ]		= ((10.0 / (double)(1L << 24)) / 2.5);
-		mux_setting[ ch ]	= (cc[ 0 ] >> 1) & 0x7;
-	}
-	
 	for ( auto i = 0; i < 4; i++ )
-		reg( CH_CONFIG0 + i, cc[ i ] );
+		reg( CH_CONFIG0 + i, s.cc[ i ] );
 	
+	batch_end();
+
+	apply_setting( ch, s );
 	enable_logical_channel( ch );
-	
-	ch_delay[ ch ]		= calc_delay( ch );
 }
 
 void NAFE13388_Base::channel_info_update( uint16_t value )
@@ -323,57 +874,6 @@ void NAFE13388_Base::channel_info_update( uint16_t value )
 #endif
 }
 
-double NAFE13388_Base::calc_delay( int ch )
-{
-	constexpr static double	data_rates[]	= {	   288000, 192000, 144000, 96000, 72000, 48000, 36000, 24000, 
-													18000,  12000,   9000,  6000,  4500,  3000,  2250,  1125, 
-													 562.5,    400,    300,   200,   100,    60,    50,    30, 
-														25,     20,     15,    10,   7.5, 						};
-	constexpr static uint16_t	delays[]	= {		0,   2,   4,   6,   8,  10,   12,  14, 
-												   16,  18,  20,  28,  38,  40,   42,  56, 
-												   64,  76,  90, 128, 154, 178, 204, 224, 
-												  256, 358, 512, 716, 
-												  1024, 1664, 3276, 7680, 19200, 23040, };
-	
-	command( ch );
-
-	uint16_t ch_config1	= reg( CH_CONFIG1 );
-	uint16_t ch_config2	= reg( CH_CONFIG2 );
-	
-	uint8_t		adc_data_rate		= (ch_config1 >>  3) & 0x001F;
-	uint8_t		adc_sinc			= (ch_config1 >>  0) & 0x0007;
-	uint8_t		ch_delay			= (ch_config2 >> 10) & 0x003F;
-	bool		adc_normal_setting	= (ch_config2 >>  9) & 0x0001;
-	bool		ch_chop				= (ch_config2 >>  7) & 0x0001;
-	
-	double		base_freq			= data_rates[ adc_data_rate ];
-	double		delay_setting		= delays[ ch_delay ] / 4608000.00;
-	
-	if ( highspeed_variant )
-	{
-		base_freq		*= 2.00;
-		delay_setting	/= 2.00;		
-	}
-	
-	if ( (28 < adc_data_rate) || (4 < adc_sinc) || ((adc_data_rate < 12) && (adc_sinc)) )
-		return 0.00;
-	
-	if ( !adc_normal_setting  )
-		base_freq	/= (adc_sinc + 1);
-	
-	if ( ch_chop )
-		base_freq	/= 2;
-	
-#if 0
-	printf( "base_freq = %lf\r\n", base_freq );
-	printf( "delay_setting = %lf\r\n", delay_setting  );
-	printf( "channel delay = %lf\r\n", (1 / base_freq) + delay_setting  );
-#endif
-	
-	return (1 / base_freq) + delay_setting;
-}
-
-
 void NAFE13388_Base::open_logical_channel( int ch, uint16_t cc0, uint16_t cc1, uint16_t cc2, uint16_t cc3 )
 {	
 	const ch_setting_t	tmp_ch_config	= { cc0, cc1, cc2, cc3 };
@@ -396,6 +896,12 @@ void NAFE13388_Base::close_logical_channel( int ch )
 	channel_info_update( bits );
 }
 
+void NAFE13388_Base::select_logical_channels( uint16_t bits )
+{	
+	reg( CH_CONFIG4, bits );
+	channel_info_update( bits );
+}
+
 void NAFE13388_Base::close_logical_channel( void )
 {	
 	reg( CH_CONFIG4, 0x0000 );
@@ -418,6 +924,11 @@ void NAFE13388_Base::start_continuous_conversion( void )
 	command( CMD_MC );
 }
 
+void NAFE13388_Base::stop_continuous_conversion( void )
+{
+	command( CMD_ABORT );
+}
+
 void NAFE13388_Base::DRDY_by_sequencer_done( bool flag )
 {
 	bit_op( SYS_CONFIG0, ~0x0010, flag ? 0x0010 : 0x00 );	
@@ -461,29 +972,247 @@ void NAFE13388_Base::read( std::vector<volt_t>& data_vctr )
 		data_vctr[ i ]	= raw2v( sequence_order[ i ], raw_data[ i ] );
 }
 
+void NAFE13388_Base::read( nvolt_t *data )
+{
+	raw_t	raw_data[ 16 ];
+	
+	read( raw_data );
+	
+	for ( auto i = 0; i < enabled_channels; i++ )
+		data[ i ]	= raw2nv( sequence_order[ i ], raw_data[ i ] );
+}
+
 void NAFE13388_Base::command( uint16_t com )
 {
 	write_r16( com );
+
+	if ( com <= CMD_CH15 )
+		shadow_page( com );
+	else if ( (CMD_RESET == com) || (CMD_CLEAR_REG == com) || (CMD_RELOAD == com) )
+		register_cache_resync();
 }
 
 void NAFE13388_Base::reg( Register16 r, uint16_t value )
 {
 	write_r16( static_cast<uint16_t>( r ), value );
+	shadow_store( static_cast<uint16_t>( r ), value );
 }
 
 void NAFE13388_Base::reg( Register24 r, uint32_t value )
 {
 	write_r24( static_cast<uint16_t>( r ), value );
+	shadow_store( static_cast<uint16_t>( r ), value );
 }
 
 uint16_t NAFE13388_Base::reg( Register16 r )
 {
-	return read_r16( static_cast<uint16_t>( r ) );
+	uint32_t	v;
+
+	if ( shadow_load( static_cast<uint16_t>( r ), v ) )
+		return v;
+
+	v	= read_r16( static_cast<uint16_t>( r ) );
+	shadow_store( static_cast<uint16_t>( r ), v );
+
+	return v;
 }
 
 uint32_t NAFE13388_Base::reg( Register24 r )
 {
-	return read_r24( static_cast<uint16_t>( r ) );
+	uint32_t	v;
+
+	if ( shadow_load( static_cast<uint16_t>( r ), v ) )
+		return v;
+
+	v	= read_r24( static_cast<uint16_t>( r ) );
+	shadow_store( static_cast<uint16_t>( r ), v );
+
+	return v;
+}
+
+uint8_t NAFE13388_Base::register_attribute( uint16_t addr )
+{
+	switch ( addr )
+	{
+		case static_cast<uint16_t>( CH_CONFIG0 ):
+		case static_cast<uint16_t>( CH_CONFIG1 ):
+		case static_cast<uint16_t>( CH_CONFIG2 ):
+		case static_cast<uint16_t>( CH_CONFIG3 ):
+			return REG_PER_CHANNEL;
+
+		case static_cast<uint16_t>( CH_CONFIG4 ):
+		case static_cast<uint16_t>( GPIO_CONFIG0 ):
+		case static_cast<uint16_t>( GPIO_CONFIG1 ):
+		case static_cast<uint16_t>( GPIO_CONFIG2 ):
+		case static_cast<uint16_t>( GPI_EDGE_POS ):
+		case static_cast<uint16_t>( GPI_EDGE_NEG ):
+		case static_cast<uint16_t>( GPO_DATA ):
+		case static_cast<uint16_t>( SYS_CONFIG0 ):
+		case static_cast<uint16_t>( GLOBAL_ALARM_ENABLE ):
+		case static_cast<uint16_t>( THRS_TEMP ):
+		case static_cast<uint16_t>( PN2 ):
+		case static_cast<uint16_t>( PN1 ):
+		case static_cast<uint16_t>( PN0 ):
+			return REG_CACHEABLE;
+	}
+	
+	//	CH_CONFIG5/6, gain/offset coefficients, optional coefficients and serial number
+
+	if ( (static_cast<uint16_t>( CH_CONFIG5_0 ) <= addr) && (addr <= static_cast<uint16_t>( SERIAL0 )) )
+		return REG_CACHEABLE;
+
+	return REG_VOLATILE;
+}
+
+AFE_base::channel_setting NAFE13388_Base::make_channel_setting( const uint16_t (&cc)[ 4 ] )
+{
+	return make_setting( cc );
+}
+
+bool NAFE13388_Base::device_crc( uint16_t &config, uint16_t &coef )
+{
+	constexpr uint16_t	CHIP_READY	= 1 << 13;
+
+	if ( !(reg( SYS_STATUS0 ) & CHIP_READY) )
+		return false;
+
+	command( CMD_CALC_CRC_CONFG );
+
+	if ( !crc_result( static_cast<uint16_t>( CRC_CONF_REGS ), config ) )
+		return false;
+
+	command( CMD_CALC_CRC_COEF );
+
+	return crc_result( static_cast<uint16_t>( CRC_COEF_REGS ), coef );
+}
+
+int NAFE13388_Base::config_registers( uint16_t *addr )
+{
+	constexpr Register16	list[]	= { SYS_CONFIG0, GLOBAL_ALARM_ENABLE, GPIO_CONFIG0, GPIO_CONFIG1, GPIO_CONFIG2, THRS_TEMP };
+
+	for ( auto r : list )
+		*addr++	= static_cast<uint16_t>( r );
+
+	return sizeof( list ) / sizeof( list[ 0 ] );
+}
+
+int NAFE13388_Base::coefficient_registers( uint16_t *addr )
+{
+	for ( auto i = 0; i < 16; i++ )
+	{
+		addr[ i      ]	= static_cast<uint16_t>( GAIN_COEFF0   ) + i;
+		addr[ i + 16 ]	= static_cast<uint16_t>( OFFSET_COEFF0 ) + i;
+	}
+
+	return 32;
+}
+
+bool NAFE13388_Base::hardware_threshold( int ch, bool enable, raw_t over, raw_t under )
+{
+	if ( 16 <= ch )
+		return false;
+
+	//	disabled threshold is set to full-scale, so it never makes alarm
+
+	reg( CH_CONFIG5_0 + ch, (uint32_t)(enable ? over  :  0x7FFFFF) & 0xFFFFFF );
+	reg( CH_CONFIG6_0 + ch, (uint32_t)(enable ? under : -0x800000) & 0xFFFFFF );
+
+	return true;
+}
+
+void NAFE13388_Base::alarm_enable( uint16_t bits )
+{
+	reg( GLOBAL_ALARM_ENABLE, bits );
+	command( CMD_CLEAR_ALARM );
+}
+
+void NAFE13388_Base::alarm_service( void )
+{
+	//	sequence of non-blocking transfers, driven by transfer-done callbacks:
+	//	CH_STATUS0 --> CH_STATUS1 --> CH_DATAn for each flagged channel --> CMD_CLEAR_ALARM
+
+	uint32_t	mask	= DisableGlobalIRQ();
+
+	if ( alarm_state )	//	already in progress
+	{
+		EnableGlobalIRQ( mask );
+		return;
+	}
+
+	alarm_state	= 1;
+	EnableGlobalIRQ( mask );
+
+	alarm_time	= __get_IPSR() ? nint_timestamp : us_ticker_read();
+	alarm_transfer( static_cast<uint16_t>( CH_STATUS0 ), 2, true );
+}
+
+void NAFE13388_Base::alarm_step( void )
+{
+	//	CH_STATUS0: over threshold flags, CH_STATUS1: under threshold flags. Bit n for logical channel n
+
+	uint8_t	*data	= alarm_frame + command_length;
+
+	switch ( alarm_state )
+	{
+		case 1:
+			alarm_ovr	= get_data16( data );
+			alarm_state	= 2;
+			alarm_transfer( static_cast<uint16_t>( CH_STATUS1 ), 2, true );
+			return;
+
+		case 2:
+			alarm_udr		= get_data16( data );
+			alarm_remain	= alarm_ovr | alarm_udr;
+			alarm_state		= 3;
+			break;
+
+		case 3:
+		{
+			uint16_t	bit		= 1 << alarm_channel;
+			raw_t		value	= get_data24( data );
+
+			if ( alarm_ovr & bit )
+				post_alarm( alarm_time, alarm_channel, ALARM_OVER, value );
+
+			if ( alarm_udr & bit )
+				post_alarm( alarm_time, alarm_channel, ALARM_UNDER, value );
+
+			alarm_remain	&= ~bit;
+			break;
+		}
+
+		default:	//	CMD_CLEAR_ALARM done
+			alarm_pending	= false;
+			alarm_state		= 0;
+			return;
+	}
+
+	if ( alarm_remain )
+	{
+		alarm_channel	= __builtin_ctz( alarm_remain );
+		alarm_transfer( static_cast<uint16_t>( CH_DATA0 ) + alarm_channel, 3, true );
+		return;
+	}
+
+	alarm_state	= 4;
+	alarm_transfer( CMD_CLEAR_ALARM, 0, false );
+}
+
+void NAFE13388_Base::alarm_transfer( uint16_t reg, int length, bool read )
+{
+	reg	<<= 1;
+	reg	 |= read ? 0x4000 : 0x0000;
+
+	alarm_frame[ 0 ]	= (uint8_t)(reg >> 8);
+	alarm_frame[ 1 ]	= (uint8_t)(reg & 0xFF);
+
+	if ( kStatus_Success != txrx_nonblocking( alarm_frame, command_length + length, [ this ]( status_t ){ alarm_step(); } ) )
+	{
+		//	SPI busy in interrupt: service is retried from alarm_events_available() or read_alarm_events()
+
+		alarm_missed++;
+		alarm_state	= 0;
+	}
 }
 
 uint32_t NAFE13388_Base::part_number( void )
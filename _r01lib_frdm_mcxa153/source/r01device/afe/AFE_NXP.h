@@ -54,6 +54,7 @@
 #include	<stdint.h>
 #include	"r01lib.h"
 #include	"SPI_for_AFE.h"
+#include	"RegisterShadow.h"
 #include	<cmath>
 #include	<vector>
 #include	<variant>
@@ -62,6 +63,11 @@
 
 #define		NON_TEMPLATE_VERSION_FOR_START_AND_READ
 
+/** Section for AFE_base::snapshot_t kept over MCU-only reset. Startup code doesn't clear it */
+#ifndef	AFE_SNAPSHOT_SECTION
+#define	AFE_SNAPSHOT_SECTION	__attribute__((section(".noinit")))
+#endif
+
 class AFE_base : public SPI_for_AFE
 {
 public:
@@ -69,6 +75,162 @@ public:
 	using raw_t		= int32_t;
 	using volt_t	= double;
 	using ampere_t	= double;
+	using nvolt_t	= int64_t;
+
+	/** Logical channel setting with its precomputed values
+	 *
+	 *	Made by NAFE13388_Base::ChannelConfig or NAFE33352_Base::ChannelConfig at compile time.
+	 *	Applying this needs no register readback and no floating-point caliculation
+	 */
+	typedef struct	_channel_setting	{
+		uint16_t	cc[ 4 ];	//	CH_CONFIG0~3 (AI_CONFIG0~2) register values
+		double		coeff_uV;	//	coefficient for raw2v()
+		int			mux;		//	multiplexer setting for raw2v()
+		double		delay;		//	conversion time in seconds (for normal speed variant)
+		int64_t		nv_scale;	//	raw2nv() scale
+		int64_t		nv_offset;	//	raw2nv() offset
+		uint8_t		nv_shift;	//	raw2nv() fractional bits
+		bool		pga_on;		//	PGA needs to be enabled (NAFE33352)
+	} channel_setting;
+
+	/** Conversion time caliculated from channel setting
+	 *
+	 * @param cc1 CH_CONFIG1 (AI_CONFIG1) value
+	 * @param cc2 CH_CONFIG2 (AI_CONFIG2) value
+	 * @return time in seconds for normal speed variant. 0.00 for invalid setting
+	 */
+	constexpr static double conversion_time( uint16_t cc1, uint16_t cc2 )
+	{
+		constexpr double	data_rates[]	= {	   288000, 192000, 144000, 96000, 72000, 48000, 36000, 24000, 
+												18000,  12000,   9000,  6000,  4500,  3000,  2250,  1125, 
+												 562.5,    400,    300,   200,   100,    60,    50,    30, 
+													25,     20,     15,    10,   7.5, 						};
+		constexpr uint16_t	delays[]		= {		0,   2,   4,   6,   8,  10,   12,  14, 
+											   16,  18,  20,  28,  38,  40,   42,  56, 
+											   64,  76,  90, 128, 154, 178, 204, 224, 
+											  256, 358, 512, 716, 
+											  1024, 1664, 3276, 7680, 19200, 23040, };
+
+		uint8_t		adc_data_rate		= (cc1 >>  3) & 0x001F;
+		uint8_t		adc_sinc			= (cc1 >>  0) & 0x0007;
+		uint8_t		ch_delay			= (cc2 >> 10) & 0x003F;
+		bool		adc_normal_setting	= (cc2 >>  9) & 0x0001;
+		bool		ch_chop				= (cc2 >>  7) & 0x0001;
+
+		if ( (28 < adc_data_rate) || (4 < adc_sinc) || ((adc_data_rate < 12) && (adc_sinc)) || (sizeof( delays ) / sizeof( delays[ 0 ] ) <= ch_delay) )
+			return 0.00;
+
+		double		base_freq			= data_rates[ adc_data_rate ];
+		double		delay_setting		= delays[ ch_delay ] / 4608000.00;
+
+		if ( !adc_normal_setting  )
+			base_freq	/= (adc_sinc + 1);
+		
+		if ( ch_chop )
+			base_freq	/= 2;
+		
+		return (1 / base_freq) + delay_setting;
+	}
+
+	/** Fixed-point coefficients for raw2nv()
+	 *
+	 *	Chooses fractional bits to keep (raw * scale + offset) in int64 range for full 24 bit input
+	 *
+	 * @param scale nano-volt per LSB
+	 * @param offset nano-volt at raw value 0
+	 */
+	constexpr static void fixed_coeff( double scale, double offset, int64_t &nv_s, int64_t &nv_o, uint8_t &nv_sh )
+	{
+		constexpr double	raw_max		= (double)(1L << 23);
+		constexpr double	range_max	= (double)(1LL << 62);
+		constexpr int		shift_max	= 32;
+
+		auto	abs		= []( double v ) { return (v < 0) ? -v : v; };
+		auto	round	= []( double v ) { return (int64_t)((v < 0) ? v - 0.5 : v + 0.5); };
+
+		double	range	= abs( scale ) * raw_max + abs( offset );
+		int		shift	= 0;
+
+		while ( (shift < shift_max) && (range * (double)(1LL << (shift + 1)) < range_max) )
+			shift++;
+
+		nv_s	= round( scale  * (double)(1LL << shift) );
+		nv_o	= round( offset * (double)(1LL << shift) ) + (shift ? (1LL << (shift - 1)) : 0);	//	rounding
+		nv_sh	= shift;
+	}
+
+	/** Common part of typed logical channel configuration
+	 *
+	 *	Setters are consteval: out of range value or invalid combination stops compiling
+	 */
+	template<class T>
+	class ChannelConfig_Base
+	{
+	public:
+		/** ADC data rate (0 ~ 28) */
+		consteval T	data_rate( uint8_t rate ) const
+		{
+			if ( 28 < rate )
+				channel_config_error( "data rate out of range" );
+
+			return field( 1, 3, 0x1F, rate );
+		}
+
+		/** ADC SINC filter (0 ~ 4) */
+		consteval T	sinc( uint8_t order ) const
+		{
+			if ( 4 < order )
+				channel_config_error( "SINC setting out of range" );
+
+			return field( 1, 0, 0x07, order );
+		}
+
+		/** Channel delay index (0 ~ 33) */
+		consteval T	delay( uint8_t index ) const
+		{
+			if ( 33 < index )
+				channel_config_error( "channel delay out of range" );
+
+			return field( 2, 10, 0x3F, index );
+		}
+
+		/** ADC normal setting (single-cycle settling if false) */
+		consteval T	normal_setting( bool on = true ) const
+		{
+			return field( 2, 9, 0x01, on );
+		}
+
+		/** Chopping */
+		consteval T	chop( bool on = true ) const
+		{
+			return field( 2, 7, 0x01, on );
+		}
+
+	protected:
+		constexpr ChannelConfig_Base( uint16_t cc0, uint16_t cc1, uint16_t cc2, uint16_t cc3 ) : cc{ cc0, cc1, cc2, cc3 } {}
+
+		consteval T	field( int index, int shift, uint16_t mask, uint16_t value ) const
+		{
+			T	c	= static_cast<const T&>( *this );
+
+			c.cc[ index ]	= (c.cc[ index ] & ~(mask << shift)) | ((value & mask) << shift);
+			return c;
+		}
+
+		consteval void	validate( void ) const
+		{
+			uint8_t	rate	= (cc[ 1 ] >> 3) & 0x1F;
+			uint8_t	order	= (cc[ 1 ] >> 0) & 0x07;
+
+			if ( (28 < rate) || (4 < order) || (33 < ((cc[ 2 ] >> 10) & 0x3F)) )
+				channel_config_error( "data rate, SINC or delay out of range" );
+
+			if ( (rate < 12) && order )
+				channel_config_error( "SINC filter is not available for data rate setting 0 ~ 11" );
+		}
+
+		uint16_t	cc[ 4 ];
+	};
 
 	/** Constructor to create a AFE_base instance */
 	AFE_base( SPI& spi, bool spi_addr, bool highspeed_variant, int nINT, int DRDY, int SYN, int nRESET, int SYNCDAC  );
@@ -90,8 +252,11 @@ public:
 	/** Issue RESET command */
 	virtual void reset( bool hardware_reset = false )	= 0;
 	
-	/** set callback function when DRDY comes */
-	using	callback_fp_t	= std::function<void(void)>;
+	/** set callback function when DRDY comes
+	 *
+	 *	Function pointer or small callable like "[ this ](){ ... }". No heap is used (see Delegate.h)
+	 */
+	using	callback_fp_t	= Delegate<void(void)>;
 	virtual void set_DRDY_callback( callback_fp_t fnc );
 	
 	/** Configure logical channel
@@ -111,6 +276,13 @@ public:
 	 */
 	virtual void open_logical_channel( int ch, const uint16_t (&cc)[ 4 ] )	= 0;
 
+	/** Configure logical channel with precomputed setting
+	 *
+	 * @param ch logical channel number (0 ~ 15)
+	 * @param s setting made by ChannelConfig
+	 */
+	virtual void open_logical_channel( int ch, const channel_setting &s )	= 0;
+
 	/** Logical channel disable
 	 *
 	 * @param ch logical channel number (0 ~ 15)
@@ -127,6 +299,15 @@ public:
 	 */
 	virtual void enable_logical_channel( int ch )		= 0;
 
+	/** Logical channels enable by bitmap. Channels not in the bitmap are disabled
+	 *
+	 * @param bits bit n for logical channel n
+	 */
+	virtual void select_logical_channels( uint16_t bits )	= 0;
+
+	/** Number of logical channels the device has */
+	virtual int logical_channels( void )				= 0;
+
 	/** Start ADC
 	 *
 	 * @param ch logical channel number (0 ~ 15)
@@ -141,6 +322,10 @@ public:
 	 */
 	virtual void start_continuous_conversion( void )	= 0;
 
+	/** Stop continuous AD conversion
+	 */
+	virtual void stop_continuous_conversion( void )		= 0;
+
 	/** DRDY event select
 	 *
 	 * @param set true for DRDY by sequencer is done
@@ -234,6 +419,19 @@ public:
 	 * @param value ADC read value
 	 */
 	virtual double raw2v( int ch, raw_t value )	= 0;
+
+	/** Convert raw output to nano-volt in fixed-point
+	 *
+	 *	Same conversion as raw2v() without floating-point operation.
+	 *	Uses per-channel scale and offset table prepared in open_logical_channel()
+	 *
+	 * @param ch logical channel number to select its gain coefficient
+	 * @param value ADC read value
+	 */
+	inline nvolt_t raw2nv( int ch, raw_t value )
+	{
+		return ((int64_t)value * nv_scale[ ch ] + nv_offset[ ch ]) >> nv_shift[ ch ];
+	}
 	
 	/** Coefficient to convert from ADC read value to micro-volt
 	 *
@@ -265,6 +463,12 @@ public:
 	{
 		return enabled_channels;
 	}
+
+	/** High speed variant (double data rate) */
+	inline bool highspeed( void )
+	{
+		return highspeed_variant;
+	}
 	
 	/** Switch to use DRDY to start ADC result reading
 	 *
@@ -272,6 +476,221 @@ public:
 	 */
 	void	use_DRDY_trigger( bool use = true );
 
+	/** Frame of acquisition */
+	typedef struct	_frame	{
+		uint32_t	timestamp;	//	DRDY time in micro-second
+		uint32_t	sequence;	//	DRDY count
+		int			count;		//	number of data
+		raw_t		data[ 16 ];	//	data in sequence order
+	} frame_t;
+
+	/** Start and read ADC for all channel with timestamp
+	 *
+	 *	Timestamp is taken at DRDY interrupt entry. If DRDY is not used, it is taken when the calculated delay is over
+	 *
+	 * @param frame frame to store ADC data, timestamp and DRDY count
+	 */
+	void		start_and_read( frame_t &frame );
+
+	/** DRDY interval statistics */
+	typedef struct	_interval_stats	{
+		uint32_t	count;		//	number of intervals
+		uint32_t	min;		//	micro-second
+		uint32_t	max;		//	micro-second
+		uint32_t	mean;		//	micro-second
+	} interval_stats_t;
+
+	/** Get DRDY interval statistics
+	 *
+	 *	Intervals between DRDY interrupts since last drdy_interval_reset()
+	 *
+	 * @return statistics
+	 */
+	interval_stats_t	drdy_interval_stats( void );
+
+	/** Clear DRDY interval statistics */
+	void				drdy_interval_reset( void );
+
+	/** Measure DRDY dispatch latency
+	 *
+	 *	CPU cycles from GPIO interrupt entry to DRDY callback, on single conversions of a logical channel.
+	 *	DRDY callback is replaced while measuring and restored after that.
+	 *	Needs DWT cycle counter. Result is all 0 if it's not available
+	 *
+	 * @param ch logical channel number
+	 * @param n number of conversions
+	 * @return statistics in CPU cycles (not micro-second)
+	 */
+	interval_stats_t	drdy_latency( int ch, int n = 100 );
+
+	/** Start streaming acquisition
+	 *
+	 *	Starts continuous conversion. On every DRDY, all enabled logical channels are read by non-blocking burst transfer
+	 *	and stored into ring buffer as a timestamped frame. Ring buffer holds (depth - 1) frames
+	 *
+	 * @param buffer pointer to frame array used as ring buffer storage
+	 * @param depth number of frames in the array
+	 */
+	void		start_streaming( frame_t *buffer, int depth );
+
+	/** Stop streaming acquisition
+	 */
+	void		stop_streaming( void );
+
+	/** Number of frames in ring buffer */
+	int			frames_available( void );
+
+	/** Read frames from ring buffer
+	 *
+	 * @param dst pointer to frame array to store
+	 * @param max maximum number of frames to read
+	 * @return number of frames read
+	 */
+	int			read_frames( frame_t *dst, int max );
+
+	/** Number of frames lost by SPI busy or ring buffer full */
+	uint32_t	overrun_count( void );
+
+	/** Threshold alarm event */
+	typedef struct	_alarm_event	{
+		uint32_t	timestamp;	//	nINT time (or DRDY time for MCU side comparison) in micro-second
+		uint8_t		channel;	//	logical channel
+		uint8_t		type;		//	ALARM_OVER or ALARM_UNDER
+		raw_t		data;		//	channel data when the alarm is detected
+	} alarm_event_t;
+
+	enum AlarmType : uint8_t {
+		ALARM_OVER	= 0x1,
+		ALARM_UNDER	= 0x2,
+	};
+
+	/** Set over/under thresholds of a logical channel
+	 *
+	 *	Device threshold is used if the device has a slot for the channel
+	 *	(NAFE13388: CH_CONFIG5_n/CH_CONFIG6_n, NAFE33352: AI_CH_OVR_THR_n/AI_CH_UDR_THR_n).
+	 *	Other channels are compared by MCU on streaming path (start_streaming())
+	 *
+	 * @param ch logical channel number (0 ~ 15)
+	 * @param over alarm if data is above this value
+	 * @param under alarm if data is below this value
+	 * @return true if device threshold is used, false if MCU compares
+	 */
+	bool		set_threshold( int ch, raw_t over, raw_t under );
+
+	/** Remove thresholds of a logical channel
+	 *
+	 * @param ch logical channel number (0 ~ 15)
+	 */
+	void		clear_threshold( int ch );
+
+	/** Start alarm event acquisition
+	 *
+	 *	On nINT, the ISR reads alarm status and data of the channels by non-blocking transfers and posts events into ring buffer.
+	 *	Ring buffer holds (depth - 1) events
+	 *
+	 * @param buffer pointer to event array used as ring buffer storage
+	 * @param depth number of events in the array
+	 * @param enable GLOBAL_ALARM_ENABLE value (device dependent, see datasheet)
+	 */
+	void		start_alarm_events( alarm_event_t *buffer, int depth, uint16_t enable );
+
+	/** Stop alarm event acquisition */
+	void		stop_alarm_events( void );
+
+	/** Number of events in ring buffer */
+	int			alarm_events_available( void );
+
+	/** Read events from ring buffer
+	 *
+	 * @param dst pointer to event array to store
+	 * @param max maximum number of events to read
+	 * @return number of events read
+	 */
+	int			read_alarm_events( alarm_event_t *dst, int max );
+
+	/** Number of events lost by ring buffer full, or alarm service deferred by SPI busy */
+	uint32_t	alarm_missed_count( void );
+
+	/** Enable/disable register shadow cache
+	 *
+	 *	When enabled, non-volatile registers are read from RAM copy. Register writes are always sent to the device
+	 *
+	 * @param enable true (default) to use the cache. Cache is cleared when it is disabled
+	 */
+	void		register_cache( bool enable = true );
+
+	/** Drop all cached register values
+	 *
+	 *	Call this after the device registers are changed out of this driver (e.g. reset by nRESET pin). 
+	 *	Registers are read from the device on next access
+	 */
+	void		register_cache_resync( void );
+
+	/** Configuration snapshot for warm start
+	 *
+	 *	Holds logical channel settings, device level registers, calibration coefficients and
+	 *	CRCs calculated by the device (CMD_CALC_CRC_CONFIG / CMD_CALC_CRC_COEF).
+	 *
+	 *	It is 256 bytes: whole M24C02, which keeps DACCalibration record at address 0. So the snapshot is kept in RAM
+	 *	not cleared by startup code ("AFE_SNAPSHOT_SECTION"). It survives MCU-only reset, and is read without I2C transfer.
+	 *	After power-on, the RAM has no valid magic and CRC, so warm_start() does begin()
+	 *
+	 *	@code
+	 *	AFE_SNAPSHOT_SECTION AFE_base::snapshot_t	snap;
+	 *
+	 *	if ( afe.warm_start( snap ) < 0 )
+	 *	{
+	 *		afe.logical_channel[ 0 ].configure( ... );
+	 *
+	 *		if ( !afe.snapshot( snap ) )
+	 *			printf( "snapshot failed: next reset does cold start\r\n" );
+	 *	}
+	 *	@endcode
+	 */
+	typedef struct	_snapshot	{
+		uint32_t	magic;
+		uint16_t	crc_config;				//	device CRC of configuration registers
+		uint16_t	crc_coef;				//	device CRC of coefficient registers
+		uint16_t	configured;				//	logical channels with setting
+		uint16_t	enabled;				//	logical channels enabled
+		uint16_t	cc[ 16 ][ 4 ];			//	logical channel settings
+		uint16_t	config[ 8 ];			//	device level registers, listed by config_registers()
+		uint8_t		coef[ 32 ][ 3 ];		//	coefficient registers, listed by coefficient_registers()
+		uint16_t	crc;					//	CRC of this snapshot
+	} snapshot_t;
+
+	static constexpr uint32_t	snapshot_magic	= 0x50534641;	//	"AFSP"
+
+	/** Warm start result flags. 0 when the device kept whole configuration */
+	enum WarmStart : int {
+		WARM_RESET			= 0x1,	//	device was not ready and reset
+		WARM_CONFIG_REPLAY	= 0x2,	//	configuration registers were replayed
+		WARM_COEF_REPLAY	= 0x4,	//	coefficient registers were replayed
+		WARM_MISMATCH		= 0x8,	//	device CRC still differs after replay
+	};
+
+	/** Take configuration snapshot
+	 *
+	 *	Call this after all logical channels and calibration are set.
+	 *	If device CRCs cannot be taken, the snapshot is left invalid (no magic) and warm_start() with it does begin()
+	 *
+	 * @param s snapshot to store
+	 * @return true if done, false if the device is not ready or its CRC result did not settle
+	 */
+	bool		snapshot( snapshot_t &s );
+
+	/** Warm start
+	 *
+	 *	Use this instead of begin() after MCU-only reset. Device CRCs are compared with the snapshot.
+	 *	If both match, no reset, configuration or calibration is done: only driver side channel information is restored.
+	 *	If not, only differing register group is written from the snapshot.
+	 *	Registers out of the snapshot (e.g. NAFE13388 CH_CONFIG5/6) and MCU side settings (e.g. NAFE33352 DAC full-scale range) are not restored
+	 *
+	 * @param s snapshot taken by snapshot()
+	 * @return WarmStart flags, or -1 if the snapshot is invalid (begin() is done in this case)
+	 */
+	int			warm_start( const snapshot_t &s );
+
 protected:
 	bool			highspeed_variant;
 	InterruptIn		pin_nINT;
@@ -295,6 +714,61 @@ protected:
 	/** Multiplexer setting */
 	int				mux_setting[ 16 ];
 
+	/** Q-format scale, offset and its fractional bits for raw2nv() */
+	int64_t			nv_scale[ 16 ];
+	int64_t			nv_offset[ 16 ];
+	uint8_t			nv_shift[ 16 ];
+
+	void			apply_setting( int ch, const channel_setting &s );
+
+	/** Logical channel settings given by apply_setting(), for snapshot */
+	uint16_t		ch_config[ 16 ][ 4 ];
+	uint16_t		configured_channels;
+
+	/** Device dependent part of warm start */
+	virtual channel_setting	make_channel_setting( const uint16_t (&cc)[ 4 ] )	= 0;
+
+	/** Run CMD_CALC_CRC_CONFIG and CMD_CALC_CRC_COEF
+	 *
+	 * @return false if the device is not ready or the CRC result did not settle
+	 */
+	virtual bool			device_crc( uint16_t &config, uint16_t &coef )	= 0;
+
+	/** Read result of CMD_CALC_CRC_* command
+	 *
+	 * @param addr CRC result register address
+	 * @param value CRC value
+	 * @return false if the value didn't settle
+	 */
+	bool					crc_result( uint16_t addr, uint16_t &value );
+
+	/** Lists of registers kept in snapshot
+	 *
+	 * @param addr array to store 16 bit register addresses (up to 8) or 24 bit coefficient register addresses (up to 32)
+	 * @return number of registers
+	 */
+	virtual int				config_registers( uint16_t *addr )		= 0;
+	virtual int				coefficient_registers( uint16_t *addr )	= 0;
+
+	/** Called from ChannelConfig on invalid setting. Not a constexpr, to stop compiling */
+	static void		channel_config_error( const char *reason );
+
+	/** Register shadow cache */
+	enum RegisterAttribute : uint8_t {
+		REG_VOLATILE	= 0,	//	always accessed on device
+		REG_CACHEABLE,			//	value changes only by register write
+		REG_PER_CHANNEL,		//	cacheable, selected by logical channel command
+	};
+
+	virtual uint8_t			register_attribute( uint16_t addr )	= 0;
+	bool					shadow_load( uint16_t addr, uint32_t &value );
+	void					shadow_store( uint16_t addr, uint32_t value );
+	void					shadow_page( int ch );
+
+	RegisterShadow<128>		shadow;
+	bool					shadow_enabled;
+	int						selected_page;
+
 	
 	/** Channel delay */
 	double			ch_delay[ 16 ];
@@ -304,18 +778,74 @@ protected:
 
 	uint32_t		drdy_count;
 	volatile bool	drdy_flag;
+	uint32_t		drdy_time;
+	bool			drdy_time_valid;
 
-	constexpr static uint32_t	timeout_limit	= 100000000;
+	/** DRDY time captured at interrupt entry */
+	volatile uint32_t	drdy_timestamp;
+
+	uint32_t		interval_count;
+	uint32_t		interval_min;
+	uint32_t		interval_max;
+	uint64_t		interval_sum;
+	void			drdy_timing_update( void );
+
+	/** DRDY wait timeout margin in seconds, added to caliculated delay */
+	constexpr static double		timeout_limit	= 1.0;
+
+	/** DRDY and nINT are dispatched per instance: each pin's InterruptIn callback is bound to its own AFE instance,
+	 *	so multiple AFEs can run with their own DRDY/nINT pins at the same time
+	 */
+	callback_fp_t			cbf_DRDY;
+
+	RingBuffer<frame_t>		stream_buffer;
+	volatile bool			stream_reading;
+	volatile uint32_t		stream_overrun;
+	uint32_t				stream_timestamp;
+	uint32_t				stream_sequence;
+	int						stream_channels;
+	uint8_t					stream_data[ command_length + 16 * 3 ];
 
-	static callback_fp_t	cbf_DRDY;
 public:
 	virtual void			init( void );
 protected:
 	void					default_drdy_cb( void );
+	void					stream_drdy_cb( void );
+	void					stream_read_done( status_t status );
 	
-	static void				DRDY_cb( void );
+	void					DRDY_cb( void );
 	int						wait_conversion_complete( double delay = -1.0 );
 
+	/** Static dispatch path in AFE_static.h uses conversion wait and register page tracking */
+	template<class, class> friend class AFE_static;
+
+	/** ScanPlan waits conversion of its slot with same timing as start_and_read() */
+	friend class ScanPlan;
+
+	/** Device dependent part of alarm events. Defaults are for a device without threshold slot
+	 *
+	 *	alarm_service() is called from nINT ISR. It must clear "alarm_pending" when the alarm is serviced
+	 */
+	virtual bool			hardware_threshold( int ch, bool enable, raw_t over, raw_t under );
+	virtual void			alarm_enable( uint16_t bits );
+	virtual void			alarm_service( void );
+
+	void					post_alarm( uint32_t timestamp, int ch, uint8_t type, raw_t data );
+	void					compare_thresholds( const raw_t *data, int count, uint32_t timestamp );
+
+	RingBuffer<alarm_event_t>	alarm_buffer;
+	bool					alarm_running;
+	volatile bool			alarm_pending;
+	volatile uint32_t		alarm_missed;
+	uint16_t				mcu_threshold;			//	channels compared by MCU
+	uint16_t				mcu_alarm_state;		//	channels out of range, to post event on change only
+	raw_t					threshold_over[ 16 ];
+	raw_t					threshold_under[ 16 ];
+
+	callback_fp_t			cbf_nINT;
+	volatile uint32_t		nint_timestamp;
+	void					nINT_cb( void );
+
 };
 
 class LogicalChannel_Base
@@ -391,6 +921,13 @@ public:
 	 */
 	virtual void open_logical_channel( int ch, const uint16_t (&cc)[ 4 ] );
 
+	/** Configure logical channel with precomputed setting
+	 *
+	 * @param ch logical channel number (0 ~ 15)
+	 * @param s setting made by ChannelConfig
+	 */
+	virtual void open_logical_channel( int ch, const channel_setting &s );
+
 	class LogicalChannel : public LogicalChannel_Base
 	{
 	public:
@@ -399,12 +936,12 @@ public:
 		
 		void	configure( const uint16_t (&cc)[ 4 ] );
 		void	configure( uint16_t cc0 = 0x0000, uint16_t cc1 = 0x0000, uint16_t cc2 = 0x0000, uint16_t cc3 = 0x0000 );
+		void	configure( const channel_setting &s );
 	};
 	
 	LogicalChannel	logical_channel[ 16 ];
 
 private:	
-	double 	calc_delay( int ch );
 	void 	channel_info_update( uint16_t value );
 public:
 	/** Logical channel disable
@@ -423,6 +960,15 @@ public:
 	 */
 	void	enable_logical_channel( int ch );
 
+	/** Logical channels enable by bitmap. Channels not in the bitmap are disabled
+	 *
+	 * @param bits bit n for logical channel n
+	 */
+	void	select_logical_channels( uint16_t bits );
+
+	/** Number of logical channels the device has */
+	virtual int logical_channels( void )	{ return 16; }
+
 	/** Start ADC
 	 *
 	 * @param ch logical channel number (0 ~ 15)
@@ -437,6 +983,10 @@ public:
 	 */
 	virtual void start_continuous_conversion();
 
+	/** Stop continuous AD conversion
+	 */
+	virtual void stop_continuous_conversion();
+
 	/** DRDY event select
 	 *
 	 * @param set true for DRDY by sequencer is done
@@ -473,6 +1023,12 @@ public:
 	 */
 	virtual void	read( std::vector<volt_t>& data_vctr );
 
+	/** Read ADC for all channel in nano-volt (fixed-point conversion)
+	 *
+	 * @param data_ptr pointer to array to store ADC data
+	 */
+	virtual void	read( nvolt_t *data );
+
 	inline double raw2v( int ch, raw_t value )
 	{
 		double	v	= value * coeff_uV[ ch ];
@@ -512,6 +1068,134 @@ public:
 		G_PGA_x_8_0,
 		G_PGA_x16_0,
 	};
+
+	/** Make channel setting from register values
+	 *
+	 *	No validation: invalid data rate setting gives 0.00 delay
+	 *
+	 * @param cc array for CH_CONFIG0, CH_CONFIG1, CH_CONFIG2 and CH_CONFIG3 values
+	 */
+	constexpr static channel_setting make_setting( const uint16_t (&cc)[ 4 ] )
+	{
+		constexpr double	nv		= 1e9;
+		constexpr double	lsb		= 10.0 / (double)(1L << 24);
+		channel_setting		s		= {};
+		double				a		= 1.00;		//	raw2v() = a * (raw * coeff_uV + b)
+		double				b		= 0.00;
+
+		for ( auto i = 0; i < 4; i++ )
+			s.cc[ i ]	= cc[ i ];
+
+		if ( cc[ 0 ] & 0x0010 )
+		{
+			s.coeff_uV	= lsb / pga_gain[ (cc[ 0 ] >> 5) & 0x7 ];
+			s.mux		= HV_MUX;
+		}
+		else
+		{
+			s.coeff_uV	= lsb / 2.5;
+			s.mux		= (cc[ 0 ] >> 1) & 0x7;
+		}
+
+		switch ( s.mux )
+		{
+			case REFCOARSE_REF2:
+			case VADD_REF2:
+				a	=   2.00;
+				b	=   1.50;
+				break;
+			case VHDD_REF2:
+				a	=  32.00;
+				b	=   0.25;
+				break;
+			case REF2_VHSS:
+				a	= -32.00;
+				b	=  -0.25;
+				break;
+		}
+
+		s.delay	= conversion_time( cc[ 1 ], cc[ 2 ] );
+		fixed_coeff( a * s.coeff_uV * nv, a * b * nv, s.nv_scale, s.nv_offset, s.nv_shift );
+
+		return s;
+	}
+
+	/** Typed logical channel configuration
+	 *
+	 *	Register values, conversion coefficient and delay are made at compile time.
+	 *
+	 *  Example:
+	 *  @code
+	 *  constexpr auto	ch0	= NAFE13388_Base::ChannelConfig()
+	 *  							.hv_input( 1, 7 )
+	 *  							.gain( NAFE13388_Base::G_PGA_x_0_2 )
+	 *  							.data_rate( 20 )
+	 *  							.sinc( 4 )
+	 *  							.delay( 15 )
+	 *  							.setting();
+	 *
+	 *  afe.logical_channel[ 0 ].configure( ch0 );
+	 *  @endcode
+	 */
+	class ChannelConfig : public ChannelConfig_Base<ChannelConfig>
+	{
+	public:
+		constexpr ChannelConfig() : ChannelConfig_Base( 0x0000, 0x0000, 0x0000, 0x0000 ) {}
+
+		/** Start from register values */
+		constexpr explicit ChannelConfig( uint16_t cc0, uint16_t cc1 = 0x0000, uint16_t cc2 = 0x0000, uint16_t cc3 = 0x0000 )
+			: ChannelConfig_Base( cc0, cc1, cc2, cc3 ) {}
+
+		/** HV input (HV_AIP, HV_AIM: 0 ~ 15) */
+		consteval ChannelConfig	hv_input( uint8_t aip, uint8_t aim ) const
+		{
+			if ( (15 < aip) || (15 < aim) )
+				channel_config_error( "HV input selection out of range" );
+
+			return field( 0, 12, 0xF, aip ).field( 0, 8, 0xF, aim ).field( 0, 4, 0x1, 1 );
+		}
+
+		/** LV input */
+		consteval ChannelConfig	lv_input( LV_mux_sel sel ) const
+		{
+			if ( HV_MUX <= sel )
+				channel_config_error( "LV input selection out of range" );
+
+			return field( 0, 1, 0x7, sel ).field( 0, 4, 0x1, 0 );
+		}
+
+		/** PGA gain for HV input */
+		consteval ChannelConfig	gain( GainPGA g ) const
+		{
+			return field( 0, 5, 0x7, g );
+		}
+
+		/** Gain and offset calibration coefficient set (0 ~ 15) */
+		consteval ChannelConfig	calibration( uint8_t index ) const
+		{
+			if ( 15 < index )
+				channel_config_error( "calibration index out of range" );
+
+			return field( 1, 12, 0xF, index );
+		}
+
+		/** CH_CONFIG3 value */
+		consteval ChannelConfig	config3( uint16_t value ) const
+		{
+			return field( 3, 0, 0xFFFF, value );
+		}
+
+		consteval channel_setting	setting( void ) const
+		{
+			validate();
+			return make_setting( cc );
+		}
+
+		consteval operator channel_setting() const
+		{
+			return setting();
+		}
+	};
 	
 	enum class Register16 : uint16_t {
 		CH_CONFIG0				= 0x20,
@@ -719,10 +1403,24 @@ public:
 	 * @return readout value
 	 */
 	virtual uint32_t	reg( Register24 r );
-	
+
+protected:
+	virtual uint8_t		register_attribute( uint16_t addr );
+
+	virtual channel_setting	make_channel_setting( const uint16_t (&cc)[ 4 ] );
+	virtual bool		device_crc( uint16_t &config, uint16_t &coef );
+	virtual int			config_registers( uint16_t *addr );
+	virtual int			coefficient_registers( uint16_t *addr );
+
+	/** Device threshold slots: CH_CONFIG5_n (over) and CH_CONFIG6_n (under) for logical channel 0 ~ 15 */
+	virtual bool		hardware_threshold( int ch, bool enable, raw_t over, raw_t under );
+	virtual void		alarm_enable( uint16_t bits );
+	virtual void		alarm_service( void );
+
+public:
 	/** Register bit operation
 	 *
-	 *	overwrite bits i a register
+	 *	overwrite bits i a register. Cached register is not read back from the device
 	 * @param reg register specified by Register16 or Register24 member
 	 * @param mask mask bits
 	 * @param reg value to over write
@@ -792,6 +1490,18 @@ public:
 
 	/** Blinks LEDs on GPIO pins */
 	void blink_leds( void );
+
+private:
+	void			alarm_step( void );
+	void			alarm_transfer( uint16_t reg, int length, bool read );
+
+	uint8_t			alarm_frame[ command_length + 3 ];
+	volatile int	alarm_state;
+	uint16_t		alarm_ovr;
+	uint16_t		alarm_udr;
+	uint16_t		alarm_remain;
+	int				alarm_channel;
+	uint32_t		alarm_time;
 };
 
 class NAFE13388 : public NAFE13388_Base
@@ -0,0 +1,352 @@
+/** NXP Analog Front End class library for MCX
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2026 Tedd OKANO
+ *  Released under the MIT license
+ */
+
+#include	"AFE_simulator.h"
+#include	"AFE_NXP.h"
+#include	<string.h>
+#include	<math.h>
+
+const AFE_simulator::model_spec	AFE_simulator::specs[]	= {
+	//	NAFE13388
+	{ 0x0000, 0x0010, 0x2000, 0x2002, 0x2003, 0x0020, 4, 0x0024, 0, 0x0040, 0x0031, 0x0050, 0x0060, 0x0035, 0x0036, 0, 16, { { 0x7C, 0x0001 }, { 0x7D, 0x3388 }, { 0x7E, 0x0000 } } },
+	//	NAFE33352
+	{ 0x1000, 0x1010, 0x3000, 0x3002, 0x3003, 0x1020, 3, 0x1023, 8, 0x1030, 0x002B, 0x1038, 0x1040, 0x1026, 0x1027, 8,  8, { { 0x40, 0x0000 }, { 0x41, 0x0333 }, { 0x42, 0x5200 } } },
+};
+
+AFE_simulator::AFE_simulator( Model model, bool highspeed_variant )
+	: SPI( nullptr ), spec( specs[ model ] ), highspeed( highspeed_variant ), noise_seed( 1 ), cbf_drdy( nullptr )
+{
+	for ( auto ch = 0; ch < 16; ch++ )
+		wave[ ch ]	= { DC, 0, 0.0, 0 };
+
+	now	= 0.0;
+	reset_registers();
+	reset_counters();
+}
+
+AFE_simulator::~AFE_simulator()
+{
+}
+
+void AFE_simulator::frequency( uint32_t )
+{
+}
+
+void AFE_simulator::mode( uint8_t )
+{
+}
+
+status_t AFE_simulator::write( uint8_t *wp, uint8_t *rp, int length )
+{
+	//	"wp" and "rp" can be same buffer. Header is taken before response is written
+
+	uint16_t	word	= ((wp[ 0 ] << 8) | wp[ 1 ]) & 0x7FFF;	//	SPI address bit ignored
+	bool		read	= word & 0x4000;
+	uint16_t	addr	= (word & 0x3FFE) >> 1;
+	int			width	= length - 2;
+	uint32_t	value	= 0;
+
+	bytes	+= length;
+	frames++;
+
+	for ( auto i = 0; i < width; i++ )
+		value	= (value << 8) | wp[ 2 + i ];
+
+	rp[ 0 ]	= 0;
+	rp[ 1 ]	= 0;
+
+	if ( !width )
+	{
+		command( word >> 1 );
+	}
+	else if ( read && ((addr & 0x0FFF) == 0x0005) )	//	burst read (CMD_BURST_DATA)
+	{
+		uint16_t	enabled	= enabled_bitmap();
+		int			w		= (width % 3) ? 2 : 3;	//	assumes 24 bit unless frame length tells 16 bit
+		uint8_t		*p		= rp + 2;
+
+		for ( auto ch = 0; (ch < spec.channels) && (p + w <= rp + length); ch++ )
+		{
+			if ( !(enabled & (1 << ch)) )
+				continue;
+
+			for ( auto i = w - 1; 0 <= i; i-- )
+				*p++	= data[ ch ] >> (i * 8);
+		}
+
+		while ( p < rp + length )
+			*p++	= 0;
+	}
+	else if ( read )
+	{
+		value	= reg_read( addr );
+
+		for ( auto i = width - 1; 0 <= i; i-- )
+			rp[ 2 + (width - 1 - i) ]	= value >> (i * 8);
+	}
+	else
+	{
+		reg_write( addr, value );
+
+		for ( auto i = 0; i < width; i++ )
+			rp[ 2 + i ]	= 0;
+	}
+
+	last_status	= kStatus_Success;
+	return kStatus_Success;
+}
+
+status_t AFE_simulator::write_nonblocking( uint8_t *wp, uint8_t *rp, int length, spi_callback_fp_t callback )
+{
+	status_t	r	= write( wp, rp, length );
+
+	if ( callback )
+		callback( r );
+
+	return r;
+}
+
+void AFE_simulator::waveform( int ch, Waveform type, int32_t amplitude, double frequency, int32_t offset )
+{
+	wave[ ch ]	= { type, amplitude, frequency, offset };
+}
+
+void AFE_simulator::DRDY_callback( std::function<void(void)> callback )
+{
+	cbf_drdy	= callback;
+}
+
+void AFE_simulator::run( double duration_sec )
+{
+	double	end	= now + duration_sec;
+
+	while ( continuous && (now < end) )
+	{
+		double	start	= now;
+
+		scan();
+
+		if ( now == start )	//	no enabled channel or invalid setting
+			break;
+	}
+
+	if ( now < end )
+		now	= end;
+}
+
+double AFE_simulator::time( void )
+{
+	return now;
+}
+
+double AFE_simulator::conversion_time( int ch )
+{
+	double	t	= AFE_base::conversion_time( ch_config[ ch ][ 1 ], ch_config[ ch ][ 2 ] );
+
+	return highspeed ? t / 2.00 : t;	//	double frequency and half delay
+}
+
+uint16_t AFE_simulator::alarm_status( void )
+{
+	return ((reg_read( spec.status_ovr ) | reg_read( spec.status_udr )) >> spec.status_shift) & ((1 << spec.channels) - 1);
+}
+
+uint32_t AFE_simulator::byte_count( void )
+{
+	return bytes;
+}
+
+uint32_t AFE_simulator::frame_count( void )
+{
+	return frames;
+}
+
+uint32_t AFE_simulator::drdy_count( void )
+{
+	return drdys;
+}
+
+void AFE_simulator::reset_counters( void )
+{
+	bytes	= 0;
+	frames	= 0;
+	drdys	= 0;
+}
+
+void AFE_simulator::command( uint16_t com )
+{
+	if ( (spec.cmd_ch0 <= com) && (com < spec.cmd_ch0 + spec.channels) )
+	{
+		pointer	= com - spec.cmd_ch0;
+	}
+	else if ( com == spec.cmd_abort )
+	{
+		continuous	= false;
+	}
+	else if ( com == cmd_reset )
+	{
+		reset_registers();
+	}
+	else if ( com == cmd_clear_alarm )
+	{
+		regs.store( spec.status_ovr, RegisterShadow<128>::global_page, 0 );
+		regs.store( spec.status_udr, RegisterShadow<128>::global_page, 0 );
+	}
+	else if ( com == spec.cmd_ss )
+	{
+		convert( pointer );
+
+		drdys++;
+		if ( cbf_drdy )
+			cbf_drdy();
+	}
+	else if ( com == spec.cmd_mm )
+	{
+		scan();
+	}
+	else if ( com == spec.cmd_mc )
+	{
+		continuous	= true;
+	}
+}
+
+uint32_t AFE_simulator::reg_read( uint16_t addr )
+{
+	if ( (spec.data0 <= addr) && (addr < spec.data0 + spec.channels) )
+		return data[ addr - spec.data0 ] & 0xFFFFFF;
+
+	if ( (spec.ch_config0 <= addr) && (addr < spec.ch_config0 + spec.ch_config_regs) )
+		return ch_config[ pointer ][ addr - spec.ch_config0 ];
+
+	uint32_t	value	= 0;
+	regs.load( addr, RegisterShadow<128>::global_page, value );
+
+	return value;
+}
+
+void AFE_simulator::reg_write( uint16_t addr, uint32_t value )
+{
+	if ( (spec.data0 <= addr) && (addr < spec.data0 + spec.channels) )
+		return;		//	read only
+
+	if ( (spec.ch_config0 <= addr) && (addr < spec.ch_config0 + spec.ch_config_regs) )
+	{
+		ch_config[ pointer ][ addr - spec.ch_config0 ]	= value;
+		return;
+	}
+
+	for ( auto i = 0; i < 3; i++ )
+		if ( addr == spec.pn[ i ][ 0 ] )
+			return;		//	read only
+
+	if ( (addr == spec.status) || (addr == spec.status_ovr) || (addr == spec.status_udr) )
+		return;			//	read only
+
+	regs.store( addr, RegisterShadow<128>::global_page, value );
+}
+
+void AFE_simulator::convert( int ch )
+{
+	now			+= conversion_time( ch );
+	data[ ch ]	 = input( ch );
+
+	compare( ch );
+}
+
+void AFE_simulator::compare( int ch )
+{
+	//	threshold registers hold 24 bit two's complement. Channel without threshold written never makes alarm
+
+	uint32_t	over;
+	uint32_t	under;
+
+	if ( !regs.load( spec.ovr_thr0 + ch, RegisterShadow<128>::global_page, over ) || !regs.load( spec.udr_thr0 + ch, RegisterShadow<128>::global_page, under ) )
+		return;
+
+	uint32_t	bit	= 1 << (spec.status_shift + ch);
+
+	if ( ((int32_t)(over << 8) >> 8) < data[ ch ] )
+		regs.store( spec.status_ovr, RegisterShadow<128>::global_page, reg_read( spec.status_ovr ) | bit );
+
+	if ( data[ ch ] < ((int32_t)(under << 8) >> 8) )
+		regs.store( spec.status_udr, RegisterShadow<128>::global_page, reg_read( spec.status_udr ) | bit );
+}
+
+void AFE_simulator::scan( void )
+{
+	uint16_t	enabled	= enabled_bitmap();
+
+	for ( auto ch = 0; ch < spec.channels; ch++ )
+		if ( enabled & (1 << ch) )
+			convert( ch );
+
+	drdys++;
+	if ( cbf_drdy )
+		cbf_drdy();
+}
+
+void AFE_simulator::reset_registers( void )
+{
+	regs.clear();
+	memset( ch_config, 0, sizeof( ch_config ) );
+	memset( data, 0, sizeof( data ) );
+
+	for ( auto i = 0; i < 3; i++ )
+		regs.store( spec.pn[ i ][ 0 ], RegisterShadow<128>::global_page, spec.pn[ i ][ 1 ] );
+
+	regs.store( spec.status, RegisterShadow<128>::global_page, chip_ready );
+
+	pointer		= 0;
+	continuous	= false;
+}
+
+int32_t AFE_simulator::input( int ch )
+{
+	constexpr double	pi		= 3.14159265358979323846;
+	constexpr int32_t	max		=  0x7FFFFF;
+	constexpr int32_t	min		= -0x800000;
+
+	double	phase	= now * wave[ ch ].frequency;
+	double	v		= 0.0;
+
+	phase	-= floor( phase );
+
+	switch ( wave[ ch ].type )
+	{
+		case DC:
+			v	= wave[ ch ].amplitude;
+			break;
+		case SINE:
+			v	= wave[ ch ].amplitude * sin( 2 * pi * phase );
+			break;
+		case SQUARE:
+			v	= (phase < 0.5) ? wave[ ch ].amplitude : -wave[ ch ].amplitude;
+			break;
+		case TRIANGLE:
+			v	= wave[ ch ].amplitude * ((phase < 0.5) ? (4 * phase - 1) : (3 - 4 * phase));
+			break;
+		case NOISE:
+			noise_seed	= noise_seed * 1664525 + 1013904223;	//	LCG
+			v			= wave[ ch ].amplitude * ((int32_t)noise_seed / 2147483648.0);
+			break;
+	}
+
+	v	+= wave[ ch ].offset;
+
+	if ( max < v )
+		return max;
+	if ( v < min )
+		return min;
+
+	return (int32_t)v;
+}
+
+uint16_t AFE_simulator::enabled_bitmap( void )
+{
+	return (reg_read( spec.ch_enable ) >> spec.ch_enable_shift) & ((1 << spec.channels) - 1);
+}
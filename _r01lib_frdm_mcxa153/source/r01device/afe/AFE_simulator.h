@@ -0,0 +1,175 @@
+/** NXP Analog Front End class library for MCX
+ *
+ *  @class   AFE_simulator
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2026 Tedd OKANO
+ *  Released under the MIT license
+ *
+ *  Behavioral model of NAFE13388 / NAFE33352 on SPI interface.
+ *  This can be given to AFE driver instead of SPI to run the driver without device.
+ *  Conversion results are compared with channel thresholds and set over/under status bits until CMD_CLEAR_ALARM.
+ *  nINT is not driven by the model: check alarm_status() and make the edge on the pin.
+ *
+ *  Example:
+ *  @code
+ *  #include	"r01lib.h"
+ *  #include	"afe/NAFE13388_UIM.h"
+ *  #include	"afe/AFE_simulator.h"
+ *
+ *  AFE_simulator	sim( AFE_simulator::MODEL_NAFE13388 );
+ *  NAFE13388_UIM	afe( sim );
+ *
+ *  int main( void )
+ *  {
+ *  	afe.begin();
+ *  	afe.use_DRDY_trigger( false );
+ *
+ *  	sim.waveform( 0, AFE_simulator::SINE, 1000000, 50.0 );
+ *  	afe.logical_channel[ 0 ].configure( 0x1070, 0x0084, 0x2900, 0x0000 );
+ *
+ *  	sim.reset_counters();
+ *  	AFE_base::raw_t	data	= afe.logical_channel[ 0 ];
+ *  	printf( "%ld, %lu bytes in %lu frames\r\n", data, sim.byte_count(), sim.frame_count() );
+ *  }
+ *  @endcode
+ */
+
+#ifndef ARDUINO_AFE_SIMULATOR_H
+#define ARDUINO_AFE_SIMULATOR_H
+
+#include	<stdint.h>
+#include	"r01lib.h"
+#include	"RegisterShadow.h"
+#include	<functional>
+
+class AFE_simulator : public SPI
+{
+public:
+	enum Model : uint8_t {
+		MODEL_NAFE13388,
+		MODEL_NAFE33352,
+	};
+
+	enum Waveform : uint8_t {
+		DC,
+		SINE,
+		SQUARE,
+		TRIANGLE,
+		NOISE,
+	};
+
+	/** Create an AFE_simulator instance
+	 *
+	 * @param model device to simulate
+	 * @param highspeed_variant true for high speed variant (double data rate)
+	 */
+	AFE_simulator( Model model = MODEL_NAFE13388, bool highspeed_variant = false );
+	virtual ~AFE_simulator();
+
+	virtual void		frequency( uint32_t frequency = SPI_FREQ );
+	virtual void		mode( uint8_t mode = 0 );
+	virtual status_t	write( uint8_t *wp, uint8_t *rp, int length );
+	virtual status_t	write_nonblocking( uint8_t *wp, uint8_t *rp, int length, spi_callback_fp_t callback = nullptr );
+
+	/** Set synthetic input for a logical channel
+	 *
+	 * @param ch logical channel number
+	 * @param type waveform type
+	 * @param amplitude amplitude in ADC code
+	 * @param frequency waveform frequency in Hz
+	 * @param offset DC offset in ADC code
+	 */
+	void		waveform( int ch, Waveform type, int32_t amplitude, double frequency = 0.0, int32_t offset = 0 );
+
+	/** Register callback function called on every DRDY
+	 *
+	 * @param callback function
+	 */
+	void		DRDY_callback( std::function<void(void)> callback );
+
+	/** Run continuous conversion (started by CMD_MC) for the time
+	 *
+	 *	Each completed scan makes a DRDY
+	 *
+	 * @param duration_sec simulated time to run
+	 */
+	void		run( double duration_sec );
+
+	/** Simulated time in seconds */
+	double		time( void );
+
+	/** Conversion time of a logical channel caliculated from its setting */
+	double		conversion_time( int ch );
+
+	/** Channel alarm flags: bit n is set if logical channel n went over or under its threshold since last CMD_CLEAR_ALARM */
+	uint16_t	alarm_status( void );
+
+	uint32_t	byte_count( void );
+	uint32_t	frame_count( void );
+	uint32_t	drdy_count( void );
+	void		reset_counters( void );
+
+private:
+	typedef struct	_model_spec	{
+		uint16_t	cmd_ch0;
+		uint16_t	cmd_abort;
+		uint16_t	cmd_ss;
+		uint16_t	cmd_mm;
+		uint16_t	cmd_mc;
+		uint16_t	ch_config0;
+		uint8_t		ch_config_regs;
+		uint16_t	ch_enable;
+		uint8_t		ch_enable_shift;
+		uint16_t	data0;
+		uint16_t	status;
+		uint16_t	ovr_thr0;
+		uint16_t	udr_thr0;
+		uint16_t	status_ovr;
+		uint16_t	status_udr;
+		uint8_t		status_shift;
+		uint8_t		channels;
+		uint16_t	pn[ 3 ][ 2 ];	//	address, value
+	} model_spec;
+
+	static const model_spec	specs[];
+
+	static constexpr uint16_t	cmd_reset		= 0x0014;
+	static constexpr uint16_t	cmd_clear_alarm	= 0x0012;
+	static constexpr uint16_t	chip_ready	= 1 << 13;
+
+	void		command( uint16_t com );
+	uint32_t	reg_read( uint16_t addr );
+	void		reg_write( uint16_t addr, uint32_t value );
+	void		convert( int ch );
+	void		compare( int ch );
+	void		scan( void );
+	void		reset_registers( void );
+	int32_t		input( int ch );
+	uint16_t	enabled_bitmap( void );
+
+	const model_spec	&spec;
+	bool				highspeed;
+	RegisterShadow<128>	regs;	//	sparse register file
+	uint16_t			ch_config[ 16 ][ 4 ];
+	int32_t				data[ 16 ];
+	int					pointer;
+	bool				continuous;
+	double				now;
+
+	struct	{
+		Waveform	type;
+		int32_t		amplitude;
+		double		frequency;
+		int32_t		offset;
+	}	wave[ 16 ];
+	uint32_t			noise_seed;
+
+	std::function<void(void)>	cbf_drdy;
+
+	uint32_t			bytes;
+	uint32_t			frames;
+	uint32_t			drdys;
+};
+
+#endif //	ARDUINO_AFE_SIMULATOR_H
@@ -0,0 +1,227 @@
+/** NXP Analog Front End class library for MCX
+ *
+ *  @class   AFE_static
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2026 Tedd OKANO
+ *  Released under the MIT license
+ *
+ *  Static dispatch access to AFE for per-sample path.
+ *  AFE_static is a CRTP base, with the driver class as a parameter. Device classes (NAFE13388_static, NAFE33352_static) give command codes and
+ *  register addresses as constant expressions, so start/read/convert compiles into direct SPI calls
+ *  without virtual function calls. raw2v() of the device class is called by qualified name and inlined.
+ *
+ *	This works on an existing driver instance. Configuration and other operations are done by the driver (virtual API) as before.
+ *	Data registers are read from device directly (not from register shadow) as driver does.
+ *
+ *  Example:
+ *  @code
+ *  NAFE13388_UIM		afe( spi );
+ *  NAFE13388_static	fast( afe );
+ *
+ *  int main( void )
+ *  {
+ *  	afe.begin();
+ *  	afe.logical_channel[ 0 ].configure( 0x1710, 0x00A4, 0xBC00, 0x0000 );
+ *
+ *  	while ( true )
+ *  	{
+ *  		double	v	= fast.channel( 0 );	//	same as "afe.logical_channel[ 0 ]" without virtual call
+ *  		...
+ *  	}
+ *
+ *  	//	CPU cycles of start + read + raw2v() on virtual and static paths
+ *  	auto	c	= fast.compare_dispatch( 0 );
+ *  	printf( "virtual %lu, static %lu cycles\r\n", c.virtual_path, c.static_path );
+ *  }
+ *  @endcode
+ */
+
+#ifndef ARDUINO_AFE_STATIC_H
+#define ARDUINO_AFE_STATIC_H
+
+#include	<stdint.h>
+#include	"AFE_NXP.h"
+#include	"NAFE33352.h"
+
+template<class Derived, class Device>
+class AFE_static
+{
+public:
+	using	raw_t	= AFE_base::raw_t;
+	using	volt_t	= AFE_base::volt_t;
+	using	nvolt_t	= AFE_base::nvolt_t;
+
+	/** Start a single conversion on a logical channel */
+	inline void start( int ch )
+	{
+		AFE_base	&a	= afe;
+
+		a.write_r16( Derived::select_command( ch ) );
+		a.shadow_page( ch );
+		a.write_r16( Derived::start_command );
+	}
+
+	/** Read ADC data of a logical channel */
+	inline raw_t read( int ch )
+	{
+		AFE_base	&a	= afe;
+
+		return a.read_r24( Derived::data_register( ch ) );
+	}
+
+	/** Start, wait and read. Same timing as AFE_base::start_and_read( int ch ) */
+	inline raw_t start_and_read( int ch )
+	{
+		AFE_base	&a			= afe;
+		double		wait_time	= a.cbf_DRDY ? -1.0 : a.ch_delay[ ch ] * AFE_base::delay_accuracy;
+
+		start( ch );
+		a.wait_conversion_complete( wait_time );
+
+		return read( ch );
+	}
+
+	/** Convert ADC data into volt, without virtual call */
+	inline volt_t raw2v( int ch, raw_t value )
+	{
+		return afe.Device::raw2v( ch, value );
+	}
+
+	/** Convert ADC data into nano-volt, fixed-point */
+	inline nvolt_t raw2nv( int ch, raw_t value )
+	{
+		return afe.raw2nv( ch, value );
+	}
+
+	/** Logical channel accessor, works like LogicalChannel_Base */
+	class Channel
+	{
+	public:
+		Channel( AFE_static &s, int ch ) : st( s ), ch_number( ch ) {}
+
+		operator raw_t( void )
+		{
+			return st.start_and_read( ch_number );
+		}
+
+		operator volt_t( void )
+		{
+			return st.raw2v( ch_number, st.start_and_read( ch_number ) );
+		}
+
+	private:
+		AFE_static	&st;
+		int			ch_number;
+	};
+
+	/** Get a logical channel accessor
+	 *
+	 * @param ch logical channel number
+	 */
+	inline Channel channel( int ch )
+	{
+		return Channel( *this, ch );
+	}
+
+	/** Average CPU cycles per sample */
+	typedef struct	_dispatch_cycles	{
+		uint32_t	virtual_path;	//	start(), read() and raw2v() through AFE_base
+		uint32_t	static_path;	//	same operations through this class
+	} dispatch_cycles_t;
+
+	/** Compare CPU cycles of virtual and static paths
+	 *
+	 *	Conversion is not waited. Data is read from previous conversion, so the result shows SPI and call overhead.
+	 *	With AFE_simulator as SPI, SPI transfer time is not included and the difference of dispatch is seen clearly.
+	 *	Needs DWT cycle counter. Result is 0 if it's not available
+	 *
+	 * @param ch logical channel number
+	 * @param n number of samples to average
+	 */
+	dispatch_cycles_t compare_dispatch( int ch, int n = 100 )
+	{
+		dispatch_cycles_t	c	= { 0, 0 };
+
+#if defined( DWT )
+		AFE_base			&a	= afe;
+		volatile volt_t		sink;
+		uint32_t			t;
+
+		t	= DWT->CYCCNT;
+
+		for ( auto i = 0; i < n; i++ )
+		{
+			a.start( ch );
+			sink	= a.raw2v( ch, a.read( ch ) );
+		}
+
+		c.virtual_path	= (DWT->CYCCNT - t) / n;
+
+		t	= DWT->CYCCNT;
+
+		for ( auto i = 0; i < n; i++ )
+		{
+			start( ch );
+			sink	= raw2v( ch, read( ch ) );
+		}
+
+		c.static_path	= (DWT->CYCCNT - t) / n;
+
+		(void)sink;
+#else
+		(void)ch;
+		(void)n;
+#endif
+		return c;
+	}
+
+protected:
+	AFE_static( Device &d ) : afe( d ) {}
+
+	Device	&afe;
+};
+
+/** NAFE13388 for AFE_static */
+class NAFE13388_static : public AFE_static<NAFE13388_static, NAFE13388_Base>
+{
+public:
+	using	device_t	= NAFE13388_Base;
+
+	NAFE13388_static( device_t &d ) : AFE_static( d ) {}
+
+	static constexpr uint16_t	start_command	= device_t::CMD_SS;
+
+	static constexpr uint16_t select_command( int ch )
+	{
+		return device_t::CMD_CH0 + ch;
+	}
+
+	static constexpr uint16_t data_register( int ch )
+	{
+		return static_cast<uint16_t>( device_t::Register24::CH_DATA0 ) + ch;
+	}
+};
+
+/** NAFE33352 for AFE_static */
+class NAFE33352_static : public AFE_static<NAFE33352_static, NAFE33352_Base>
+{
+public:
+	using	device_t	= NAFE33352_Base;
+
+	NAFE33352_static( device_t &d ) : AFE_static( d ) {}
+
+	static constexpr uint16_t	start_command	= device_t::CMD_SS;
+
+	static constexpr uint16_t select_command( int ch )
+	{
+		return device_t::CMD_CH0 + ch;
+	}
+
+	static constexpr uint16_t data_register( int ch )
+	{
+		return static_cast<uint16_t>( device_t::Register24::AI_DATA0 ) + ch;
+	}
+};
+
+#endif //	ARDUINO_AFE_STATIC_H
@@ -0,0 +1,435 @@
+/** NXP Analog Front End class library for MCX
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2026 Tedd OKANO
+ *  Released under the MIT license
+ *
+ *  Fixed-point filters for AFE data.
+ *  Filters work on blocks of frames in place. A block is an array of interleaved channel data,
+ *  same layout as data given by AFE_base::read( raw_t* ): frame 0 ch 0, frame 0 ch 1, .. frame 1 ch 0, ..
+ *  Each stage keeps its state per channel, for up to CH channels. No heap is used.
+ *
+ *  Example:
+ *  @code
+ *  //	median of 3 to remove spikes, then CIC decimation by 16, then 50Hz low-pass
+ *  FilterPipeline<Median<3>, CIC<16, 3>, Biquad<>>	filter;
+ *
+ *  AFE_base::raw_t	block[ 64 * 4 ];	//	64 frames of 4 channels
+ *
+ *  filter.stage<2>().coefficients( Biquad<>::lowpass( 50.0, 1000.0 ) );
+ *
+ *  while ( true )
+ *  {
+ *  	for ( auto f = 0; f < 64; f++ )
+ *  		afe.start_and_read( block + f * 4 );
+ *
+ *  	int	n	= filter.process( block, 64, 4 );	//	gives 4 frames at top of "block"
+ *  	...
+ *  @endcode
+ */
+
+#ifndef ARDUINO_AFE_CHANNEL_FILTER_H
+#define ARDUINO_AFE_CHANNEL_FILTER_H
+
+#include	<stdint.h>
+#include	<math.h>
+#include	<tuple>
+
+/** MovingAverage class
+ *
+ *	N-tap moving average. Output for each input
+ */
+template<int N, int CH = 16>
+class MovingAverage
+{
+	static_assert( 0 < N, "MovingAverage: N must be positive" );
+
+public:
+	MovingAverage() { reset(); }
+
+	void	reset( void )
+	{
+		index	= 0;
+		filled	= 0;
+
+		for ( auto c = 0; c < CH; c++ )
+		{
+			sum[ c ]	= 0;
+
+			for ( auto i = 0; i < N; i++ )
+				history[ c ][ i ]	= 0;
+		}
+	}
+
+	/** Filter a block in place
+	 *
+	 * @param data interleaved channel data
+	 * @param frames number of frames
+	 * @param channels number of channels in a frame (up to CH)
+	 * @return number of output frames
+	 */
+	int		process( int32_t *data, int frames, int channels )
+	{
+		for ( auto f = 0; f < frames; f++, data += channels )
+		{
+			if ( filled < N )
+				filled++;
+
+			for ( auto c = 0; c < channels; c++ )
+			{
+				sum[ c ]				+= data[ c ] - history[ c ][ index ];
+				history[ c ][ index ]	 = data[ c ];
+				data[ c ]				 = (int32_t)(sum[ c ] / filled);	//	average of available samples at start
+			}
+
+			index	= (index + 1 == N) ? 0 : index + 1;
+		}
+
+		return frames;
+	}
+
+private:
+	int32_t	history[ CH ][ N ];
+	int64_t	sum[ CH ];
+	int		index;
+	int		filled;
+};
+
+/** CIC class
+ *
+ *	Cascaded integrator-comb decimation filter. Decimation ratio R, ORDER stages, differential delay 1.
+ *	Output is normalized by its DC gain (R ^ ORDER)
+ */
+template<int R, int ORDER = 3, int CH = 16>
+class CIC
+{
+	static constexpr uint64_t	power( uint64_t v, int n ) { return n ? v * power( v, n - 1 ) : 1; }
+	static constexpr int		bits( uint64_t v ) { return (v <= 1) ? 0 : 1 + bits( (v + 1) / 2 ); }
+
+	static constexpr int64_t	gain	= power( R, ORDER );
+
+	static_assert( 1 < R, "CIC: decimation ratio must be 2 or more" );
+	static_assert( (0 < ORDER) && (ORDER <= 8), "CIC: order must be 1 ~ 8" );
+	static_assert( bits( gain ) + 24 < 64, "CIC: too large bit growth for 24 bit input" );
+
+public:
+	CIC() { reset(); }
+
+	void	reset( void )
+	{
+		phase	= 0;
+
+		for ( auto c = 0; c < CH; c++ )
+			for ( auto s = 0; s < ORDER; s++ )
+				integrator[ c ][ s ]	= comb[ c ][ s ]	= 0;
+	}
+
+	/** Filter a block in place
+	 *
+	 * @param data interleaved channel data
+	 * @param frames number of frames
+	 * @param channels number of channels in a frame (up to CH)
+	 * @return number of output frames. Output is stored from top of "data"
+	 */
+	int		process( int32_t *data, int frames, int channels )
+	{
+		int32_t	*out	= data;
+		int		count	= 0;
+
+		for ( auto f = 0; f < frames; f++, data += channels )
+		{
+			//	integrators run in wrap-around arithmetic. Result is correct after combs as long as it fits in 64 bit
+
+			for ( auto c = 0; c < channels; c++ )
+			{
+				uint64_t	v	= (int64_t)data[ c ];
+
+				for ( auto s = 0; s < ORDER; s++ )
+					v	= integrator[ c ][ s ]	+= v;
+			}
+
+			if ( ++phase < R )
+				continue;
+
+			phase	= 0;
+
+			for ( auto c = 0; c < channels; c++ )
+			{
+				uint64_t	v	= integrator[ c ][ ORDER - 1 ];
+
+				for ( auto s = 0; s < ORDER; s++ )
+				{
+					uint64_t	prev	= comb[ c ][ s ];
+
+					comb[ c ][ s ]	= v;
+					v				= v - prev;
+				}
+
+				int64_t	y	= (int64_t)v;
+
+				out[ c ]	= (int32_t)((y + ((y < 0) ? -gain / 2 : gain / 2)) / gain);
+			}
+
+			out	+= channels;
+			count++;
+		}
+
+		return count;
+	}
+
+private:
+	uint64_t	integrator[ CH ][ ORDER ];
+	uint64_t	comb[ CH ][ ORDER ];
+	int			phase;
+};
+
+/** Biquad class
+ *
+ *	Second order IIR filter, direct form I. Coefficients in Q2.30 with a0 normalized to 1.
+ *	lowpass() and highpass() make b terms from quantized a terms, so DC gain is exactly 1 (low-pass) or 0 (high-pass).
+ *	Output rounding error is fed back with a1 and a2 rounded to integer (error spectrum shaping).
+ *	Without it, poles near z = 1 at low fc/fs make a dead band of about 1 / (1 + a1 + a2) LSB around DC.
+ *	Impulse response stays within 2 LSB of the design in double for fc/fs 0.0001 ~ 0.2 (tools/host_test/test_filter.cpp)
+ */
+template<int CH = 16>
+class Biquad
+{
+public:
+	static constexpr int	q	= 30;
+
+	typedef struct	_coeff	{
+		int32_t	b0, b1, b2, a1, a2;
+	} coeff_t;
+
+	Biquad() : k( { 1L << q, 0, 0, 0, 0 } ) { reset(); }
+
+	void	reset( void )
+	{
+		for ( auto c = 0; c < CH; c++ )
+		{
+			x1[ c ]	= x2[ c ]	= y1[ c ]	= y2[ c ]	= 0;
+			e1[ c ]	= e2[ c ]	= 0;
+		}
+	}
+
+	/** Set coefficients */
+	void	coefficients( const coeff_t &coeff )
+	{
+		k	= coeff;
+	}
+
+	/** Coefficients from floating-point values (a0 = 1) */
+	static constexpr coeff_t	coefficients( double b0, double b1, double b2, double a1, double a2 )
+	{
+		return { fixed( b0 ), fixed( b1 ), fixed( b2 ), fixed( a1 ), fixed( a2 ) };
+	}
+
+	/** Low-pass filter coefficients (RBJ cookbook)
+	 *
+	 * @param fc cut-off frequency in Hz
+	 * @param fs sampling frequency in Hz
+	 * @param Q quality factor
+	 */
+	static coeff_t	lowpass( double fc, double fs, double Q = 0.7071 )
+	{
+		double	w		= 2.00 * M_PI * fc / fs;
+		double	alpha	= sin( w ) / (2.00 * Q);
+		double	a0		= 1.00 + alpha;
+		double	cw		= cos( w );
+		coeff_t	c		= coefficients( 0.0, 0.0, 0.0, -2.00 * cw / a0, (1.00 - alpha) / a0 );
+
+		//	b0 = b2 = b1 / 2 = (1 + a1 + a2) / 4. Sum of b is taken from quantized a for unity DC gain
+
+		int64_t	sum		= (1LL << q) + c.a1 + c.a2;
+
+		c.b0	= c.b2	= (int32_t)((sum + 2) / 4);
+		c.b1	= (int32_t)(sum - 2 * (int64_t)c.b0);
+
+		return c;
+	}
+
+	/** High-pass filter coefficients (RBJ cookbook)
+	 *
+	 * @param fc cut-off frequency in Hz
+	 * @param fs sampling frequency in Hz
+	 * @param Q quality factor
+	 */
+	static coeff_t	highpass( double fc, double fs, double Q = 0.7071 )
+	{
+		double	w		= 2.00 * M_PI * fc / fs;
+		double	alpha	= sin( w ) / (2.00 * Q);
+		double	a0		= 1.00 + alpha;
+		double	cw		= cos( w );
+		coeff_t	c		= coefficients( (1.00 + cw) / 2.00 / a0, 0.0, 0.0, -2.00 * cw / a0, (1.00 - alpha) / a0 );
+
+		//	b1 = -2 * b0 exactly: no DC leak
+
+		c.b2	= c.b0;
+		c.b1	= -2 * c.b0;
+
+		return c;
+	}
+
+	/** Filter a block in place
+	 *
+	 * @param data interleaved channel data
+	 * @param frames number of frames
+	 * @param channels number of channels in a frame (up to CH)
+	 * @return number of output frames
+	 */
+	int		process( int32_t *data, int frames, int channels )
+	{
+		constexpr int64_t	round	= 1LL << (q - 1);
+		const int64_t		f1		= -(((int64_t)k.a1 + round) >> q);
+		const int64_t		f2		= -(((int64_t)k.a2 + round) >> q);
+
+		for ( auto f = 0; f < frames; f++, data += channels )
+		{
+			for ( auto c = 0; c < channels; c++ )
+			{
+				int32_t	x	= data[ c ];
+				int64_t	acc	= (int64_t)k.b0 * x + (int64_t)k.b1 * x1[ c ] + (int64_t)k.b2 * x2[ c ]
+							- (int64_t)k.a1 * y1[ c ] - (int64_t)k.a2 * y2[ c ]
+							+ f1 * e1[ c ] + f2 * e2[ c ];
+				int32_t	y	= (int32_t)((acc + round) >> q);
+
+				e2[ c ]		= e1[ c ];
+				e1[ c ]		= (int32_t)(acc - ((int64_t)y << q));
+				x2[ c ]		= x1[ c ];
+				x1[ c ]		= x;
+				y2[ c ]		= y1[ c ];
+				y1[ c ]		= y;
+				data[ c ]	= y;
+			}
+		}
+
+		return frames;
+	}
+
+private:
+	static constexpr int32_t	fixed( double v )
+	{
+		return (int32_t)((v < 0) ? v * (1L << q) - 0.5 : v * (1L << q) + 0.5);
+	}
+
+	coeff_t	k;
+	int32_t	x1[ CH ], x2[ CH ], y1[ CH ], y2[ CH ];
+	int32_t	e1[ CH ], e2[ CH ];		//	rounding error of last outputs, in Q30
+};
+
+/** Median class
+ *
+ *	Median of last N samples. Output for each input
+ */
+template<int N, int CH = 16>
+class Median
+{
+	static_assert( (0 < N) && (N & 1), "Median: N must be odd number" );
+
+public:
+	Median() { reset(); }
+
+	void	reset( void )
+	{
+		index	= 0;
+		started	= false;
+	}
+
+	/** Filter a block in place
+	 *
+	 * @param data interleaved channel data
+	 * @param frames number of frames
+	 * @param channels number of channels in a frame (up to CH)
+	 * @return number of output frames
+	 */
+	int		process( int32_t *data, int frames, int channels )
+	{
+		for ( auto f = 0; f < frames; f++, data += channels )
+		{
+			if ( !started )		//	window is filled by first sample
+			{
+				for ( auto c = 0; c < channels; c++ )
+					for ( auto i = 0; i < N; i++ )
+						history[ c ][ i ]	= sorted[ c ][ i ]	= data[ c ];
+
+				started	= true;
+			}
+
+			for ( auto c = 0; c < channels; c++ )
+			{
+				int32_t	*s		= sorted[ c ];
+				int32_t	old		= history[ c ][ index ];
+				int32_t	x		= data[ c ];
+				int		i		= 0;
+
+				history[ c ][ index ]	= x;
+
+				//	remove oldest sample from sorted window, then insert new one
+
+				while ( s[ i ] != old )
+					i++;
+
+				for ( ; (0 < i) && (x < s[ i - 1 ]); i-- )
+					s[ i ]	= s[ i - 1 ];
+
+				for ( ; (i < N - 1) && (s[ i + 1 ] < x); i++ )
+					s[ i ]	= s[ i + 1 ];
+
+				s[ i ]		= x;
+				data[ c ]	= s[ N / 2 ];
+			}
+
+			index	= (index + 1 == N) ? 0 : index + 1;
+		}
+
+		return frames;
+	}
+
+private:
+	int32_t	history[ CH ][ N ];
+	int32_t	sorted[ CH ][ N ];
+	int		index;
+	bool	started;
+};
+
+/** FilterPipeline class
+ *
+ *	Stages are processed in given order. Decimating stage reduces frames for following stages
+ */
+template<class... Stages>
+class FilterPipeline
+{
+public:
+	FilterPipeline() {}
+
+	/** Filter a block in place
+	 *
+	 * @param data interleaved channel data
+	 * @param frames number of frames
+	 * @param channels number of channels in a frame
+	 * @return number of output frames. Output is stored from top of "data"
+	 */
+	int		process( int32_t *data, int frames, int channels )
+	{
+		std::apply( [ & ]( auto&... s ){ ( (frames = frames ? s.process( data, frames, channels ) : 0), ... ); }, stages );
+		return frames;
+	}
+
+	void	reset( void )
+	{
+		std::apply( []( auto&... s ){ ( s.reset(), ... ); }, stages );
+	}
+
+	/** Access to a stage */
+	template<int I>
+	auto&	stage( void )
+	{
+		return std::get<I>( stages );
+	}
+
+private:
+	std::tuple<Stages...>	stages;
+};
+
+#endif //	ARDUINO_AFE_CHANNEL_FILTER_H
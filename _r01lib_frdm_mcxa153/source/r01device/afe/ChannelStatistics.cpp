@@ -0,0 +1,193 @@
+/** NXP Analog Front End class library for MCX
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2026 Tedd OKANO
+ *  Released under the MIT license
+ */
+
+#include	"ChannelStatistics.h"
+#include	<math.h>
+
+ChannelStatistics::ChannelStatistics()
+{
+	for ( auto c = 0; c < channels; c++ )
+		hist[ c ]	= { nullptr, 0, 0, 0, 0, 0 };
+
+	reset();
+}
+
+ChannelStatistics::~ChannelStatistics()
+{
+}
+
+void ChannelStatistics::reset( void )
+{
+	for ( auto c = 0; c < channels; c++ )
+	{
+		acc[ c ]	= { 0, 0, INT32_MAX, INT32_MIN, 0, 0, 0 };
+
+		hist[ c ].under	= 0;
+		hist[ c ].over	= 0;
+
+		for ( auto i = 0; i < hist[ c ].n_bins; i++ )
+			hist[ c ].bins[ i ]	= 0;
+	}
+}
+
+int ChannelStatistics::process( int32_t *data, int frames, int n_ch )
+{
+	for ( auto f = 0; f < frames; f++, data += n_ch )
+	{
+		for ( auto c = 0; c < n_ch; c++ )
+		{
+			accumulator_t	&a	= acc[ c ];
+			int32_t			x	= data[ c ];
+
+			if ( !a.count++ )
+				a.ref	= x;
+
+			//	shifted data keeps sums small. Sum of squares is carried into 96 bit, never overflows.
+			//	|d| is up to 2^32 - 1, so square is taken unsigned
+
+			int64_t		d	= (int64_t)x - a.ref;
+			uint64_t	m	= (d < 0) ? -d : d;
+			uint64_t	sq	= m * m;
+
+			a.sum	+= d;
+			a.sq_lo	+= sq;
+
+			if ( a.sq_lo < sq )
+				a.sq_hi++;
+
+			if ( x < a.min )
+				a.min	= x;
+
+			if ( a.max < x )
+				a.max	= x;
+
+			hist_t	&h	= hist[ c ];
+
+			if ( !h.bins )
+				continue;
+
+			int32_t	i	= (x - h.low) >> h.shift;
+
+			if ( x < h.low )
+				h.under++;
+			else if ( h.n_bins <= i )
+				h.over++;
+			else
+				h.bins[ i ]++;
+		}
+	}
+
+	return frames;
+}
+
+void ChannelStatistics::histogram( int ch, uint32_t *bins, int n_bins, int32_t low, int shift )
+{
+	hist[ ch ]	= { bins, bins ? n_bins : 0, low, shift, 0, 0 };
+
+	for ( auto i = 0; i < hist[ ch ].n_bins; i++ )
+		bins[ i ]	= 0;
+}
+
+uint32_t ChannelStatistics::histogram_underflow( int ch )
+{
+	return hist[ ch ].under;
+}
+
+uint32_t ChannelStatistics::histogram_overflow( int ch )
+{
+	return hist[ ch ].over;
+}
+
+ChannelStatistics::summary_t ChannelStatistics::summary( int ch )
+{
+	const accumulator_t	&a	= acc[ ch ];
+	summary_t			s	= { a.count, 0.00, 0.00, 0.00, a.min, a.max, a.max - a.min };
+
+	if ( !a.count )
+		return { 0, 0.00, 0.00, 0.00, 0, 0, 0 };
+
+	double	n		= a.count;
+	double	dmean	= a.sum / n;
+	double	sq		= ldexp( (double)a.sq_hi, 64 ) + (double)a.sq_lo;
+	double	var		= (1 < a.count) ? (sq - a.sum * dmean) / (n - 1) : 0.00;
+
+	s.mean		= a.ref + dmean;
+	s.stddev	= sqrt( (0.00 < var) ? var : 0.00 );
+	s.rms		= sqrt( (sq + 2.00 * a.ref * a.sum) / n + (double)a.ref * a.ref );
+
+	return s;
+}
+
+void ChannelStatistics::print( AFE_base& afe, uint16_t mask )
+{
+	printf( " ch     count       mean[V]      noise[V]   p2p[V]        min       max\r\n" );
+
+	for ( auto p = 0, c = 0; p < channels; p++, c++ )
+	{
+		while ( (c < channels) && !(mask & (1 << c)) )
+			c++;
+
+		if ( channels <= c )
+			break;
+
+		summary_t	s	= summary( p );
+
+		if ( !s.count )
+			continue;
+
+		double	lsb	= afe.raw2v( c, 1 ) - afe.raw2v( c, 0 );
+
+		printf( " %2d %9lu %13.9lf %13.9lf %10.3le %9ld %9ld\r\n", c, s.count, afe.raw2v( c, 0 ) + s.mean * lsb, s.stddev * lsb, s.p2p * lsb, s.min, s.max );
+	}
+}
+
+int ChannelStatistics::noise_sweep( AFE_base& afe, int ch, const uint16_t (&cc)[ 4 ], int samples, noise_point_t *table, int first, int last )
+{
+	constexpr uint8_t	rate_sinc_first	= 12;	//	SINC filter can be used at data rate setting 12 or slower
+
+	ChannelStatistics	st;
+	uint16_t			c[ 4 ]	= { cc[ 0 ], cc[ 1 ], cc[ 2 ], cc[ 3 ] };
+	int					n		= 0;
+
+	for ( auto r = first; r <= last; r++ )
+	{
+		if ( (cc[ 1 ] & 0x0007) && (r < rate_sinc_first) )
+			continue;
+
+		c[ 1 ]	= (cc[ 1 ] & ~0x00F8) | (r << 3);
+
+		double	t	= AFE_base::conversion_time( c[ 1 ], c[ 2 ] );
+
+		if ( 0.00 == t )
+			continue;
+
+		afe.open_logical_channel( ch, c );
+		st.reset();
+
+		for ( auto i = 0; i < samples; i++ )
+		{
+			AFE_base::raw_t	v	= afe.start_and_read( ch );
+			st.process( &v, 1, 1 );
+		}
+
+		summary_t	s	= st.summary( 0 );
+		double		lsb	= afe.raw2v( ch, 1 ) - afe.raw2v( ch, 0 );
+
+		table[ n++ ]	= { (uint8_t)r, (afe.highspeed() ? 2.00 : 1.00) / t, afe.raw2v( ch, 0 ) + s.mean * lsb, s.stddev * lsb, s.p2p * lsb };
+	}
+
+	return n;
+}
+
+void ChannelStatistics::print( const noise_point_t *table, int n )
+{
+	printf( " rate          SPS       mean[V]      noise[V]     p2p[V]\r\n" );
+
+	for ( auto i = 0; i < n; i++ )
+		printf( "  %2d %12.1lf %13.9lf %13.9lf %10.3le\r\n", table[ i ].data_rate, table[ i ].sps, table[ i ].mean, table[ i ].noise, table[ i ].p2p );
+}
@@ -0,0 +1,163 @@
+/** NXP Analog Front End class library for MCX
+ *
+ *  @class   ChannelStatistics
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2026 Tedd OKANO
+ *  Released under the MIT license
+ *
+ *  Streaming statistics for noise characterization.
+ *  Per-channel count, mean, standard deviation (RMS noise), RMS, min/max and peak-to-peak,
+ *  with optional ADC code histogram. Accumulation uses integer operation only, so it can be done at full data rate
+ *  (in DRDY interrupt or on frames from AFE_base::read_frames()). Floating-point caliculation is done when summary is taken.
+ *
+ *	process() has same interface as stages in ChannelFilter.h, so it can be placed in a FilterPipeline.
+ *
+ *  Example:
+ *  @code
+ *  ChannelStatistics	stats;
+ *  uint32_t			bins[ 256 ];
+ *
+ *  int main( void )
+ *  {
+ *  	afe.begin();
+ *  	afe.logical_channel[ 0 ].configure( 0x1710, 0x00A4, 0xBC00, 0x0000 );
+ *
+ *  	stats.histogram( 0, bins, 256, -128 );	//	channel 0: codes -128 ~ +127
+ *
+ *  	for ( auto i = 0; i < 10000; i++ )
+ *  	{
+ *  		AFE_base::raw_t	v	= afe.logical_channel[ 0 ];
+ *  		stats.process( &v, 1, 1 );
+ *  	}
+ *
+ *  	stats.print( afe, 0x0001 );	//	position 0 is logical channel 0
+ *
+ *  	//	noise vs data rate table
+ *  	ChannelStatistics::noise_point_t	table[ 29 ];
+ *  	int	n	= ChannelStatistics::noise_sweep( afe, 0, { 0x1710, 0x00A4, 0xBC00, 0x0000 }, 256, table );
+ *  	ChannelStatistics::print( table, n );
+ *  }
+ *  @endcode
+ */
+
+#ifndef ARDUINO_AFE_CHANNEL_STATISTICS_H
+#define ARDUINO_AFE_CHANNEL_STATISTICS_H
+
+#include	<stdint.h>
+#include	"AFE_NXP.h"
+
+class ChannelStatistics
+{
+public:
+	/** Summary of a channel. Values are in ADC code */
+	typedef struct	_summary	{
+		uint32_t	count;
+		double		mean;
+		double		stddev;		//	RMS noise
+		double		rms;
+		int32_t		min;
+		int32_t		max;
+		int32_t		p2p;
+	} summary_t;
+
+	/** A row of noise sweep table. Values are in volt */
+	typedef struct	_noise_point	{
+		uint8_t		data_rate;	//	ADC_DATA_RATE setting
+		double		sps;		//	conversion rate
+		double		mean;
+		double		noise;		//	RMS noise
+		double		p2p;
+	} noise_point_t;
+
+	static constexpr int	channels	= 16;
+
+	ChannelStatistics();
+	virtual ~ChannelStatistics();
+
+	/** Clear all accumulation. Histogram settings are kept */
+	void		reset( void );
+
+	/** Accumulate a block of interleaved channel data
+	 *
+	 * @param data interleaved channel data (frame 0 ch 0, frame 0 ch 1, .. frame 1 ch 0, ..)
+	 * @param frames number of frames
+	 * @param channels number of channels in a frame (up to 16)
+	 * @return number of frames (data is not changed)
+	 */
+	int			process( int32_t *data, int frames, int channels );
+
+	/** Set histogram for a channel
+	 *
+	 * @param ch channel position in a frame
+	 * @param bins array for bin counts. nullptr to disable
+	 * @param n_bins number of bins
+	 * @param low code of first bin
+	 * @param shift bin width in power of 2 (0 for 1 code per bin)
+	 */
+	void		histogram( int ch, uint32_t *bins, int n_bins, int32_t low, int shift = 0 );
+
+	/** Number of samples out of histogram range (below, above) */
+	uint32_t	histogram_underflow( int ch );
+	uint32_t	histogram_overflow( int ch );
+
+	/** Summary of a channel
+	 *
+	 * @param ch channel position in a frame
+	 */
+	summary_t	summary( int ch );
+
+	/** Print summary of all channels which have data
+	 *
+	 *	Frame positions are mapped on logical channels in "mask" in channel number order, same as AFE_base::read( raw_t * ).
+	 *	Values are converted into volt and printed with the logical channel number
+	 *
+	 * @param afe AFE to convert values into volt
+	 * @param mask logical channels of the frame (bit n for logical channel n)
+	 */
+	void		print( AFE_base& afe, uint16_t mask = 0xFFFF );
+
+	/** Noise vs data rate sweep
+	 *
+	 *	Logical channel is configured with each ADC_DATA_RATE setting and measured by single conversions.
+	 *	Channel setting is left with last data rate
+	 *
+	 * @param afe AFE to measure
+	 * @param ch logical channel number
+	 * @param cc channel setting. Data rate field is replaced
+	 * @param samples number of conversions for each data rate
+	 * @param table array to store result
+	 * @param first first ADC_DATA_RATE setting
+	 * @param last last ADC_DATA_RATE setting
+	 * @return number of rows stored
+	 */
+	static int	noise_sweep( AFE_base& afe, int ch, const uint16_t (&cc)[ 4 ], int samples, noise_point_t *table, int first = 0, int last = 28 );
+
+	/** Print noise sweep table */
+	static void	print( const noise_point_t *table, int n );
+
+private:
+	typedef struct	_accumulator	{
+		uint32_t	count;
+		int32_t		ref;		//	first sample. Sums are taken on difference from this
+		int32_t		min;
+		int32_t		max;
+		int64_t		sum;
+		uint64_t	sq_lo;		//	sum of squares in 96 bit (sq_hi:sq_lo)
+		uint32_t	sq_hi;
+	} accumulator_t;
+
+	typedef struct	_hist	{
+		uint32_t	*bins;
+		int			n_bins;
+		int32_t		low;
+		int			shift;
+		uint32_t	under;
+		uint32_t	over;
+	} hist_t;
+
+	accumulator_t	acc[ channels ];
+	hist_t			hist[ channels ];
+};
+
+#endif //	ARDUINO_AFE_CHANNEL_STATISTICS_H
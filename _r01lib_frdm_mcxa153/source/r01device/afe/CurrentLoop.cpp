@@ -0,0 +1,280 @@
+/** NXP Analog Front End class library for MCX
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2026 Tedd OKANO
+ *  Released under the MIT license
+ */
+
+#include	"CurrentLoop.h"
+#include	<math.h>
+#include	<algorithm>
+
+static inline void frame_header( uint8_t *frame, uint16_t reg, bool read )
+{
+	reg	<<= 1;
+	reg	 |= read ? 0x4000 : 0x0000;
+
+	frame[ 0 ]	= (uint8_t)(reg >> 8);
+	frame[ 1 ]	= (uint8_t)(reg & 0xFF);
+}
+
+CurrentLoop::CurrentLoop( NAFE33352_Base& afe_, int ch, double sense_resistance )
+	: afe( afe_ ), channel( ch ), resistance( sense_resistance ), kp_f( 0.00 ), ki_f( 0.00 ), target_f( 0.00 ), period( 1e-3 ), running( false ),
+	target( 0 ), feedforward( 0 ), kp( 0 ), ki( 0 ), integral( 0 ), code( 0 ), measured( 0 ), phase( IDLE ), stalled( false ),
+	tick_time( 0 ), tick_prev( 0 ), tick_prev_valid( false ), cycles( 0 ), lates( 0 ), errors( 0 )
+{
+	interval_reset();
+}
+
+CurrentLoop::~CurrentLoop()
+{
+	stop();
+}
+
+void CurrentLoop::gains( double p, double i )
+{
+	kp_f	= p;
+	ki_f	= i;
+
+	update_coefficients();
+}
+
+void CurrentLoop::setpoint( double current )
+{
+	target_f	= current;
+
+	update_coefficients();
+}
+
+bool CurrentLoop::start( float rate )
+{
+	//	attach() would take UTICK from its present user. Restart of own loop is allowed
+
+	if ( !running && Ticker::in_use() )
+		return false;
+
+	stop();
+
+	period	= 1.00 / rate;
+	update_coefficients();
+
+	integral	= 0;
+	code		= feedforward;
+	phase		= IDLE;
+	stalled		= false;
+	cycles		= 0;
+	lates		= 0;
+	errors		= 0;
+	interval_reset();
+
+	afe.command( NAFE33352_Base::CMD_CH0 + channel );	//	CMD_SS converts this channel
+
+	uint32_t	mask	= DisableGlobalIRQ();
+	afe.set_DRDY_callback( [ this ](){ drdy(); } );
+	EnableGlobalIRQ( mask );
+
+	running	= true;
+	ticker.attach( [ this ](){ tick(); }, 1.0f / rate );
+
+	return true;
+}
+
+void CurrentLoop::stop( void )
+{
+	if ( !running )
+		return;
+
+	ticker.detach();
+	running	= false;
+
+	while ( (WRITING == phase) || (READING == phase) )	//	wait for transfer in progress
+		;
+
+	uint32_t	mask	= DisableGlobalIRQ();
+	phase	= IDLE;
+	afe.use_DRDY_trigger( true );
+	EnableGlobalIRQ( mask );
+}
+
+double CurrentLoop::current( void )
+{
+	return afe.raw2v( channel, measured ) / resistance;
+}
+
+int32_t CurrentLoop::output_code( void )
+{
+	return code << (24 - bits);
+}
+
+uint32_t CurrentLoop::cycle_count( void )
+{
+	return cycles;
+}
+
+uint32_t CurrentLoop::late_count( void )
+{
+	return lates;
+}
+
+uint32_t CurrentLoop::error_count( void )
+{
+	return errors;
+}
+
+AFE_base::interval_stats_t CurrentLoop::interval_stats( void )
+{
+	AFE_base::interval_stats_t	st;
+	uint32_t	mask	= DisableGlobalIRQ();
+
+	st.count	= interval_count;
+	st.min		= interval_count ? interval_min : 0;
+	st.max		= interval_max;
+	st.mean		= interval_count ? (uint32_t)(interval_sum / interval_count) : 0;
+
+	EnableGlobalIRQ( mask );
+	return st;
+}
+
+uint32_t CurrentLoop::latency_max( void )
+{
+	return latency;
+}
+
+void CurrentLoop::interval_reset( void )
+{
+	uint32_t	mask	= DisableGlobalIRQ();
+
+	tick_prev_valid	= false;
+	interval_count	= 0;
+	interval_min	= UINT32_MAX;
+	interval_max	= 0;
+	interval_sum	= 0;
+	latency			= 0;
+
+	EnableGlobalIRQ( mask );
+}
+
+void CurrentLoop::update_coefficients( void )
+{
+	//	all floating-point conversions are done here, out of interrupt
+
+	double	v_offset		= afe.raw2v( channel, 0 );
+	double	v_lsb			= afe.raw2v( channel, 1 ) - v_offset;
+	double	fs				= afe.dac.full_scale_range();
+	double	codes_per_amp	= (0.00 < fs) ? -(double)(1L << (bits - 1)) / fs : 0.00;	//	same sign as dac_code()
+	double	g				= (0.00 != v_lsb) ? v_lsb / resistance * codes_per_amp : 0.00;	//	DAC code per ADC code
+
+	int32_t	t	= (0.00 != v_lsb) ? (int32_t)lround( (target_f * resistance - v_offset) / v_lsb ) : 0;
+	int32_t	ff	= (int32_t)std::clamp( lround( target_f * codes_per_amp ), (long)code_min, (long)code_max );
+	int32_t	p	= (int32_t)lround( kp_f * g * (1L << q) );
+	int32_t	i	= (int32_t)lround( ki_f * period * g * (1L << q) );
+
+	uint32_t	mask	= DisableGlobalIRQ();
+
+	target		= t;
+	feedforward	= ff;
+	kp			= p;
+	ki			= i;
+
+	EnableGlobalIRQ( mask );
+}
+
+void CurrentLoop::tick( void )
+{
+	uint32_t	t	= us_ticker_read();
+
+	if ( tick_prev_valid )
+	{
+		uint32_t	interval	= t - tick_prev;
+
+		interval_min	 = std::min( interval_min, interval );
+		interval_max	 = std::max( interval_max, interval );
+		interval_sum	+= interval;
+		interval_count++;
+	}
+
+	tick_prev		= t;
+	tick_prev_valid	= true;
+
+	if ( IDLE != phase )
+	{
+		//	DRDY missing for 2 periods: conversion is given up and new cycle is started
+
+		if ( (CONVERTING != phase) || !stalled )
+		{
+			stalled	= (CONVERTING == phase);
+			lates++;
+			return;
+		}
+
+		errors++;
+	}
+
+	stalled		= false;
+	tick_time	= t;
+	phase		= WRITING;
+
+	int32_t	c	= code << (24 - bits);
+
+	frame_header( ao_frame, static_cast<uint16_t>( NAFE33352_Base::Register24::AO_DATA ), false );
+	ao_frame[ 2 ]	= (uint8_t)(c >> 16);
+	ao_frame[ 3 ]	= (uint8_t)(c >>  8);
+	ao_frame[ 4 ]	= (uint8_t)(c >>  0);
+
+	if ( kStatus_Success != afe.txrx_nonblocking( ao_frame, sizeof( ao_frame ), [ this ]( status_t ){ convert(); } ) )
+		abort_cycle();
+}
+
+void CurrentLoop::convert( void )
+{
+	//	conversion is started after AO_DATA update, so the read-back reflects new output
+
+	phase	= CONVERTING;
+
+	frame_header( ss_frame, NAFE33352_Base::CMD_SS, false );
+
+	if ( kStatus_Success != afe.txrx_nonblocking( ss_frame, sizeof( ss_frame ) ) )
+		abort_cycle();
+}
+
+void CurrentLoop::drdy( void )
+{
+	if ( CONVERTING != phase )
+		return;
+
+	phase	= READING;
+
+	frame_header( rd_frame, static_cast<uint16_t>( NAFE33352_Base::Register24::AI_DATA0 ) + channel, true );
+
+	if ( kStatus_Success != afe.txrx_nonblocking( rd_frame, sizeof( rd_frame ), [ this ]( status_t ){ done(); } ) )
+		abort_cycle();
+}
+
+void CurrentLoop::done( void )
+{
+	int32_t	m	= (int32_t)(((uint32_t)rd_frame[ 2 ] << 24) | ((uint32_t)rd_frame[ 3 ] << 16) | ((uint32_t)rd_frame[ 4 ] << 8)) >> 8;
+	int32_t	e	= target - m;
+
+	//	PI with anti-windup: integral is limited so that it alone doesn't exceed DAC range
+
+	int64_t	i_min	= (int64_t)(code_min - feedforward) << q;
+	int64_t	i_max	= (int64_t)(code_max - feedforward) << q;
+
+	integral	= std::clamp( integral + (int64_t)ki * e, i_min, i_max );
+
+	int64_t	u	= feedforward + (((int64_t)kp * e + integral) >> q);
+
+	measured	= m;
+	code		= (int32_t)std::clamp( u, (int64_t)code_min, (int64_t)code_max );
+
+	latency		= std::max( latency, us_ticker_read() - tick_time );
+	cycles++;
+	phase		= IDLE;
+}
+
+void CurrentLoop::abort_cycle( void )
+{
+	errors++;
+	phase	= IDLE;
+}
@@ -0,0 +1,178 @@
+/** NXP Analog Front End class library for MCX
+ *
+ *  @class   CurrentLoop
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2026 Tedd OKANO
+ *  Released under the MIT license
+ *
+ *  Closed-loop current output regulation for NAFE33352.
+ *  At fixed period, AO_DATA is updated and loop current is read back through an AI logical channel
+ *  (voltage on a sense resistor). A fixed-point PI controller makes next AO_DATA value from the read-back.
+ *
+ *	One control cycle runs in interrupt context with non-blocking SPI transfers:
+ *		Ticker: AO_DATA write --> CMD_SS --> DRDY: AI_DATAn read --> PI calculation
+ *	New output is applied at next Ticker interrupt, so update timing doesn't depend on conversion and SPI timing.
+ *	If a cycle is not finished by next Ticker interrupt, that update is skipped and counted as "late".
+ *
+ *	Ticker (UTICK) and DRDY callback are used while the loop is running. Only one Ticker can be used at a time: start() fails if UTICK is in use.
+ *	Other access to the AFE is not allowed while the loop is running.
+ *
+ *  Example:
+ *  @code
+ *  NAFE33352_UIOM	afe( spi );
+ *  CurrentLoop		loop( afe, 0, 250.0 );	//	logical channel 0 reads voltage on 250 ohm sense resistor
+ *
+ *  int main( void )
+ *  {
+ *  	afe.begin();
+ *  	afe.dac.configure( NAFE33352_Base::DAC::ModeSelect::CURRENT );
+ *  	afe.logical_channel[ 0 ].configure( 0x5400, 0x0070, 0x4C00 );
+ *
+ *  	loop.gains( 0.2, 200.0 );
+ *  	loop.setpoint( 0.012 );		//	12 mA
+ *  	if ( !loop.start( 1000.0 ) )	//	1 kHz control loop
+ *  		panic( "UTICK is used by other Ticker" );
+ *
+ *  	while ( true )
+ *  	{
+ *  		AFE_base::interval_stats_t	st	= loop.interval_stats();
+ *  		printf( "%lf mA, period %lu .. %lu us\r\n", loop.current() * 1e3, st.min, st.max );
+ *  		wait( 1 );
+ *  	}
+ *  }
+ *  @endcode
+ */
+
+#ifndef ARDUINO_AFE_CURRENT_LOOP_H
+#define ARDUINO_AFE_CURRENT_LOOP_H
+
+#include	<stdint.h>
+#include	"r01lib.h"
+#include	"NAFE33352.h"
+
+class CurrentLoop
+{
+public:
+	/** Create a CurrentLoop instance
+	 *
+	 * @param afe NAFE33352 to control
+	 * @param ch logical channel to read loop current (0 ~ 7). It must be configured before start()
+	 * @param sense_resistance resistance to convert read-back voltage into current in ohm
+	 */
+	CurrentLoop( NAFE33352_Base& afe, int ch, double sense_resistance );
+	virtual ~CurrentLoop();
+
+	/** Set PI gains
+	 *
+	 * @param kp proportional gain (output current change per current error)
+	 * @param ki integral gain in 1/s
+	 */
+	void		gains( double kp, double ki );
+
+	/** Set target current
+	 *
+	 *	Can be changed while the loop is running. Integral term is kept
+	 *
+	 * @param current target current in A
+	 */
+	void		setpoint( double current );
+
+	/** Start the loop
+	 *
+	 * @param rate control loop rate in Hz
+	 * @return false if UTICK is used by other Ticker (or wait_flag()). Loop is not started
+	 */
+	bool		start( float rate );
+
+	/** Stop the loop. Output keeps last value */
+	void		stop( void );
+
+	/** Last read-back current in A */
+	double		current( void );
+
+	/** Last AO_DATA value written */
+	int32_t		output_code( void );
+
+	/** Number of completed control cycles */
+	uint32_t	cycle_count( void );
+
+	/** Number of updates skipped because previous cycle was not finished */
+	uint32_t	late_count( void );
+
+	/** Number of cycles aborted because SPI was busy or DRDY didn't come in 2 periods */
+	uint32_t	error_count( void );
+
+	/** Update interval statistics
+	 *
+	 *	Intervals between Ticker interrupts (AO_DATA update timing) since last interval_reset()
+	 *
+	 * @return statistics
+	 */
+	AFE_base::interval_stats_t	interval_stats( void );
+
+	/** Longest time from AO_DATA update to PI calculation done, in micro-second */
+	uint32_t	latency_max( void );
+
+	/** Clear update interval statistics and latency */
+	void		interval_reset( void );
+
+private:
+	static constexpr int	q		= 16;	//	fractional bits of PI gains and integral
+	static constexpr int	bits	= 18;	//	DAC resolution
+	static constexpr int32_t	code_max	=  (1L << (bits - 1)) - 1;
+	static constexpr int32_t	code_min	= -(1L << (bits - 1));
+
+	enum Phase : uint8_t {
+		IDLE,
+		WRITING,		//	AO_DATA write
+		CONVERTING,		//	CMD_SS sent, waiting DRDY
+		READING,		//	AI_DATAn read
+	};
+
+	void		update_coefficients( void );
+	void		tick( void );
+	void		convert( void );
+	void		drdy( void );
+	void		done( void );
+	void		abort_cycle( void );
+
+	NAFE33352_Base&	afe;
+	Ticker			ticker;
+	int				channel;
+	double			resistance;
+	double			kp_f;
+	double			ki_f;
+	double			target_f;
+	double			period;
+	bool			running;
+
+	//	values used in interrupt, made by update_coefficients()
+	int32_t			target;			//	target in ADC code
+	int32_t			feedforward;	//	DAC code for target without correction
+	int32_t			kp;				//	Q16: DAC code per ADC code
+	int32_t			ki;				//	Q16: DAC code per ADC code per cycle
+	int64_t			integral;		//	Q16
+	volatile int32_t	code;
+	volatile int32_t	measured;
+
+	volatile Phase	phase;
+	bool			stalled;
+	uint8_t			ao_frame[ 5 ];
+	uint8_t			ss_frame[ 2 ];
+	uint8_t			rd_frame[ 5 ];
+
+	uint32_t			tick_time;
+	uint32_t			tick_prev;
+	bool				tick_prev_valid;
+	volatile uint32_t	cycles;
+	volatile uint32_t	lates;
+	volatile uint32_t	errors;
+	uint32_t			interval_count;
+	uint32_t			interval_min;
+	uint32_t			interval_max;
+	uint64_t			interval_sum;
+	uint32_t			latency;
+};
+
+#endif //	ARDUINO_AFE_CURRENT_LOOP_H
@@ -0,0 +1,230 @@
+/** NXP Analog Front End class library for MCX
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2026 Tedd OKANO
+ *  Released under the MIT license
+ */
+
+#include	"DACCalibration.h"
+#include	<math.h>
+#include	<string.h>
+#include	<stddef.h>
+#include	<algorithm>
+
+using enum	NAFE33352_Base::Register24;
+
+constexpr int32_t	unity_gain	= 0x400000;
+
+DACCalibration::DACCalibration( NAFE33352_Base& afe_, int ch, double scale_, int coef )
+	: afe( afe_ ), channel( ch ), scale( scale_ ), coef_set( coef )
+{
+	res.gain			= 1.00;
+	res.offset			= 0.00;
+	res.residual_max	= 0.00;
+	res.gain_coef		= unity_gain;
+	res.offset_coef		= 0;
+	res.points			= 0;
+}
+
+DACCalibration::~DACCalibration()
+{
+}
+
+int DACCalibration::sweep( const double *setpoints, int n, double settle, int average )
+{
+	if ( (n < 2) || (max_points < n) || (average < 1) )
+		return -1;
+
+	double	x[ max_points ];
+	double	y[ max_points ];
+
+	std::copy( setpoints, setpoints + n, x );
+	std::sort( x, x + n );
+
+	//	measure with unity coefficients. Previous coefficients are restored if calibration fails
+
+	uint32_t	prev_gain	= afe.reg( GAIN_COEF0   + coef_set );
+	uint32_t	prev_offset	= afe.reg( OFFSET_COEF0 + coef_set );
+
+	auto	restore	= [ & ]( void )
+	{
+		afe.reg( GAIN_COEF0   + coef_set, prev_gain );
+		afe.reg( OFFSET_COEF0 + coef_set, prev_offset );
+
+		return -1;
+	};
+
+	afe.reg( GAIN_COEF0   + coef_set, unity_gain );
+	afe.reg( OFFSET_COEF0 + coef_set, 0 );
+
+	for ( auto i = 0; i < n; i++ )
+	{
+		afe.dac.output( x[ i ] );
+		wait( settle );
+
+		y[ i ]	= measure( average );
+	}
+
+	afe.dac.output( 0.00 );
+
+	//	least squares fit: y = gain * x + offset
+
+	double	sx	= 0.00, sy	= 0.00, sxx	= 0.00, sxy	= 0.00;
+
+	for ( auto i = 0; i < n; i++ )
+	{
+		sx	+= x[ i ];
+		sy	+= y[ i ];
+		sxx	+= x[ i ] * x[ i ];
+		sxy	+= x[ i ] * y[ i ];
+	}
+
+	double	d	= n * sxx - sx * sx;
+
+	if ( 0.00 == d )
+		return restore();
+
+	double	gain	= (n * sxy - sx * sy) / d;
+	double	offset	= (sy - gain * sx) / n;
+
+	if ( !(0.50 < gain && gain < 2.00) )	//	GAIN_COEFn range and sanity
+		return restore();
+
+	//	DAC applies the coefficients on code: gain coef in Q22, offset coef in AO_DATA code scale.
+	//	Same relation as in shasta_co_calibration
+
+	res.gain			= gain;
+	res.offset			= offset;
+	res.gain_coef		= (int32_t)lround( unity_gain / gain );
+	res.offset_coef		= (int32_t)lround( codes_per_unit() * offset / gain );
+	res.points			= n;
+	res.residual_max	= 0.00;
+
+	for ( auto i = 0; i < n; i++ )
+	{
+		double	r	= y[ i ] - (gain * x[ i ] + offset);
+
+		res.setpoint[ i ]	= x[ i ];
+		res.inl[ i ]		= r;
+		res.residual_max	= std::max( res.residual_max, fabs( r ) );
+	}
+
+	apply();
+
+	return 0;
+}
+
+void DACCalibration::apply( void )
+{
+	afe.reg( GAIN_COEF0   + coef_set, (uint32_t)res.gain_coef   & 0xFFFFFF );
+	afe.reg( OFFSET_COEF0 + coef_set, (uint32_t)res.offset_coef & 0xFFFFFF );
+}
+
+int DACCalibration::save( M24C02& eeprom, int address )
+{
+	//	M24C02::write() sends page_size blocks from the address. A block not aligned to page wraps in the page
+
+	if ( (address < 0) || (address % M24C02::page_size) || (M24C02::size < address + record_size) )
+		return -1;
+
+	record_t	r;
+
+	memset( &r, 0, sizeof( r ) );
+
+	r.magic			= magic;
+	r.version		= version;
+	r.coef			= coef_set;
+	r.points		= res.points;
+	r.gain_coef		= res.gain_coef;
+	r.offset_coef	= res.offset_coef;
+	r.gain			= res.gain;
+	r.offset		= res.offset;
+
+	for ( auto i = 0; i < res.points; i++ )
+	{
+		r.setpoint[ i ]	= res.setpoint[ i ];
+		r.inl[ i ]		= res.inl[ i ];
+	}
+
+	r.crc	= crc16( (uint8_t *)&r, offsetof( record_t, crc ) );
+
+	return (record_size == eeprom.write( address, (uint8_t *)&r, record_size )) ? 0 : -1;
+}
+
+int DACCalibration::load( M24C02& eeprom, int address )
+{
+	record_t	r;
+
+	if ( (address < 0) || (M24C02::size < address + record_size) )
+		return -1;
+
+	if ( record_size != eeprom.read( address, (uint8_t *)&r, record_size ) )
+		return -1;
+
+	if ( (magic != r.magic) || (version != r.version) || (coef_set != r.coef) || (max_points < r.points) )
+		return -1;
+
+	if ( r.crc != crc16( (uint8_t *)&r, offsetof( record_t, crc ) ) )
+		return -1;
+
+	res.gain			= r.gain;
+	res.offset			= r.offset;
+	res.gain_coef		= r.gain_coef;
+	res.offset_coef		= r.offset_coef;
+	res.points			= r.points;
+	res.residual_max	= 0.00;
+
+	for ( auto i = 0; i < res.points; i++ )
+	{
+		res.setpoint[ i ]	= r.setpoint[ i ];
+		res.inl[ i ]		= r.inl[ i ];
+		res.residual_max	= std::max( res.residual_max, fabs( (double)r.inl[ i ] ) );
+	}
+
+	return 0;
+}
+
+double DACCalibration::compensate( double value )
+{
+	if ( res.points < 2 )
+		return value;
+
+	int	i	= 1;
+
+	while ( (i < res.points - 1) && (res.setpoint[ i ] < value) )
+		i++;
+
+	double	x0	= res.setpoint[ i - 1 ];
+	double	x1	= res.setpoint[ i ];
+	double	r0	= res.inl[ i - 1 ];
+	double	r1	= res.inl[ i ];
+
+	double	r	= (x1 != x0) ? r0 + (r1 - r0) * (value - x0) / (x1 - x0) : r0;
+
+	return value - r;
+}
+
+const DACCalibration::result_t& DACCalibration::result( void )
+{
+	return res;
+}
+
+double DACCalibration::measure( int average )
+{
+	double	sum	= 0.00;
+
+	for ( auto i = 0; i < average; i++ )
+		sum	+= afe.raw2v( channel, afe.start_and_read( channel ) );
+
+	return sum / average * scale;
+}
+
+double DACCalibration::codes_per_unit( void )
+{
+	//	AO_DATA code (24 bit scale) per output value, same sign as dac_code()
+
+	double	fs	= afe.dac.full_scale_range();
+
+	return (0.00 < fs) ? -(double)(1L << 23) / fs : 0.00;
+}
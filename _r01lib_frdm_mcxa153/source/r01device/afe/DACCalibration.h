@@ -0,0 +1,160 @@
+/** NXP Analog Front End class library for MCX
+ *
+ *  @class   DACCalibration
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2026 Tedd OKANO
+ *  Released under the MIT license
+ *
+ *  Multi-point DAC calibration for NAFE33352.
+ *  DAC output is stepped through setpoints and measured by an AI logical channel (internal read-back or external reference).
+ *  Gain and offset are fitted by least squares and written into GAIN_COEFn/OFFSET_COEFn (coefficient set selected by AO_CAL_COEF).
+ *	Residuals from the fit are kept as a piecewise-linear INL table for software correction by compensate().
+ *  Result can be stored in M24C02 EEPROM with CRC, and reloaded at boot.
+ *
+ *  Example:
+ *  @code
+ *  NAFE33352_UIOM	afe( spi );
+ *  I2C				i2c( I2C_SDA, I2C_SCL );
+ *  M24C02			eeprom( i2c );
+ *  DACCalibration	cal( afe, 0, 1.0 / 250.0 );	//	logical channel 0 reads voltage on 250 ohm sense resistor
+ *
+ *  const double	points[]	= { -0.020, -0.010, 0.000, 0.010, 0.020 };
+ *
+ *  int main( void )
+ *  {
+ *  	afe.begin();
+ *  	afe.dac.configure( NAFE33352_Base::DAC::ModeSelect::CURRENT );
+ *  	afe.logical_channel[ 0 ].configure( 0x5400, 0x0070, 0x4C00 );
+ *
+ *  	if ( cal.load( eeprom ) )	//	no valid data in EEPROM
+ *  	{
+ *  		cal.sweep( points, 5 );
+ *  		cal.save( eeprom );
+ *  	}
+ *
+ *  	cal.apply();
+ *  	...
+ *  @endcode
+ */
+
+#ifndef ARDUINO_AFE_DAC_CALIBRATION_H
+#define ARDUINO_AFE_DAC_CALIBRATION_H
+
+#include	<stdint.h>
+#include	"r01lib.h"
+#include	"NAFE33352.h"
+#include	"misc/eeprom/M24C02.h"
+
+class DACCalibration
+{
+public:
+	static constexpr int	max_points	= 16;
+
+	/** Calibration result */
+	typedef struct	_result	{
+		double		gain;					//	measured output / setpoint
+		double		offset;					//	measured output at setpoint 0 (V or A)
+		double		residual_max;			//	largest residual from the fit (V or A)
+		int32_t		gain_coef;				//	GAIN_COEFn value
+		int32_t		offset_coef;			//	OFFSET_COEFn value
+		int			points;					//	number of INL table points
+		float		setpoint[ max_points ];	//	INL table: setpoints in ascending order
+		float		inl[ max_points ];		//	INL table: residuals from the fit
+	} result_t;
+
+	/** Create a DACCalibration instance
+	 *
+	 * @param afe NAFE33352 to calibrate
+	 * @param ch logical channel to measure the output. It must be configured before sweep()
+	 * @param scale output value (V or A) per volt on the logical channel
+	 * @param coef coefficient set used by DAC (selected by AO_CAL_COEF, 1 by DAC::configure())
+	 */
+	DACCalibration( NAFE33352_Base& afe, int ch, double scale, int coef = 1 );
+	virtual ~DACCalibration();
+
+	/** Run calibration
+	 *
+	 *	Coefficients are set to unity while measuring, then fitted values are written.
+	 *	If the fit is invalid, previous coefficients are written back and result is not changed.
+	 *	Output is set to 0 after the sweep
+	 *
+	 * @param setpoints output values to measure (V or A)
+	 * @param n number of setpoints (2 ~ max_points)
+	 * @param settle wait time after each DAC update in seconds
+	 * @param average number of conversions averaged for each setpoint
+	 * @return 0 if done, -1 if setpoints or fit is invalid
+	 */
+	int			sweep( const double *setpoints, int n, double settle = 0.010, int average = 4 );
+
+	/** Write GAIN_COEFn/OFFSET_COEFn from result */
+	void		apply( void );
+
+	/** Store result in EEPROM
+	 *
+	 * @param eeprom M24C02 instance
+	 * @param address byte address to store. Record needs record_size bytes (154).
+	 *	Address must be on a page boundary (M24C02::page_size) and the record must fit in M24C02::size.
+	 *	M24C02 has no room for AFE_base::snapshot_t with it, so the snapshot is kept in RAM (see AFE_SNAPSHOT_SECTION)
+	 * @return 0 if done, -1 if address is invalid or write failed
+	 */
+	int			save( M24C02& eeprom, int address = 0 );
+
+	/** Load result from EEPROM
+	 *
+	 *	Result is not changed if the record is invalid. Call apply() to write coefficients
+	 *
+	 * @param eeprom M24C02 instance
+	 * @param address byte address of the record
+	 * @return 0 if valid record is loaded, -1 if not (or the record does not fit in M24C02::size)
+	 */
+	int			load( M24C02& eeprom, int address = 0 );
+
+	/** Correct INL by the table
+	 *
+	 *	Residual is linearly interpolated between table points (extrapolated by end segments).
+	 *	Use this for value given to DAC::output() or DAC::codes()
+	 *
+	 * @param value output value (V or A)
+	 * @return value to be set to DAC
+	 */
+	double		compensate( double value );
+
+	/** Calibration result */
+	const result_t&	result( void );
+
+	static constexpr uint32_t	magic		= 0x4C414344;	//	"DCAL"
+	static constexpr uint8_t	version		= 1;
+
+private:
+	/** EEPROM record. Values are kept in MCU byte order */
+	typedef struct	__attribute__((packed))	_record	{
+		uint32_t	magic;
+		uint8_t		version;
+		uint8_t		coef;
+		uint8_t		points;
+		uint8_t		reserved;
+		int32_t		gain_coef;
+		int32_t		offset_coef;
+		float		gain;
+		float		offset;
+		float		setpoint[ max_points ];
+		float		inl[ max_points ];
+		uint16_t	crc;
+	} record_t;
+
+public:
+	static constexpr int		record_size	= sizeof( record_t );
+
+private:
+	double		measure( int average );
+	double		codes_per_unit( void );
+
+	NAFE33352_Base&	afe;
+	int				channel;
+	double			scale;
+	int				coef_set;
+	result_t		res;
+};
+
+#endif //	ARDUINO_AFE_DAC_CALIBRATION_H
@@ -0,0 +1,105 @@
+/** NXP Analog Front End class library for MCX
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2026 Tedd OKANO
+ *  Released under the MIT license
+ */
+
+#include	"DACPlayback.h"
+
+DACPlayback::DACPlayback( NAFE33352_Base& afe_ )
+	: afe( afe_ ), tables( queue_storage, depth + 1 ), position( 0 ), loop( false ), running( false ), updates( 0 ), underruns( 0 ), lates( 0 )
+{
+}
+
+DACPlayback::~DACPlayback()
+{
+	stop();
+}
+
+bool DACPlayback::queue( const int32_t *codes, int length )
+{
+	if ( !codes || (length <= 0) )
+		return false;
+
+	return tables.push( { codes, length } );
+}
+
+bool DACPlayback::start( float rate, bool repeat )
+{
+	//	attach() would take UTICK from its present user. Restart of own playback is allowed
+
+	if ( !running && Ticker::in_use() )
+		return false;
+
+	loop		= repeat;
+	position	= 0;
+	running		= true;
+
+	ticker.attach( [ this ](){ tick(); }, 1.0f / rate );
+
+	return true;
+}
+
+void DACPlayback::stop( void )
+{
+	if ( running )
+		ticker.detach();
+
+	running	= false;
+	tables.clear();
+}
+
+int DACPlayback::space( void )
+{
+	return tables.space();
+}
+
+bool DACPlayback::playing( void )
+{
+	return running && !tables.empty();
+}
+
+uint32_t DACPlayback::update_count( void )
+{
+	return updates;
+}
+
+uint32_t DACPlayback::underrun_count( void )
+{
+	return underruns;
+}
+
+uint32_t DACPlayback::late_count( void )
+{
+	return lates;
+}
+
+void DACPlayback::tick( void )
+{
+	table_t	*t	= tables.peek();
+
+	if ( !t )
+	{
+		underruns++;
+		return;
+	}
+
+	//	timing is kept even if the SPI is busy: the sample is skipped
+
+	if ( kStatus_Success == afe.dac_write_nonblocking( t->codes[ position ] ) )
+		updates++;
+	else
+		lates++;
+
+	if ( ++position < t->length )
+		return;
+
+	position	= 0;
+
+	if ( loop && (1 == tables.available()) )	//	repeat until next table comes
+		return;
+
+	tables.release();
+}
@@ -0,0 +1,114 @@
+/** NXP Analog Front End class library for MCX
+ *
+ *  @class   DACPlayback
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2026 Tedd OKANO
+ *  Released under the MIT license
+ *
+ *  Timer driven DAC playback for NAFE33352.
+ *  Tables of AO_DATA codes are output at fixed update rate. Tables are queued (double buffered),
+ *  so next table can be prepared while current one is played.
+ *  Codes are made before playback by NAFE33352_Base::DAC::codes(), no floating-point caliculation in the timer interrupt.
+ *
+ *	Ticker (UTICK) is used for timing. Only one Ticker can be used at a time: start() fails if UTICK is in use.
+ *
+ *  Example:
+ *  @code
+ *  NAFE33352_UIOM	afe( spi );
+ *  DACPlayback		player( afe );
+ *
+ *  double	ramp[ 100 ];
+ *  int32_t	table[ 100 ];
+ *
+ *  int main( void )
+ *  {
+ *  	afe.begin();
+ *  	afe.dac.configure( NAFE33352_Base::DAC::ModeSelect::VOLTAGE );
+ *
+ *  	for ( auto i = 0; i < 100; i++ )
+ *  		ramp[ i ]	= i * 0.05;
+ *
+ *  	afe.dac.codes( ramp, table, 100 );
+ *
+ *  	player.queue( table, 100 );
+ *  	if ( !player.start( 1000.0, true ) )	//	1k samples/s, repeat the table
+ *  		panic( "UTICK is used by other Ticker" );
+ *  	...
+ *  @endcode
+ */
+
+#ifndef ARDUINO_AFE_DAC_PLAYBACK_H
+#define ARDUINO_AFE_DAC_PLAYBACK_H
+
+#include	<stdint.h>
+#include	"r01lib.h"
+#include	"NAFE33352.h"
+
+class DACPlayback
+{
+public:
+	/** Create a DACPlayback instance
+	 *
+	 * @param afe NAFE33352 to output
+	 */
+	DACPlayback( NAFE33352_Base& afe );
+	virtual ~DACPlayback();
+
+	/** Queue a table
+	 *
+	 * @param codes AO_DATA codes. Must be kept until played
+	 * @param length number of codes
+	 * @return false if queue is full
+	 */
+	bool		queue( const int32_t *codes, int length );
+
+	/** Start playback
+	 *
+	 * @param rate update rate in Hz
+	 * @param repeat true to repeat last table while no next table is queued
+	 * @return false if UTICK is used by other Ticker (or wait_flag()). Playback is not started
+	 */
+	bool		start( float rate, bool repeat = false );
+
+	/** Stop playback and clear queue. Output keeps last value */
+	void		stop( void );
+
+	/** Number of tables can be queued */
+	int			space( void );
+
+	/** true while a table is played */
+	bool		playing( void );
+
+	/** Number of updates done */
+	uint32_t	update_count( void );
+
+	/** Number of ticks with no table to play */
+	uint32_t	underrun_count( void );
+
+	/** Number of updates skipped because SPI was busy */
+	uint32_t	late_count( void );
+
+private:
+	typedef struct	_table	{
+		const int32_t	*codes;
+		int				length;
+	} table_t;
+
+	static constexpr int	depth	= 2;
+
+	void		tick( void );
+
+	NAFE33352_Base&		afe;
+	Ticker				ticker;
+	table_t				queue_storage[ depth + 1 ];
+	RingBuffer<table_t>	tables;
+	int					position;
+	bool				loop;
+	bool				running;
+	volatile uint32_t	updates;
+	volatile uint32_t	underruns;
+	volatile uint32_t	lates;
+};
+
+#endif //	ARDUINO_AFE_DAC_PLAYBACK_H
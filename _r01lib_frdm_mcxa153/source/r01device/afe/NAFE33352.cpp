@@ -36,6 +36,11 @@ void NAFE33352_Base::LogicalChannel::configure( uint16_t cc0, uint16_t cc1, uint
 	afe_ptr->open_logical_channel( ch_number, tmp_ch_config );
 }
 
+void NAFE33352_Base::LogicalChannel::configure( const channel_setting &s )
+{
+	afe_ptr->open_logical_channel( ch_number, s );
+}
+
 NAFE33352_Base::DAC::DAC()
 {
 }
@@ -103,12 +108,42 @@ NAFE33352_Base::DAC& NAFE33352_Base::DAC::operator=( double value )
 	return	*this;
 }
 
+void NAFE33352_Base::DAC::waveform( double high, double low, uint16_t awg_per )
+{
+	afe_ptr->batch_begin();
+	afe_ptr->reg( AWG_AMP_MAX, afe_ptr->dac_code( high, full_scale, 18 ) );
+	afe_ptr->reg( AWG_AMP_MIN, afe_ptr->dac_code( low,  full_scale, 18 ) );
+	afe_ptr->reg( AWG_PER, awg_per );
+	afe_ptr->batch_end();
+}
+
+void NAFE33352_Base::DAC::waveform_start( void )
+{
+	afe_ptr->command( CMD_WGEN_START );
+}
+
+void NAFE33352_Base::DAC::waveform_stop( void )
+{
+	afe_ptr->command( CMD_WGEN_STOP );
+}
+
+void NAFE33352_Base::DAC::codes( const double *values, int32_t *codes, int length )
+{
+	for ( auto i = 0; i < length; i++ )
+		codes[ i ]	= afe_ptr->dac_code( values[ i ], full_scale, 18 );
+}
+
+double NAFE33352_Base::DAC::full_scale_range( void )
+{
+	return full_scale;
+}
+
 
 
 /* NAFE33352_Base class ******************************************/
 
 NAFE33352_Base::NAFE33352_Base( SPI& spi, bool spi_addr, bool hsv, int nINT, int DRDY, int SYN, int nRESET, int SYNCDAC )
-	: AFE_base( spi, spi_addr, hsv, nINT, DRDY, SYN, nRESET, SYNCDAC )
+	: AFE_base( spi, spi_addr, hsv, nINT, DRDY, SYN, nRESET, SYNCDAC ), dac_frame_busy( false ), alarm_state( 0 )
 {
 	for ( auto i = 0; i < 16; i++ )
 	{
@@ -131,11 +166,14 @@ void NAFE33352_Base::boot( void )
 	
 	DRDY_by_sequencer_done( true );
 	
+	batch_begin();
+
 	reg( SYS_CONFIG,        0x0000 );
 	reg( CK_SRC_SEL_CONFIG, 0x0000 );
 
 	reg( AI_SYSCFG,         0x0800 );
 
+	batch_end();
 
 }
 
@@ -147,6 +185,7 @@ void NAFE33352_Base::reset( bool hardware_reset )
 		pin_nRESET	= 0;
 		wait( 0.001 );
 		pin_nRESET	= 1;
+		register_cache_resync();
 	}
 	else
 	{
@@ -168,87 +207,40 @@ void NAFE33352_Base::reset( bool hardware_reset )
 
 void NAFE33352_Base::open_dac_output( const uint16_t (&cc)[ 6 ] )
 {
+	batch_begin();
+
 	for ( auto i = 0; i < 6; i++ )
 		reg( AIO_CONFIG + i, cc[ i ] );
+
+	batch_end();
 }
 
 
 void NAFE33352_Base::open_logical_channel( int ch, const uint16_t (&cc)[ 4 ] )
+{	
+	open_logical_channel( ch, make_setting( cc ) );
+}
+
+void NAFE33352_Base::open_logical_channel( int ch, const channel_setting &s )
 {	
 	static bool			pga_enabled	= false;
-	constexpr double	pow2_24		= (double)(1 << 24);
-	double				coeff		= 0.00;
-	bool				pga_on		= false;
-	
-	mux_setting[ ch ]	= (cc[ 0 ] >> 3) & 0x1F;
 	
+	batch_begin();
 	command( CMD_CH0 + ch );
 
-	switch ( mux_setting[ ch ] )
-	{
-		case 0:
-		case 3:
-			coeff	= (20.00 * 2.50) / (12.5 * pow2_24);
-			break;
-		case 1:
-			coeff	= (20.00 * 2.50) / ((cc[ 0 ] & 0x0100 ? 16.00 : 1.00) * pow2_24);
-			pga_on	= true;
-			break;
-		case 2:
-		case 7:
-			coeff	= (20.00 * 2.50) / pow2_24;
-			pga_on	= true;
-			break;
-		case 4:
-			coeff	= (20.00 * 2.50) / ((cc[ 0 ] & 0x0200 ? 16.00 : 1.00) * pow2_24);
-			pga_on	= true;
-			break;
-		case 5:
-			coeff	= (20.00 * 2.50) / ((cc[ 0 ] & 0x0100 ? 16.00 : 1.00) * pow2_24);
-			pga_on	= true;
-			break;
-		case 6:
-			coeff	= (20.00 * 2.50) / (3.7989 * pow2_24);
-			break;
-		case 8:
-			coeff	= (20.00 * 2.50) / (2.50 * pow2_24);
-			break;
-		case 9:
-		case 10:
-		case 11:
-		case 15:
-		case 18:
-			coeff	= (20.00 * 2.50) / (12.5 * pow2_24) + 1.50;
-			break;
-		case 12:
-			coeff	= (20.00 * 2.50) / (12.5 * pow2_24) - 1.50;
-			break;
-		case 13:
-			//coeff	= (20.00 * 2.50) / (12.5 * pow2_24) - 1.50;
-			break;
-		case 14:
-			coeff	= (2.00 * 20.00 * 2.50) / (12.5 * pow2_24) - 1.50;
-			break;
-		case 16:
-		case 17:
-			coeff	= (40.00 * 20.00 * 2.50) / (12.5 * pow2_24);
-			break;
-	}
-	
-	coeff_uV[ ch ]		= coeff;
-	
-	if ( pga_on && !pga_enabled )
+	if ( s.pga_on && !pga_enabled )
 	{
 		reg( AI_SYSCFG, 0x0800 );
 		pga_enabled	= true;
 	}
 	
 	for ( auto i = 0; i < 3; i++ )
-		reg( AI_CONFIG0 + i, cc[ i ] );
+		reg( AI_CONFIG0 + i, s.cc[ i ] );
 	
+	batch_end();
+
+	apply_setting( ch, s );
 	enable_logical_channel( ch );
-	
-	ch_delay[ ch ]		= calc_delay( ch );
 }
 
 void NAFE33352_Base::channel_info_update( uint16_t value )
@@ -276,58 +268,6 @@ void NAFE33352_Base::channel_info_update( uint16_t value )
 #endif
 }
 
-double NAFE33352_Base::calc_delay( int ch )
-{
-	constexpr static double	data_rates[]	= {	   288000, 192000, 144000, 96000, 72000, 48000, 36000, 24000, 
-													18000,  12000,   9000,  6000,  4500,  3000,  2250,  1125, 
-													 562.5,    400,    300,   200,   100,    60,    50,    30, 
-														25,     20,     15,    10,   7.5, 						};
-	constexpr static uint16_t	delays[]	= {		0,   2,   4,   6,   8,  10,   12,  14, 
-												   16,  18,  20,  28,  38,  40,   42,  56, 
-												   64,  76,  90, 128, 154, 178, 204, 224, 
-												  256, 358, 512, 716, 
-												  1024, 1664, 3276, 7680, 19200, 23040, };
-	
-	command( CMD_CH0 + ch );
-
-	uint16_t ch_config1	= reg( AI_CONFIG1 );
-	uint16_t ch_config2	= reg( AI_CONFIG2 );
-	
-	uint8_t		adc_data_rate		= (ch_config1 >>  3) & 0x001F;
-	uint8_t		adc_sinc			= (ch_config1 >>  0) & 0x0007;
-	uint8_t		ch_delay			= (ch_config2 >> 10) & 0x003F;
-	bool		adc_normal_setting	= (ch_config2 >>  9) & 0x0001;
-	bool		ch_chop				= (ch_config2 >>  7) & 0x0001;
-	
-	double		base_freq			= data_rates[ adc_data_rate ];
-	double		delay_setting		= delays[ ch_delay ] / 4608000.00;
-	
-	if ( highspeed_variant )
-	{
-		base_freq		*= 2.00;
-		delay_setting	/= 2.00;		
-	}
-	
-	if ( (28 < adc_data_rate) || (4 < adc_sinc) || ((adc_data_rate < 12) && (adc_sinc)) )
-		return 0.00;
-	
-	if ( !adc_normal_setting )
-		base_freq	/= (adc_sinc + 1);
-	
-	if ( ch_chop )
-		base_freq	/= 2;
-	
-#if  0
-	printf( "adc_data_rate = %d\r\n", adc_data_rate );
-	printf( "base_freq = %lf\r\n", base_freq );
-	printf( "delay_setting = %lf\r\n", delay_setting  );
-	printf( "channel delay = %lf\r\n", (1 / base_freq) + delay_setting  );
-#endif
-	
-	return (1 / base_freq) + delay_setting;
-}
-
-
 void NAFE33352_Base::open_logical_channel( int ch, uint16_t cc0, uint16_t cc1, uint16_t cc2, uint16_t dummy )
 {	
 	const ch_setting_t	tmp_ch_config	= { cc0, cc1, cc2 };
@@ -350,6 +290,14 @@ void NAFE33352_Base::close_logical_channel( int ch )
 	channel_info_update( bits >> 8 );
 }
 
+void NAFE33352_Base::select_logical_channels( uint16_t bits )
+{	
+	bits	&= 0x00FF;
+
+	reg( AI_MULTI_CH_EN, bits << 8 );
+	channel_info_update( bits );
+}
+
 void NAFE33352_Base::close_logical_channel( void )
 {	
 	reg( AI_MULTI_CH_EN, 0x0000 );
@@ -372,6 +320,11 @@ void NAFE33352_Base::start_continuous_conversion( void )
 	command( CMD_MC );
 }
 
+void NAFE33352_Base::stop_continuous_conversion( void )
+{
+	command( CMD_ADC_ABORT );
+}
+
 void NAFE33352_Base::DRDY_by_sequencer_done( bool flag )
 {
 	bit_op( AI_SYSCFG, ~0x0100, flag ? 0x0100 : 0x0000 );	
@@ -415,6 +368,16 @@ void NAFE33352_Base::read( std::vector<volt_t>& data_vctr )
 		data_vctr[ i ]	= raw2uv( sequence_order[ i ], raw_data[ i ] );
 }
 
+void NAFE33352_Base::read( nvolt_t *data )
+{
+	raw_t	raw_data[ 16 ];
+	
+	read( raw_data );
+	
+	for ( auto i = 0; i < enabled_channels; i++ )
+		data[ i ]	= raw2nv( sequence_order[ i ], raw_data[ i ] );
+}
+
 void NAFE33352_Base::dac_out( double vi, double full_scale, uint8_t bit_length )
 {
 	reg( AO_DATA, dac_code( vi, full_scale, bit_length ) );
@@ -432,29 +395,274 @@ int32_t NAFE33352_Base::dac_code( double a, double full_scale, uint8_t bit_lengt
 	return	v << (24 - bit_length);
 }
 
+status_t NAFE33352_Base::dac_write_nonblocking( int32_t code )
+{
+	uint16_t	r	= static_cast<uint16_t>( AO_DATA ) << 1;
+
+	if ( dac_frame_busy )	//	frame buffer is in use until the transfer completes
+		return kStatus_Busy;
+
+	dac_frame_busy	= true;
+
+	dac_frame[ 0 ]	= (uint8_t)(r >> 8);
+	dac_frame[ 1 ]	= (uint8_t)(r & 0xFF);
+	dac_frame[ 2 ]	= (uint8_t)(code >> 16);
+	dac_frame[ 3 ]	= (uint8_t)(code >>  8);
+	dac_frame[ 4 ]	= (uint8_t)(code >>  0);
+
+	status_t	s	= txrx_nonblocking( dac_frame, sizeof( dac_frame ), [ this ]( status_t ){ dac_frame_busy = false; } );
+
+	if ( kStatus_Success != s )
+		dac_frame_busy	= false;
+
+	return s;
+}
+
 void NAFE33352_Base::command( uint16_t com )
 {
 	write_r16( com );
+
+	if ( (CMD_CH0 <= com) && (com <= CMD_CH7) )
+		shadow_page( com - CMD_CH0 );
+	else if ( (CMD_RESET == com) || (CMD_CLEAR_REG == com) || (CMD_RELOAD == com) )
+		register_cache_resync();
 }
 
 void NAFE33352_Base::reg( Register16 r, uint16_t value )
 {
 	write_r16( static_cast<uint16_t>( r ), value );
+	shadow_store( static_cast<uint16_t>( r ), value );
 }
 
 void NAFE33352_Base::reg( Register24 r, uint32_t value )
 {
 	write_r24( static_cast<uint16_t>( r ), value );
+	shadow_store( static_cast<uint16_t>( r ), value );
 }
 
 uint16_t NAFE33352_Base::reg( Register16 r )
 {
-	return read_r16( static_cast<uint16_t>( r ) );
+	uint32_t	v;
+
+	if ( shadow_load( static_cast<uint16_t>( r ), v ) )
+		return v;
+
+	v	= read_r16( static_cast<uint16_t>( r ) );
+	shadow_store( static_cast<uint16_t>( r ), v );
+
+	return v;
 }
 
 uint32_t NAFE33352_Base::reg( Register24 r )
 {
-	return read_r24( static_cast<uint16_t>( r ) );
+	uint32_t	v;
+
+	if ( shadow_load( static_cast<uint16_t>( r ), v ) )
+		return v;
+
+	v	= read_r24( static_cast<uint16_t>( r ) );
+	shadow_store( static_cast<uint16_t>( r ), v );
+
+	return v;
+}
+
+uint8_t NAFE33352_Base::register_attribute( uint16_t addr )
+{
+	switch ( addr )
+	{
+		case static_cast<uint16_t>( AI_CONFIG0 ):
+		case static_cast<uint16_t>( AI_CONFIG1 ):
+		case static_cast<uint16_t>( AI_CONFIG2 ):
+			return REG_PER_CHANNEL;
+
+		case static_cast<uint16_t>( GPO_ENABLE ):
+		case static_cast<uint16_t>( GPIO_FUNCTION ):
+		case static_cast<uint16_t>( GPI_ENABLE ):
+		case static_cast<uint16_t>( GPI_EDGE_POS ):
+		case static_cast<uint16_t>( GPI_EDGE_NEG ):
+		case static_cast<uint16_t>( GPO_DATA ):
+		case static_cast<uint16_t>( SYS_CONFIG ):
+		case static_cast<uint16_t>( CK_SRC_SEL_CONFIG ):
+		case static_cast<uint16_t>( GLOBAL_ALARM_ENABLE ):
+		case static_cast<uint16_t>( TEMP_THRS ):
+		case static_cast<uint16_t>( PN2 ):
+		case static_cast<uint16_t>( PN1 ):
+		case static_cast<uint16_t>( PN0_REV ):
+		case static_cast<uint16_t>( SERIAL1 ):
+		case static_cast<uint16_t>( SERIAL0 ):
+		case static_cast<uint16_t>( AI_MULTI_CH_EN ):
+		case static_cast<uint16_t>( AI_SYSCFG ):
+		case static_cast<uint16_t>( AIO_CONFIG ):
+		case static_cast<uint16_t>( AO_CAL_COEF ):
+		case static_cast<uint16_t>( AIO_PROT_CFG ):
+		case static_cast<uint16_t>( AO_SLR_CTRL ):
+		case static_cast<uint16_t>( AWG_PER ):
+		case static_cast<uint16_t>( AO_OC_POS_LIMIT ):
+		case static_cast<uint16_t>( AO_OC_NEG_LIMIT ):
+		case static_cast<uint16_t>( AWG_AMP_MAX ):
+		case static_cast<uint16_t>( AWG_AMP_MIN ):
+			return REG_CACHEABLE;
+	}
+	
+	//	gain/offset/extra calibration coefficients and over/under range thresholds
+
+	if ( (static_cast<uint16_t>( GAIN_COEF0 ) <= addr) && (addr <= static_cast<uint16_t>( EXTRA_CAL_COEF7 )) )
+		return REG_CACHEABLE;
+
+	if ( (static_cast<uint16_t>( AI_CH_OVR_THR_0 ) <= addr) && (addr <= static_cast<uint16_t>( AI_CH_UDR_THR_7 )) )
+		return REG_CACHEABLE;
+
+	return REG_VOLATILE;
+}
+
+AFE_base::channel_setting NAFE33352_Base::make_channel_setting( const uint16_t (&cc)[ 4 ] )
+{
+	return make_setting( cc );
+}
+
+bool NAFE33352_Base::device_crc( uint16_t &config, uint16_t &coef )
+{
+	constexpr uint16_t	CHIP_READY	= 1 << 13;
+
+	if ( !(reg( SYS_STATUS ) & CHIP_READY) )
+		return false;
+
+	command( CMD_CALC_CRC_CONFIG );
+
+	if ( !crc_result( static_cast<uint16_t>( CRC_CONF_REGS ), config ) )
+		return false;
+
+	command( CMD_CALC_CRC_COEF );
+
+	return crc_result( static_cast<uint16_t>( CRC_COEF_REGS ), coef );
+}
+
+int NAFE33352_Base::config_registers( uint16_t *addr )
+{
+	constexpr Register16	list[]	= { AI_SYSCFG, GLOBAL_ALARM_ENABLE, AIO_CONFIG, AO_CAL_COEF, AIO_PROT_CFG, AO_SLR_CTRL, AWG_PER, AO_SYSCFG };
+
+	for ( auto r : list )
+		*addr++	= static_cast<uint16_t>( r );
+
+	return sizeof( list ) / sizeof( list[ 0 ] );
+}
+
+int NAFE33352_Base::coefficient_registers( uint16_t *addr )
+{
+	for ( auto i = 0; i < 8; i++ )
+	{
+		addr[ i      ]	= static_cast<uint16_t>( GAIN_COEF0      ) + i;
+		addr[ i +  8 ]	= static_cast<uint16_t>( OFFSET_COEF0    ) + i;
+		addr[ i + 16 ]	= static_cast<uint16_t>( EXTRA_CAL_COEF0 ) + i;
+	}
+
+	return 24;
+}
+
+bool NAFE33352_Base::hardware_threshold( int ch, bool enable, raw_t over, raw_t under )
+{
+	if ( 8 <= ch )
+		return false;
+
+	//	disabled threshold is set to full-scale, so it never makes alarm
+
+	reg( AI_CH_OVR_THR_0 + ch, (uint32_t)(enable ? over  :  0x7FFFFF) & 0xFFFFFF );
+	reg( AI_CH_UDR_THR_0 + ch, (uint32_t)(enable ? under : -0x800000) & 0xFFFFFF );
+
+	return true;
+}
+
+void NAFE33352_Base::alarm_enable( uint16_t bits )
+{
+	reg( GLOBAL_ALARM_ENABLE, bits );
+	command( CMD_CLEAR_ALARM );
+}
+
+void NAFE33352_Base::alarm_service( void )
+{
+	//	sequence of non-blocking transfers, driven by transfer-done callbacks:
+	//	AI_STATUS_OVR --> AI_STATUS_UDR --> AI_DATAn for each flagged channel --> CMD_CLEAR_ALARM
+
+	uint32_t	mask	= DisableGlobalIRQ();
+
+	if ( alarm_state )	//	already in progress
+	{
+		EnableGlobalIRQ( mask );
+		return;
+	}
+
+	alarm_state	= 1;
+	EnableGlobalIRQ( mask );
+
+	alarm_time	= __get_IPSR() ? nint_timestamp : us_ticker_read();
+	alarm_transfer( static_cast<uint16_t>( AI_STATUS_OVR ), 2, true );
+}
+
+void NAFE33352_Base::alarm_step( void )
+{
+	uint8_t	*data	= alarm_frame + command_length;
+
+	switch ( alarm_state )
+	{
+		case 1:
+			alarm_ovr	= get_data16( data );
+			alarm_state	= 2;
+			alarm_transfer( static_cast<uint16_t>( AI_STATUS_UDR ), 2, true );
+			return;
+
+		case 2:
+			alarm_udr		= get_data16( data );
+			alarm_remain	= ((alarm_ovr | alarm_udr) & status_ch_mask) >> status_ch_shift;
+			alarm_state		= 3;
+			break;
+
+		case 3:
+		{
+			uint16_t	bit		= 1 << (status_ch_shift + alarm_channel);
+			raw_t		value	= get_data24( data );
+
+			if ( alarm_ovr & bit )
+				post_alarm( alarm_time, alarm_channel, ALARM_OVER, value );
+
+			if ( alarm_udr & bit )
+				post_alarm( alarm_time, alarm_channel, ALARM_UNDER, value );
+
+			alarm_remain	&= ~(1 << alarm_channel);
+			break;
+		}
+
+		default:	//	CMD_CLEAR_ALARM done
+			alarm_pending	= false;
+			alarm_state		= 0;
+			return;
+	}
+
+	if ( alarm_remain )
+	{
+		alarm_channel	= __builtin_ctz( alarm_remain );
+		alarm_transfer( static_cast<uint16_t>( AI_DATA0 ) + alarm_channel, 3, true );
+		return;
+	}
+
+	alarm_state	= 4;
+	alarm_transfer( CMD_CLEAR_ALARM, 0, false );
+}
+
+void NAFE33352_Base::alarm_transfer( uint16_t reg, int length, bool read )
+{
+	reg	<<= 1;
+	reg	 |= read ? 0x4000 : 0x0000;
+
+	alarm_frame[ 0 ]	= (uint8_t)(reg >> 8);
+	alarm_frame[ 1 ]	= (uint8_t)(reg & 0xFF);
+
+	if ( kStatus_Success != txrx_nonblocking( alarm_frame, command_length + length, [ this ]( status_t ){ alarm_step(); } ) )
+	{
+		//	SPI busy in interrupt: service is retried from alarm_events_available() or read_alarm_events()
+
+		alarm_missed++;
+		alarm_state	= 0;
+	}
 }
 
 uint64_t NAFE33352_Base::part_number( void )
@@ -45,6 +45,146 @@ public:
 	 */
 	virtual void open_logical_channel( int ch, const uint16_t (&cc)[ 4 ] );
 
+	/** Configure logical channel with precomputed setting
+	 *
+	 * @param ch logical channel number (0 ~ 15)
+	 * @param s setting made by ChannelConfig
+	 */
+	virtual void open_logical_channel( int ch, const channel_setting &s );
+
+	/** Make channel setting from register values
+	 *
+	 *	No validation: invalid data rate setting gives 0.00 delay
+	 *
+	 * @param cc array for AI_CONFIG0, AI_CONFIG1 and AI_CONFIG2 values
+	 */
+	constexpr static channel_setting make_setting( const uint16_t (&cc)[ 4 ] )
+	{
+		constexpr double	nv		= 1e9;
+		constexpr double	pow2_24	= (double)(1 << 24);
+		channel_setting		s		= {};
+
+		for ( auto i = 0; i < 3; i++ )
+			s.cc[ i ]	= cc[ i ];
+
+		s.mux	= (cc[ 0 ] >> 3) & 0x1F;
+
+		switch ( s.mux )
+		{
+			case 0:
+			case 3:
+				s.coeff_uV	= (20.00 * 2.50) / (12.5 * pow2_24);
+				break;
+			case 1:
+			case 5:
+				s.coeff_uV	= (20.00 * 2.50) / ((cc[ 0 ] & 0x0100 ? 16.00 : 1.00) * pow2_24);
+				s.pga_on	= true;
+				break;
+			case 2:
+			case 7:
+				s.coeff_uV	= (20.00 * 2.50) / pow2_24;
+				s.pga_on	= true;
+				break;
+			case 4:
+				s.coeff_uV	= (20.00 * 2.50) / ((cc[ 0 ] & 0x0200 ? 16.00 : 1.00) * pow2_24);
+				s.pga_on	= true;
+				break;
+			case 6:
+				s.coeff_uV	= (20.00 * 2.50) / (3.7989 * pow2_24);
+				break;
+			case 8:
+				s.coeff_uV	= (20.00 * 2.50) / (2.50 * pow2_24);
+				break;
+			case 9:
+			case 10:
+			case 11:
+			case 15:
+			case 18:
+				s.coeff_uV	= (20.00 * 2.50) / (12.5 * pow2_24) + 1.50;
+				break;
+			case 12:
+				s.coeff_uV	= (20.00 * 2.50) / (12.5 * pow2_24) - 1.50;
+				break;
+			case 14:
+				s.coeff_uV	= (2.00 * 20.00 * 2.50) / (12.5 * pow2_24) - 1.50;
+				break;
+			case 16:
+			case 17:
+				s.coeff_uV	= (40.00 * 20.00 * 2.50) / (12.5 * pow2_24);
+				break;
+		}
+
+		s.delay	= conversion_time( cc[ 1 ], cc[ 2 ] );
+
+		if ( 13 == s.mux )	//	raw2v() has offset for this input
+			fixed_coeff( nv, -((20.00 * 2.50) / 12.50 + 1.50) * nv, s.nv_scale, s.nv_offset, s.nv_shift );
+		else
+			fixed_coeff( s.coeff_uV * nv, 0.00, s.nv_scale, s.nv_offset, s.nv_shift );
+
+		return s;
+	}
+
+	/** Typed logical channel configuration
+	 *
+	 *	Register values, conversion coefficient and delay are made at compile time.
+	 *
+	 *  Example:
+	 *  @code
+	 *  constexpr auto	ch0	= NAFE33352_Base::ChannelConfig()
+	 *  							.input( 4 )
+	 *  							.data_rate( 22 )
+	 *  							.sinc( 4 )
+	 *  							.delay( 20 )
+	 *  							.setting();
+	 *
+	 *  afe.logical_channel[ 0 ].configure( ch0 );
+	 *  @endcode
+	 */
+	class ChannelConfig : public ChannelConfig_Base<ChannelConfig>
+	{
+	public:
+		constexpr ChannelConfig() : ChannelConfig_Base( 0x0000, 0x0000, 0x0000, 0x0000 ) {}
+
+		/** Start from register values */
+		constexpr explicit ChannelConfig( uint16_t cc0, uint16_t cc1 = 0x0000, uint16_t cc2 = 0x0000 )
+			: ChannelConfig_Base( cc0, cc1, cc2, 0x0000 ) {}
+
+		/** Input multiplexer (0 ~ 18) */
+		consteval ChannelConfig	input( uint8_t mux ) const
+		{
+			if ( (18 < mux) || (13 == mux) )
+				channel_config_error( "input selection not supported" );
+
+			return field( 0, 3, 0x1F, mux );
+		}
+
+		/** x16 PGA gain. Available for input 1, 4 and 5 */
+		consteval ChannelConfig	gain16( bool on = true ) const
+		{
+			uint8_t	mux	= (cc[ 0 ] >> 3) & 0x1F;
+
+			if ( (1 == mux) || (5 == mux) )
+				return field( 0, 8, 0x1, on );
+
+			if ( 4 == mux )
+				return field( 0, 9, 0x1, on );
+
+			channel_config_error( "x16 gain is not available for the input. Set input first" );
+			return *this;
+		}
+
+		consteval channel_setting	setting( void ) const
+		{
+			validate();
+			return make_setting( cc );
+		}
+
+		consteval operator channel_setting() const
+		{
+			return setting();
+		}
+	};
+
 	class LogicalChannel : public LogicalChannel_Base
 	{
 	public:
@@ -53,6 +193,7 @@ public:
 		
 		void	configure( const uint16_t (&cc)[ 3 ] );
 		void	configure( uint16_t cc0, uint16_t cc1 = 0x0000, uint16_t cc2 = 0x0000 );
+		void	configure( const channel_setting &s );
 	};
 	
 	LogicalChannel	logical_channel[ 16 ];
@@ -76,6 +217,33 @@ public:
 		void 	configure( double full_scale_range );
 		void	output( double value );
 		DAC&	operator=( double value );
+
+		/** Set on-chip arbitrary waveform generator (AWG)
+		 *
+		 *	Output swings between "high" and "low". Levels are converted with output mode and full-scale range set by configure()
+		 *
+		 * @param high level for AWG_AMP_MAX (V or A)
+		 * @param low level for AWG_AMP_MIN (V or A)
+		 * @param awg_per AWG_PER register value
+		 */
+		void	waveform( double high, double low, uint16_t awg_per );
+
+		/** Start AWG (CMD_WGEN_START) */
+		void	waveform_start( void );
+
+		/** Stop AWG (CMD_WGEN_STOP) */
+		void	waveform_stop( void );
+
+		/** Convert output values into AO_DATA codes, for DACPlayback table
+		 *
+		 * @param values array of output values (V or A)
+		 * @param codes array to store codes
+		 * @param length number of values
+		 */
+		void	codes( const double *values, int32_t *codes, int length );
+
+		/** Full-scale range set by configure() (V or A) */
+		double	full_scale_range( void );
 		
 		NAFE33352_Base	*afe_ptr;
 	private:
@@ -86,7 +254,6 @@ public:
 	DAC	dac;
 	
 private:	
-	double 	calc_delay( int ch );
 	void 	channel_info_update( uint16_t value );
 	
 public:
@@ -109,6 +276,15 @@ public:
 	 */
 	void	enable_logical_channel( int ch );
 
+	/** Logical channels enable by bitmap. Channels not in the bitmap are disabled
+	 *
+	 * @param bits bit n for logical channel n (0 ~ 7)
+	 */
+	void	select_logical_channels( uint16_t bits );
+
+	/** Number of logical channels the device has */
+	virtual int logical_channels( void )	{ return 8; }
+
 	/** Start ADC
 	 *
 	 * @param ch logical channel number (0 ~ 15)
@@ -123,6 +299,10 @@ public:
 	 */
 	virtual void start_continuous_conversion();
 
+	/** Stop continuous AD conversion
+	 */
+	virtual void stop_continuous_conversion();
+
 	/** DRDY event select
 	 *
 	 * @param set true for DRDY by sequencer is done
@@ -159,6 +339,12 @@ public:
 	 */
 	virtual void	read( std::vector<volt_t>& data_vctr );
 
+	/** Read ADC for all channel in nano-volt (fixed-point conversion)
+	 *
+	 * @param data_ptr pointer to array to store ADC data
+	 */
+	virtual void	read( nvolt_t *data );
+
 	inline double raw2v( int ch, raw_t value )
 	{
 		if ( mux_setting[ ch ] == 13 )
@@ -174,6 +360,13 @@ public:
 	virtual void	dac_out( double vi, double full_scale, uint8_t bit_length );
 	int32_t			dac_code( double a, double full_scale, uint8_t bit_length );
 
+	/** Write AO_DATA without waiting for transfer. Can be called in interrupt context
+	 *
+	 * @param code AO_DATA value made by dac_code()
+	 * @return kStatus_Success, or kStatus_Busy if previous write or SPI is busy
+	 */
+	status_t		dac_write_nonblocking( int32_t code );
+
 	constexpr static double	pga_gain[]	= { 1.00, 16.00 };
 
 	enum GainPGA : uint8_t {
@@ -360,10 +553,24 @@ public:
 	 * @return readout value
 	 */
 	virtual uint32_t	reg( Register24 r );
-	
+
+protected:
+	virtual uint8_t		register_attribute( uint16_t addr );
+
+	virtual channel_setting	make_channel_setting( const uint16_t (&cc)[ 4 ] );
+	virtual bool		device_crc( uint16_t &config, uint16_t &coef );
+	virtual int			config_registers( uint16_t *addr );
+	virtual int			coefficient_registers( uint16_t *addr );
+
+	/** Device threshold slots: AI_CH_OVR_THR_n/AI_CH_UDR_THR_n for logical channel 0 ~ 7 */
+	virtual bool		hardware_threshold( int ch, bool enable, raw_t over, raw_t under );
+	virtual void		alarm_enable( uint16_t bits );
+	virtual void		alarm_service( void );
+
+public:
 	/** Register bit operation
 	 *
-	 *	overwrite bits i a register
+	 *	overwrite bits i a register. Cached register is not read back from the device
 	 * @param reg register specified by Register16 or Register24 member
 	 * @param mask mask bits
 	 * @param reg value to over write
@@ -404,6 +611,25 @@ public:
 	 * @return die temperature in celsius
 	 */
 	float	temperature( void );
+
+private:
+	uint8_t			dac_frame[ command_length + 3 ];
+	volatile bool	dac_frame_busy;
+
+	void			alarm_step( void );
+	void			alarm_transfer( uint16_t reg, int length, bool read );
+
+	/** Channel flags in AI_STATUS_OVR/AI_STATUS_UDR: bit (8 + n) for logical channel n. Lower byte is not channel flag */
+	static constexpr int		status_ch_shift	= 8;
+	static constexpr uint16_t	status_ch_mask	= 0xFF00;
+
+	uint8_t			alarm_frame[ command_length + 3 ];
+	volatile int	alarm_state;
+	uint16_t		alarm_ovr;
+	uint16_t		alarm_udr;
+	uint8_t			alarm_remain;
+	int				alarm_channel;
+	uint32_t		alarm_time;
 };
 
 class NAFE33352 : public NAFE33352_Base
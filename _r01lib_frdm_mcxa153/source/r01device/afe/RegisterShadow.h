@@ -0,0 +1,103 @@
+/** NXP Analog Front End class library for MCX
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2026 Tedd OKANO
+ *  Released under the MIT license
+ */
+
+#ifndef ARDUINO_REGISTER_SHADOW_H
+#define ARDUINO_REGISTER_SHADOW_H
+
+#include	<stdint.h>
+
+/** RegisterShadow class
+ *
+ *  @class RegisterShadow
+ *
+ *	RAM copy of device registers, keyed by register address and logical channel page.
+ *	Open addressing hash table with fixed capacity. When the table is full, new registers are not cached
+ */
+
+template<int N>
+class RegisterShadow
+{
+public:
+	/** Page number for registers which are not in logical channel page */
+	static constexpr uint8_t	global_page	= 0xFF;
+
+	RegisterShadow() { clear(); }
+	virtual ~RegisterShadow() {}
+
+	/** Drop all cached values */
+	void	clear( void )
+	{
+		for ( auto i = 0; i < N; i++ )
+			table[ i ].key	= empty;
+	}
+
+	/** Get cached value
+	 *
+	 * @param addr register address
+	 * @param page logical channel page
+	 * @param value reference to store the value
+	 * @return true if cached
+	 */
+	bool	load( uint16_t addr, uint8_t page, uint32_t &value )
+	{
+		int	i	= find( key( addr, page ) );
+
+		if ( (i < 0) || (empty == table[ i ].key) )
+			return false;
+
+		value	= table[ i ].value;
+		return true;
+	}
+
+	/** Store value
+	 *
+	 * @param addr register address
+	 * @param page logical channel page
+	 * @param value register value
+	 */
+	void	store( uint16_t addr, uint8_t page, uint32_t value )
+	{
+		uint32_t	k	= key( addr, page );
+		int			i	= find( k );
+
+		if ( i < 0 )
+			return;
+
+		table[ i ].key		= k;
+		table[ i ].value	= value;
+	}
+
+private:
+	static constexpr uint32_t	empty	= 0xFFFFFFFF;
+
+	static inline uint32_t	key( uint16_t addr, uint8_t page )
+	{
+		return ((uint32_t)page << 16) | addr;
+	}
+
+	//	returns index of the key or first empty slot in probe sequence. -1 if table is full
+	int		find( uint32_t k )
+	{
+		int	i	= (int)((k * 2654435761U) >> 16) % N;
+
+		for ( auto n = 0; n < N; n++, i = (i + 1) % N )
+		{
+			if ( (k == table[ i ].key) || (empty == table[ i ].key) )
+				return i;
+		}
+
+		return -1;
+	}
+
+	struct	{
+		uint32_t	key;
+		uint32_t	value;
+	}	table[ N ];
+};
+
+#endif //	ARDUINO_REGISTER_SHADOW_H
@@ -9,7 +9,8 @@
 #include "AFE_NXP.h"
 #include <bit>
 
-SPI_for_AFE::SPI_for_AFE( SPI& spi, bool spi_addr ) : _spi( spi ), dev_ad( spi_addr )
+SPI_for_AFE::SPI_for_AFE( SPI& spi, bool spi_addr ) : last_status( kStatus_Success ), _spi( spi ), dev_ad( spi_addr ), 
+	batch_recording( false ), batch_sending( false ), batch_length( 0 ), batch_frames( 0 ), batch_index( 0 ), batch_ptr( nullptr )
 {
 }
 
@@ -19,14 +20,39 @@ SPI_for_AFE::~SPI_for_AFE()
 
 void SPI_for_AFE::txrx( uint8_t *data, int size )
 {
-	static constexpr int	READ_BUFFER_SIZE	= command_length + 16 * 3; //	(2[command] + 16[logical_channels] * 3[bytes])
+	data[ 0 ]	|= dev_ad ? 0x80 : 0x00;
 
-	uint8_t	r_data[ READ_BUFFER_SIZE ];
+	if ( batch_recording )
+	{
+		if ( (command_length == size) || !(data[ 0 ] & 0x40) )	//	command or register write frame
+		{
+			batch_record( data, size );
+			return;
+		}
+		
+		batch_flush( true );		//	read needs preceding frames done
+	}
 	
+	while ( batch_sending )
+		;
+
+	_spi.write( data, data, size );	//	receive in place: RX always follows TX in the buffer
+}
+
+status_t SPI_for_AFE::txrx_nonblocking( uint8_t *data, int size, spi_callback_fp_t callback )
+{
 	data[ 0 ]	|= dev_ad ? 0x80 : 0x00;
-	
-	_spi.write( data, r_data, size );
-	memcpy( data, r_data, size );
+
+	if ( __get_IPSR() && (batch_recording || batch_sending) )	//	batch cannot proceed while in interrupt
+		return kStatus_Busy;
+
+	if ( batch_recording )
+		batch_flush( true );
+
+	while ( batch_sending )
+		;
+
+	return _spi.write_nonblocking( data, data, size, callback );
 }
 
 void SPI_for_AFE::write_r16( uint16_t reg )
@@ -90,15 +116,146 @@ void SPI_for_AFE::burst( uint32_t *data, int length, int width )
 	constexpr int	total_data_length	= data_byte_size * logical_chanels;
 
 	uint8_t		v[ command_length + total_data_length ];	
-	uint16_t	reg	  = (0x2005 << 1) | 0x4000;	// CMD_BURST_DATA
-
-	v[ 0 ]	= (uint8_t)(reg >> 8);
-	v[ 1 ]	= (uint8_t)(reg & 0xFF);
 	
-	txrx( v, command_length + length * width );
+	burst_frame( v, length, width );
 	
+	if ( data_byte_size == width )
+	{
+		decode24( v + command_length, (int32_t *)data, length );
+		return;
+	}
+
 	for ( auto i = 0; i < length; i++ )
 		*data++	= get_data24( v + command_length + i * width );
 }
 
+uint8_t *SPI_for_AFE::burst_frame( uint8_t *frame, int length, int width )
+{
+	uint16_t	reg	  = (burst_command << 1) | 0x4000;
+
+	frame[ 0 ]	= (uint8_t)(reg >> 8);
+	frame[ 1 ]	= (uint8_t)(reg & 0xFF);
+	
+	txrx( frame, command_length + length * width );
+
+	return frame + command_length;
+}
+
+void SPI_for_AFE::decode24( const uint8_t *src, int32_t *dst, int length )
+{
+	//	4 samples (12 bytes) are taken by three 32 bit big-endian loads, 
+	//	then each sample is aligned to MSB and sign extended by arithmetic shift
+
+	for ( ; 4 <= length; length -= 4, src += 12, dst += 4 )
+	{
+		uint32_t	w0	= load_be32( src + 0 );
+		uint32_t	w1	= load_be32( src + 4 );
+		uint32_t	w2	= load_be32( src + 8 );
+		
+		dst[ 0 ]	= (int32_t)( w0                 ) >> 8;
+		dst[ 1 ]	= (int32_t)((w0 << 24) | (w1 >>  8)) >> 8;
+		dst[ 2 ]	= (int32_t)((w1 << 16) | (w2 >> 16)) >> 8;
+		dst[ 3 ]	= (int32_t)( w2 <<  8           ) >> 8;
+	}
+
+	for ( ; 0 < length; length--, src += 3 )
+		*dst++	= get_data24( (uint8_t *)src );
+}
+
+status_t SPI_for_AFE::burst_nonblocking( uint8_t *buffer, int length, spi_callback_fp_t callback, int width )
+{
+	uint16_t	reg	  = (burst_command << 1) | 0x4000;
+
+	buffer[ 0 ]	= (uint8_t)(reg >> 8);
+	buffer[ 1 ]	= (uint8_t)(reg & 0xFF);
+	
+	return txrx_nonblocking( buffer, command_length + length * width, callback );
+}
+
+void SPI_for_AFE::batch_begin( void )
+{
+	while ( batch_sending )
+		;
+
+	batch_length	= 0;
+	batch_frames	= 0;
+	batch_recording	= true;
+}
+
+void SPI_for_AFE::batch_end( bool wait_done )
+{
+	batch_flush( wait_done );
+	batch_recording	= false;
+}
+
+bool SPI_for_AFE::batch_busy( void )
+{
+	return batch_sending;
+}
+
+void SPI_for_AFE::batch_record( uint8_t *data, int size )
+{
+	if ( (batch_buffer_size < batch_length + size) || (batch_frames_max == batch_frames) )
+		batch_flush( true );
+	
+	memcpy( batch_buffer + batch_length, data, size );
+
+	batch_frame_size[ batch_frames++ ]	 = size;
+	batch_length						+= size;
+}
+
+void SPI_for_AFE::batch_flush( bool wait_done )
+{
+	while ( batch_sending )
+		;
 
+	if ( !batch_frames )
+		return;
+	
+	batch_index		= 0;
+	batch_ptr		= batch_buffer;
+	batch_sending	= true;
+	last_status		= kStatus_Success;
+
+	batch_send_next();
+	
+	if ( wait_done )
+		while ( batch_sending )
+			;
+}
+
+void SPI_for_AFE::batch_send_next( void )
+{
+	if ( batch_index == batch_frames )
+	{
+		batch_length	= 0;
+		batch_frames	= 0;
+		batch_sending	= false;
+		return;
+	}
+
+	int		size	= batch_frame_size[ batch_index++ ];
+	uint8_t	*p		= batch_ptr;
+	
+	batch_ptr	+= size;
+
+	//	next frame is started from completion callback (interrupt context) to minimize inter-frame gap
+	status_t	status	= _spi.write_nonblocking( p, p, size, [ this ]( status_t ){ batch_send_next(); } );
+
+	if ( kStatus_Success == status )
+		return;
+
+	//	start failed: bus taken by higher priority interrupt, or queue of shared bus (SPIBus) is full.
+	//	In thread context, the frame can be sent by blocking transfer. In interrupt context, batch is aborted
+
+	if ( !__get_IPSR() && (kStatus_Success == (status = _spi.write( p, p, size ))) )
+	{
+		batch_send_next();
+		return;
+	}
+
+	last_status		= status;
+	batch_length	= 0;
+	batch_frames	= 0;
+	batch_sending	= false;
+}
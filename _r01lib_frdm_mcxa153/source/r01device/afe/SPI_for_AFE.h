@@ -25,6 +25,17 @@ public:
 	 */
 	void txrx( uint8_t *data, int size );
 
+	/** Send data without blocking
+	 *
+	 *	Read data is written back into the same buffer. The buffer must be kept until the callback is called
+	 * 
+	 * @param data pointer to data buffer
+	 * @param size data size
+	 * @param callback function called when the transfer completes
+	 * @return kStatus_Success if started. kStatus_Busy if called from interrupt while bus is in use
+	 */
+	status_t txrx_nonblocking( uint8_t *data, int size, spi_callback_fp_t callback = nullptr );
+
 	/** Register write, 8 bit
 	 *
 	 * @param reg register index
@@ -61,15 +72,74 @@ public:
 	
 	void burst( uint32_t *data, int length, int width = 3 );
 
-private:
+	/** Burst read into caller's frame buffer
+	 *
+	 *	Read data is received in the frame buffer directly, without copying.
+	 *
+	 * @param frame pointer to frame buffer. It needs (2 + length * width) bytes
+	 * @param length number of channels
+	 * @param width data width in bytes
+	 * @return pointer to the first data in frame buffer
+	 */
+	uint8_t *burst_frame( uint8_t *frame, int length, int width = 3 );
+
+	/** Decode 24 bit big-endian data into sign extended 32 bit values
+	 *
+	 * @param src pointer to 24 bit data
+	 * @param dst pointer to array to store decoded values
+	 * @param length number of data
+	 */
+	static void decode24( const uint8_t *src, int32_t *dst, int length );
+
+	/** Start recording command and register writes
+	 *
+	 *	After this call, commands and register writes are stored in batch buffer instead of being sent.
+	 *	Register reads flush the stored frames before reading.
+	 */
+	void batch_begin( void );
+
+	/** Send recorded frames and stop recording
+	 *
+	 *	Recorded frames are sent back-to-back by chained non-blocking transfers.
+	 *	Each frame has its own CS assertion.
+	 *
+	 * @param wait_done (option) wait all frames sent if true
+	 */
+	void batch_end( bool wait_done = true );
+
+	/** Check batch transfer status
+	 *
+	 * @return true if recorded frames are still being sent
+	 */
+	bool batch_busy( void );
+
+	/** Status of last batch transfer
+	 *
+	 *	If a frame could not be started in interrupt context, the batch is aborted:
+	 *	rest of recorded frames are discarded and this shows the error
+	 */
+	status_t	last_status;
+
+protected:
+	/** Start burst read without blocking
+	 *
+	 *	Read data is written in "buffer" after 2 bytes command field. Use get_data24() to decode
+	 *
+	 * @param buffer pointer to data buffer. It needs (2 + length * width) bytes
+	 * @param length number of channels
+	 * @param callback function called when the transfer completes
+	 * @param width data width in bytes
+	 * @return kStatus_Success if started
+	 */
+	status_t burst_nonblocking( uint8_t *buffer, int length, spi_callback_fp_t callback, int width = 3 );
 
 	//	functions to access AFE multibyte data access independent from endianess
-	inline int32_t get_data16( uint8_t *vp )
+	static inline int32_t get_data16( uint8_t *vp )
 	{
 		return ((uint16_t)(*(vp + 0)) << 8) | *(vp + 1);
 	}
 	
-	inline int32_t get_data24( uint8_t *vp )
+	static inline int32_t get_data24( uint8_t *vp )
 	{
 		int32_t	r0	= *(vp + 0);
 		int32_t	r1	= *(vp + 1);
@@ -79,9 +149,39 @@ private:
 		return r >> 8;
 	}
 
-	static constexpr int	command_length	= 2;
+	static inline uint32_t load_be32( const uint8_t *vp )
+	{
+		uint32_t	w;
+
+		memcpy( &w, vp, sizeof( w ) );		//	single unaligned load on Cortex-M33
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+		w	= __builtin_bswap32( w );		//	REV
+#endif
+		return w;
+	}
+
+	static constexpr int		command_length		= 2;
+	static constexpr uint16_t	burst_command		= 0x2005;	// CMD_BURST_DATA
+
+private:
+	void	batch_record( uint8_t *data, int size );
+	void	batch_flush( bool wait_done );
+	void	batch_send_next( void );
+
+	static constexpr int	batch_buffer_size	= 192;
+	static constexpr int	batch_frames_max	= 48;
+
 	SPI& 		_spi;
 	const bool	dev_ad;
+
+	bool			batch_recording;
+	volatile bool	batch_sending;
+	int				batch_length;
+	int				batch_frames;
+	int				batch_index;
+	uint8_t			*batch_ptr;
+	uint8_t			batch_buffer[ batch_buffer_size ];
+	uint8_t			batch_frame_size[ batch_frames_max ];
 };
 
 #endif //	ARDUINO_SPI_FOR_AFE_H
@@ -0,0 +1,92 @@
+/** NXP Analog Front End class library for MCX
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2026 Tedd OKANO
+ *  Released under the MIT license
+ */
+
+#include	"SampleStream.h"
+#include	"COBS.h"
+
+extern "C" {
+#include	"board.h"
+#include	"fsl_lpuart.h"
+}
+
+#define	STREAM_UART	((LPUART_Type *)BOARD_DEBUG_UART_BASEADDR)
+
+SampleStream::SampleStream( uint32_t baud ) : sequence( 0 ), packets( 0 ), bytes( 0 )
+{
+	if ( baud )
+		LPUART_SetBaudRate( STREAM_UART, baud, BOARD_DEBUG_UART_CLK_FREQ );
+}
+
+SampleStream::~SampleStream()
+{
+}
+
+int SampleStream::send( const AFE_base::frame_t &frame, uint16_t mask )
+{
+	return send( frame.data, mask, frame.timestamp, frame.sequence );
+}
+
+int SampleStream::send( const AFE_base::raw_t *data, uint16_t mask, uint32_t timestamp, uint32_t seq )
+{
+	uint8_t	buffer[ encoded_max ];
+	int		length	= encode( buffer, data, mask, timestamp, seq );
+
+	//	whole packet is dropped if Console is running with DROP policy and buffer is full
+
+	if ( !Console::write( buffer, length ) )
+		return 0;
+
+	packets++;
+	bytes	+= length;
+
+	return length;
+}
+
+int SampleStream::encode( uint8_t *buffer, const AFE_base::raw_t *data, uint16_t mask, uint32_t timestamp, uint32_t seq )
+{
+	uint8_t	p[ max_packet ];
+	int		n	= __builtin_popcount( mask );
+	int		i	= 0;
+
+	auto	put	= [ & ]( uint32_t v, int size )
+	{
+		while ( size-- )
+		{
+			p[ i++ ]	= v & 0xFF;
+			v		  >>= 8;
+		}
+	};
+
+	put( version,    1 );
+	put( n,          1 );
+	put( sequence++, 2 );
+	put( seq,        4 );
+	put( timestamp,  4 );
+	put( mask,       2 );
+
+	for ( auto k = 0; k < n; k++ )
+		put( (uint32_t)data[ k ], 3 );
+
+	put( crc16( p, i ), 2 );
+
+	int	length	= cobs_encode( p, i, buffer );
+
+	buffer[ length++ ]	= 0x00;
+
+	return length;
+}
+
+uint32_t SampleStream::packet_count( void )
+{
+	return packets;
+}
+
+uint32_t SampleStream::byte_count( void )
+{
+	return bytes;
+}
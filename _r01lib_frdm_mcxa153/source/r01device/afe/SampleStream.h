@@ -0,0 +1,112 @@
+/** NXP Analog Front End class library for MCX
+ *
+ *  @class   SampleStream
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2026 Tedd OKANO
+ *  Released under the MIT license
+ *
+ *  Binary sample streaming over debug LPUART.
+ *  ADC data are sent in COBS framed packets instead of formatted text by printf().
+ *  Each packet is terminated by 0x00 and carries one frame:
+ *
+ *		offset	size	content (little endian)
+ *		0		1		protocol version (1)
+ *		1		1		number of samples (n)
+ *		2		2		packet sequence number
+ *		4		4		frame sequence number (DRDY count)
+ *		8		4		timestamp in micro-second
+ *		12		2		logical channel mask (bit n: logical channel n)
+ *		14		3 * n	samples, 24 bit two's complement
+ *		14+3n	2		CRC-16/CCITT-FALSE of bytes above
+ *
+ *	Packets are written to the same LPUART as debug console through Console class.
+ *	If Console is running, packets are sent by its transmit interrupt without waiting.
+ *	Don't use printf() while streaming. The text is counted as broken packets by the host decoder.
+ *	Host side decoder is available in "tools/afe_stream" of the repository.
+ *
+ *  Example:
+ *  @code
+ *  NAFE13388_UIM	afe( spi );
+ *  SampleStream	stream( 921600 );
+ *
+ *  int main( void )
+ *  {
+ *  	afe.begin();
+ *  	afe.logical_channel[ 0 ].configure( 0x1710, 0x00A4, 0xBC00, 0x0000 );
+ *  	afe.logical_channel[ 1 ].configure( 0x2710, 0x00A4, 0xBC00, 0x0000 );
+ *
+ *  	AFE_base::frame_t	frame;
+ *
+ *  	while ( true )
+ *  	{
+ *  		afe.start_and_read( frame );
+ *  		stream.send( frame, 0x0003 );
+ *  	}
+ *  }
+ *  @endcode
+ */
+
+#ifndef ARDUINO_AFE_SAMPLE_STREAM_H
+#define ARDUINO_AFE_SAMPLE_STREAM_H
+
+#include	<stdint.h>
+#include	"r01lib.h"
+#include	"AFE_NXP.h"
+
+class SampleStream
+{
+public:
+	static constexpr uint8_t	version			= 1;
+	static constexpr int		header_length	= 14;
+	static constexpr int		max_samples		= 16;
+	static constexpr int		max_packet		= header_length + 3 * max_samples + 2;
+
+	/** Create a SampleStream instance
+	 *
+	 * @param baud LPUART baud rate. 0 to keep debug console setting
+	 */
+	SampleStream( uint32_t baud = 0 );
+	virtual ~SampleStream();
+
+	/** Send a frame
+	 *
+	 * @param frame frame from AFE_base::start_and_read() or AFE_base::read_frames()
+	 * @param mask logical channels in the frame
+	 * @return number of bytes sent
+	 */
+	int			send( const AFE_base::frame_t &frame, uint16_t mask );
+
+	/** Send samples
+	 *
+	 * @param data samples in logical channel order
+	 * @param mask logical channels of the samples. Number of samples is number of bits set
+	 * @param timestamp time in micro-second
+	 * @param seq frame sequence number
+	 * @return number of bytes sent, 0 if the packet is dropped by Console
+	 */
+	int			send( const AFE_base::raw_t *data, uint16_t mask, uint32_t timestamp, uint32_t seq );
+
+	/** Make a packet without sending
+	 *
+	 * @param buffer buffer for COBS encoded packet with delimiter. Needs encoded_max bytes
+	 * @param data, mask, timestamp, seq same as send()
+	 * @return packet length in bytes
+	 */
+	int			encode( uint8_t *buffer, const AFE_base::raw_t *data, uint16_t mask, uint32_t timestamp, uint32_t seq );
+
+	/** Number of packets sent */
+	uint32_t	packet_count( void );
+
+	/** Number of bytes sent */
+	uint32_t	byte_count( void );
+
+	static constexpr int		encoded_max		= max_packet + max_packet / 254 + 2;
+
+private:
+	uint16_t	sequence;
+	uint32_t	packets;
+	uint32_t	bytes;
+};
+
+#endif //	ARDUINO_AFE_SAMPLE_STREAM_H
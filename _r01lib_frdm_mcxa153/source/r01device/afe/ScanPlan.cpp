@@ -0,0 +1,250 @@
+/** NXP Analog Front End class library for MCX
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2026 Tedd OKANO
+ *  Released under the MIT license
+ */
+
+#include	"ScanPlan.h"
+
+ScanPlan::ScanPlan( AFE_base& afe_ ) : afe( afe_ ), count( 0 ), n_slots( 1 ), next_slot( 0 ), period( 0.00 )
+{
+	mask[ 0 ]	= 0x0000;
+}
+
+ScanPlan::~ScanPlan()
+{
+}
+
+int ScanPlan::plan( const requirement *req, int n )
+{
+	if ( (n < 1) || (afe.logical_channels() < n) )
+		return -2;
+
+	count	= n;
+
+	for ( auto i = 0; i < count; i++ )
+	{
+		choose_setting( req[ i ], cc[ i ] );
+		t_conv[ i ]		= time( cc[ i ][ 1 ], cc[ i ][ 2 ] );
+		rate_req[ i ]	= req[ i ].output_rate;
+	}
+
+	//	channel order in a cycle: channels converted in every slot first, so those stay at same position in read data
+
+	uint8_t	order[ 16 ];
+
+	for ( auto i = 0; i < count; i++ )
+		order[ i ]	= i;
+
+	std::stable_sort( order, order + count, [ this ]( uint8_t a, uint8_t b ){ return rate_req[ a ] > rate_req[ b ]; } );
+
+	for ( auto i = 0; i < count; i++ )
+		ch_assign[ order[ i ] ]	= i;
+
+	//	try super-cycle lengths and take one with largest margin against requirements
+
+	int		best_slots	= 1;
+	double	best_margin	= -1.00;
+
+	for ( auto s = 1; s <= max_slots; s *= 2 )
+	{
+		double	margin	= schedule( s );
+
+		if ( best_margin < margin )
+		{
+			best_margin	= margin;
+			best_slots	= s;
+		}
+	}
+
+	schedule( best_slots );
+
+	return (1.00 <= best_margin) ? 0 : -1;
+}
+
+double ScanPlan::schedule( int s )
+{
+	//	conversions per super-cycle are power of 2, proportional to required rate.
+	//	Channel with "per_cycle[ i ]" conversions is placed in every (s / per_cycle[ i ]) slots,
+	//	with offset to level slot length
+
+	double	rate_max	= 0.00;
+	double	load[ max_slots ]	= {};
+
+	for ( auto i = 0; i < count; i++ )
+		rate_max	= std::max( rate_max, rate_req[ i ] );
+
+	n_slots	= s;
+	period	= 0.00;
+
+	for ( auto k = 0; k < s; k++ )
+		mask[ k ]	= 0x0000;
+
+	for ( auto i = 0; i < count; i++ )
+	{
+		double	need	= (0.00 < rate_max) ? s * rate_req[ i ] / rate_max : s;
+		int		n		= 1;
+
+		while ( (n < s) && (n < need) )
+			n	*= 2;
+
+		per_cycle[ i ]	 = n;
+		period			+= n * t_conv[ i ];
+	}
+
+	for ( auto d = 1; d <= s; d *= 2 )		//	densest channels first
+	{
+		for ( auto i = 0; i < count; i++ )
+		{
+			if ( s / per_cycle[ i ] != d )
+				continue;
+
+			int		best	= 0;
+			double	best_l	= 0.00;
+
+			for ( auto o = 0; o < d; o++ )
+			{
+				double	l	= 0.00;
+
+				for ( auto k = o; k < s; k += d )
+					l	= std::max( l, load[ k ] );
+
+				if ( !o || (l < best_l) )
+				{
+					best	= o;
+					best_l	= l;
+				}
+			}
+
+			for ( auto k = best; k < s; k += d )
+			{
+				load[ k ]	+= t_conv[ i ];
+				mask[ k ]	|= 1 << ch_assign[ i ];
+			}
+		}
+	}
+
+	double	margin	= 1e300;
+
+	for ( auto i = 0; i < count; i++ )
+		if ( 0.00 < rate_req[ i ] )
+			margin	= std::min( margin, output_rate( i ) / rate_req[ i ] );
+
+	return (0.00 < period) ? margin : -1.00;
+}
+
+void ScanPlan::apply( void )
+{
+	for ( auto i = 0; i < count; i++ )
+		afe.open_logical_channel( ch_assign[ i ], cc[ i ] );
+
+	next_slot	= 0;
+	afe.select_logical_channels( mask[ 0 ] );
+}
+
+void ScanPlan::start( void )
+{
+	if ( 1 < n_slots )
+		afe.select_logical_channels( mask[ next_slot ] );
+
+	next_slot	= (next_slot + 1) % n_slots;
+
+	afe.start();
+}
+
+void ScanPlan::read( AFE_base::raw_t *data )
+{
+	afe.wait_conversion_complete( afe.cbf_DRDY ? -1.0 : afe.total_delay * AFE_base::delay_accuracy );
+	afe.read( data );
+}
+
+int ScanPlan::slot( void )
+{
+	return next_slot;
+}
+
+int ScanPlan::slots( void )
+{
+	return n_slots;
+}
+
+uint16_t ScanPlan::slot_mask( int s )
+{
+	return mask[ s % n_slots ];
+}
+
+int ScanPlan::channel( int i )
+{
+	return ch_assign[ i ];
+}
+
+const uint16_t *ScanPlan::setting( int i )
+{
+	return cc[ i ];
+}
+
+double ScanPlan::conversion_time( int i )
+{
+	return t_conv[ i ];
+}
+
+double ScanPlan::output_rate( int i )
+{
+	return (0.00 < period) ? per_cycle[ i ] / period : 0.00;
+}
+
+double ScanPlan::frame_rate( void )
+{
+	return (0.00 < period) ? n_slots / period : 0.00;
+}
+
+double ScanPlan::cycle_time( void )
+{
+	return period;
+}
+
+double ScanPlan::time( uint16_t cc1, uint16_t cc2 )
+{
+	double	t	= AFE_base::conversion_time( cc1, cc2 );
+
+	return afe.highspeed() ? t / 2.00 : t;
+}
+
+void ScanPlan::choose_setting( const requirement &r, uint16_t (&c)[ 4 ] )
+{
+	constexpr uint8_t	rate_last		= 28;
+	constexpr uint8_t	rate_sinc_first	= 12;	//	SINC filter can be used at data rate setting 12 or slower
+	constexpr uint8_t	delay_last		= 33;
+	constexpr uint16_t	normal_setting	= 0x0200;
+
+	uint8_t	sinc	= std::min( r.sinc, (uint8_t)4 );
+	uint8_t	rate	= sinc ? rate_sinc_first : 0;
+
+	//	data rate: fastest one within noise limit. Data rate table is in descending order
+
+	for ( ; rate < rate_last; rate++ )
+	{
+		double	sps	= 1.00 / time( rate << 3, normal_setting );
+
+		if ( !r.max_data_rate || (sps <= r.max_data_rate) )
+			break;
+	}
+
+	//	delay: shortest one longer than settling time
+
+	uint16_t	cc1		= (r.cc[ 1 ] & ~0x00FF) | (rate << 3) | sinc;
+	double		base	= time( cc1, 0x0000 );
+	uint8_t		delay	= 0;
+
+	while ( (delay < delay_last) && (time( cc1, delay << 10 ) - base < r.settling) )
+		delay++;
+
+	//	ADC_NORMAL_SETTING is cleared: single-cycle settling is needed for multiplexed scanning
+
+	c[ 0 ]	= r.cc[ 0 ];
+	c[ 1 ]	= cc1;
+	c[ 2 ]	= (r.cc[ 2 ] & ~(0x3F << 10 | normal_setting)) | (delay << 10);
+	c[ 3 ]	= r.cc[ 3 ];
+}
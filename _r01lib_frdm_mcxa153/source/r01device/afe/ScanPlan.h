@@ -0,0 +1,139 @@
+/** NXP Analog Front End class library for MCX
+ *
+ *  @class   ScanPlan
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2026 Tedd OKANO
+ *  Released under the MIT license
+ *
+ *  Sequencer scan planner.
+ *  From per-channel requirements, this chooses fastest data rate, SINC and delay settings
+ *  and makes decimated sub-schedules, so that slow channels don't take every scan cycle.
+ *
+ *  Example:
+ *  @code
+ *  NAFE13388_UIM	afe( spi );
+ *  ScanPlan		plan( afe );
+ *
+ *  const ScanPlan::requirement	req[]	= {
+ *  	//	CH_CONFIG0~3,							output rate, max data rate, SINC, settling
+ *  	{ { 0x1710, 0x0000, 0x0000, 0x0000 },	1000.0,		48000,			0,		20e-6	},
+ *  	{ { 0x2710, 0x0000, 0x0000, 0x0000 },	1000.0,		48000,			0,		20e-6	},
+ *  	{ { 0x3710, 0x0000, 0x0000, 0x0000 },	  10.0,		  400,			4,		100e-6	},
+ *  };
+ *
+ *  int main( void )
+ *  {
+ *  	afe.begin();
+ *
+ *  	if ( plan.plan( req, 3 ) )
+ *  		panic( "requirement cannot be met\r\n" );
+ *
+ *  	plan.apply();
+ *  	printf( "%lf cycles/s in %d slots\r\n", plan.frame_rate(), plan.slots() );
+ *
+ *  	while ( true )
+ *  	{
+ *  		AFE_base::raw_t	data[ 16 ];
+ *
+ *  		plan.start();
+ *  		plan.read( data );	//	data of channels in the slot, in channel number order
+ *  	}
+ *  }
+ *  @endcode
+ */
+
+#ifndef ARDUINO_AFE_SCAN_PLAN_H
+#define ARDUINO_AFE_SCAN_PLAN_H
+
+#include	<stdint.h>
+#include	"AFE_NXP.h"
+
+class ScanPlan
+{
+public:
+	/** Requirement for a channel */
+	typedef struct	_requirement	{
+		uint16_t	cc[ 4 ];		//	channel setting. Input, gain and calibration are used as is
+		double		output_rate;	//	minimum output rate in Hz
+		double		max_data_rate;	//	noise limit: fastest ADC data rate allowed in SPS. 0 for no limit
+		uint8_t		sinc;			//	SINC filter setting. 0 for no SINC
+		double		settling;		//	minimum settling delay after input switching in seconds
+	} requirement;
+
+	static constexpr int	max_slots	= 16;
+
+	/** Create a ScanPlan instance
+	 *
+	 * @param afe AFE to be configured
+	 */
+	ScanPlan( AFE_base& afe );
+	virtual ~ScanPlan();
+
+	/** Make a plan
+	 *
+	 * @param req array of requirements
+	 * @param n number of requirements (1 ~ number of logical channels of the device)
+	 * @return 0 if all requirements can be met, -1 if not. Plan is made even if -1.
+	 *	-2 if "n" is out of range. In this case, no plan is made and previous plan is kept
+	 */
+	int			plan( const requirement *req, int n );
+
+	/** Configure logical channels and enable first slot */
+	void		apply( void );
+
+	/** Select channels of next slot and start conversion (CMD_MM) */
+	void		start( void );
+
+	/** Wait conversion started by start() and read data
+	 *
+	 * @param data array to store data of channels in the slot, in channel number order
+	 */
+	void		read( AFE_base::raw_t *data );
+
+	/** Slot number to be started by next start() */
+	int			slot( void );
+
+	/** Number of slots in a super-cycle */
+	int			slots( void );
+
+	/** Enabled channel bitmap in a slot */
+	uint16_t	slot_mask( int s );
+
+	/** Logical channel number assigned for a requirement */
+	int			channel( int i );
+
+	/** Settings chosen for a requirement */
+	const uint16_t	*setting( int i );
+
+	/** Conversion time of a requirement in seconds */
+	double		conversion_time( int i );
+
+	/** Output rate achieved for a requirement in Hz */
+	double		output_rate( int i );
+
+	/** Scan cycles per second */
+	double		frame_rate( void );
+
+	/** Super-cycle time in seconds */
+	double		cycle_time( void );
+
+private:
+	double		time( uint16_t cc1, uint16_t cc2 );
+	void		choose_setting( const requirement &r, uint16_t (&cc)[ 4 ] );
+	double		schedule( int n_slots );
+
+	AFE_base&	afe;
+	int			count;
+	int			n_slots;
+	int			next_slot;
+	double		period;
+	uint16_t	cc[ 16 ][ 4 ];
+	double		t_conv[ 16 ];
+	double		rate_req[ 16 ];
+	uint8_t		per_cycle[ 16 ];	//	number of conversions in a super-cycle
+	uint8_t		ch_assign[ 16 ];
+	uint16_t	mask[ max_slots ];
+};
+
+#endif //	ARDUINO_AFE_SCAN_PLAN_H
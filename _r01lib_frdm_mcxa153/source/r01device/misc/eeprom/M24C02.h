@@ -22,6 +22,12 @@
 class M24C02 : public I2C_device
 {
 public:
+	/** Memory size in bytes */
+	static constexpr int	size		= 256;
+
+	/** Page write size. A page write wraps within the page */
+	static constexpr int	page_size	= 16;
+
 	/** Create a M24C02 instance with specified address
 	 *
 	 * @param wire I2C instance
@@ -0,0 +1,84 @@
+/*
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#ifndef R01LIB_COBS_H
+#define R01LIB_COBS_H
+
+#include	<stdint.h>
+
+/** Consistent Overhead Byte Stuffing (COBS) encode
+ *
+ *	Encoded data has no 0x00 byte, so 0x00 can be used as a frame delimiter.
+ *	Encoded length is "length + length / 254 + 1" at most. Delimiter is not added.
+ *
+ * @param src data to encode
+ * @param length data length in bytes
+ * @param dst buffer for encoded data
+ * @return encoded length in bytes
+ */
+constexpr int cobs_encode( const uint8_t *src, int length, uint8_t *dst )
+{
+	int	code_pos	= 0;
+	int	o			= 1;
+	uint8_t	code	= 1;
+
+	for ( auto i = 0; i < length; i++ )
+	{
+		if ( src[ i ] )
+		{
+			dst[ o++ ]	= src[ i ];
+
+			if ( 0xFF != ++code )
+				continue;
+		}
+
+		dst[ code_pos ]	= code;
+		code_pos		= o++;
+		code			= 1;
+	}
+
+	dst[ code_pos ]	= code;
+
+	return o;
+}
+
+/** COBS decode
+ *
+ *	Decode a frame without the delimiter. "dst" can be same as "src" (decoded in place).
+ *
+ * @param src encoded data
+ * @param length encoded length in bytes
+ * @param dst buffer for decoded data. Needs "length - 1" bytes
+ * @return decoded length in bytes, -1 if the data is broken
+ */
+constexpr int cobs_decode( const uint8_t *src, int length, uint8_t *dst )
+{
+	int	i	= 0;
+	int	o	= 0;
+
+	while ( i < length )
+	{
+		uint8_t	code	= src[ i++ ];
+
+		if ( !code || (length < i + code - 1) )
+			return -1;
+
+		for ( auto k = 1; k < code; k++ )
+		{
+			if ( !src[ i ] )
+				return -1;
+
+			dst[ o++ ]	= src[ i++ ];
+		}
+
+		if ( (0xFF != code) && (i < length) )
+			dst[ o++ ]	= 0x00;
+	}
+
+	return o;
+}
+
+#endif // R01LIB_COBS_H
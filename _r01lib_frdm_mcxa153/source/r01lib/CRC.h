@@ -0,0 +1,35 @@
+/*
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#ifndef R01LIB_CRC_H
+#define R01LIB_CRC_H
+
+#include	<stdint.h>
+
+/** CRC-16/CCITT-FALSE (polynomial 0x1021, initial value 0xFFFF)
+ *
+ *	Bitwise calculation, no table. Can be used in constant expression.
+ *	Calculation can be continued by giving previous result as "crc".
+ *
+ * @param data pointer to data
+ * @param length data length in bytes
+ * @param crc initial value
+ * @return CRC value
+ */
+constexpr uint16_t crc16( const uint8_t *data, int length, uint16_t crc = 0xFFFF )
+{
+	while ( length-- )
+	{
+		crc	^= (uint16_t)(*data++) << 8;
+
+		for ( auto i = 0; i < 8; i++ )
+			crc	= (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+	}
+
+	return crc;
+}
+
+#endif // R01LIB_CRC_H
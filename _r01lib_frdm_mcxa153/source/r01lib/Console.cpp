@@ -0,0 +1,395 @@
+/*
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+extern "C" {
+#include	"fsl_common.h"
+#include	"fsl_lpuart.h"
+#include	<stdarg.h>
+#include	"fsl_str.h"
+#include	"board.h"
+}
+
+#include	"Console.h"
+#include	<string.h>
+
+#define	CONSOLE_UART	((LPUART_Type *)BOARD_DEBUG_UART_BASEADDR)
+
+//	Transmit buffer: multiple producers (main and nested interrupts) and single consumer (LPUART interrupt).
+//	Indexes are free-running counters, storage is accessed by "index % capacity".
+//	A writer reserves space by moving "reserved" with compare-and-swap and copies data with interrupts enabled.
+//	"committed" is moved by the outermost writer when it finishes: a preempting writer completes before
+//	the preempted one resumes, so all reserved data is written when the writer count goes to zero.
+
+static constexpr uint32_t	capacity	= R01LIB_CONSOLE_TX_BUFFER_LEN;
+
+static_assert( !(capacity & (capacity - 1)), "R01LIB_CONSOLE_TX_BUFFER_LEN must be power of 2" );
+
+static uint8_t				storage[ capacity ];
+static volatile uint32_t	reserved	= 0;	//	end of space given to writers
+static volatile uint32_t	committed	= 0;	//	end of data ready to send
+static volatile uint32_t	sent		= 0;	//	start of data not sent yet
+static volatile uint32_t	writers		= 0;	//	write() calls in progress
+static volatile bool		active		= false;
+static Console::Policy		overflow	= Console::DROP;
+static volatile uint32_t	dropped		= 0;
+
+static IRQn_Type irqn( void )
+{
+	static const IRQn_Type	irqs[]	= LPUART_RX_TX_IRQS;
+
+	return irqs[ BOARD_DEBUG_UART_INSTANCE ];
+}
+
+static inline bool tx_ready( void )
+{
+#if defined(FSL_FEATURE_LPUART_HAS_FIFO) && FSL_FEATURE_LPUART_HAS_FIFO
+	return LPUART_GetTxFifoCount( CONSOLE_UART ) < FSL_FEATURE_LPUART_FIFO_SIZEn( CONSOLE_UART );
+#else
+	return LPUART_GetStatusFlags( CONSOLE_UART ) & kLPUART_TxDataRegEmptyFlag;
+#endif
+}
+
+static inline void kick( void )
+{
+	LPUART_EnableInterrupts( CONSOLE_UART, kLPUART_TxDataRegEmptyInterruptEnable );
+}
+
+static inline bool in_interrupt( void )
+{
+	//	waiting for the buffer in interrupt context or with interrupt disabled never ends
+
+	return __get_IPSR() || __get_PRIMASK();
+}
+
+static inline bool compare_and_swap( volatile uint32_t *p, uint32_t expected, uint32_t desired )
+{
+#if defined( __ARM_FEATURE_LDREX ) && (__ARM_FEATURE_LDREX & 0x4)
+	if ( __LDREXW( p ) != expected )
+	{
+		__CLREX();
+		return false;
+	}
+
+	return !__STREXW( desired, p );
+#else
+	//	no exclusive access instruction (Cortex-M0+): only the index update is done with interrupts disabled
+
+	uint32_t	mask	= DisableGlobalIRQ();
+	bool		done	= (*p == expected);
+
+	if ( done )
+		*p	= desired;
+
+	EnableGlobalIRQ( mask );
+
+	return done;
+#endif
+}
+
+static inline uint32_t atomic_add( volatile uint32_t *p, uint32_t v )
+{
+	uint32_t	old;
+
+	do
+		old	= *p;
+	while ( !compare_and_swap( p, old, old + v ) );
+
+	return old + v;
+}
+
+static inline uint32_t used( void )
+{
+	return reserved - sent;
+}
+
+/** Reserve space. With "overwrite", oldest data ready to send is dropped to make space */
+static bool reserve( uint32_t length, uint32_t &start, bool overwrite )
+{
+	while ( true )
+	{
+		uint32_t	r	= reserved;
+		uint32_t	s	= sent;
+
+		if ( r - s + length <= capacity )
+		{
+			if ( compare_and_swap( &reserved, r, r + length ) )
+			{
+				start	= r;
+				return true;
+			}
+
+			continue;
+		}
+
+		//	data reserved by preempted writers can not be dropped
+
+		uint32_t	over	= r - s + length - capacity;
+
+		if ( !overwrite || (committed - s < over) )
+			return false;
+
+		if ( compare_and_swap( &sent, s, s + over ) )
+			atomic_add( &dropped, over );
+	}
+}
+
+static void publish( void )
+{
+	//	committed index never goes back even if another writer published after "r" was read
+
+	while ( true )
+	{
+		uint32_t	c	= committed;
+		uint32_t	r	= reserved;
+
+		if ( (c == r) || compare_and_swap( &committed, c, r ) )
+			return;
+	}
+}
+
+/** Put data as one piece. Interrupts are not disabled while copying */
+static bool put( const uint8_t *data, uint32_t length, bool overwrite )
+{
+	uint32_t	start;
+
+	atomic_add( &writers, 1 );
+
+	bool	done	= reserve( length, start, overwrite );
+
+	if ( done )
+	{
+		uint32_t	offset	= start % capacity;
+		uint32_t	first	= (length < capacity - offset) ? length : capacity - offset;
+
+		memcpy( storage + offset, data, first );
+		memcpy( storage, data + first, length - first );
+	}
+
+	if ( !atomic_add( &writers, -1 ) )
+		publish();
+
+	return done;
+}
+
+void Console::begin( Policy p )
+{
+	overflow	= p;
+
+	if ( active )
+		return;
+
+	reserved	= 0;
+	committed	= 0;
+	sent		= 0;
+
+	NVIC_SetPriority( irqn(), (1UL << __NVIC_PRIO_BITS) - 1UL );
+	EnableIRQ( irqn() );
+
+	active	= true;
+}
+
+void Console::end( void )
+{
+	if ( !active )
+		return;
+
+	flush();
+	LPUART_DisableInterrupts( CONSOLE_UART, kLPUART_TxDataRegEmptyInterruptEnable );
+
+	active	= false;
+}
+
+void Console::policy( Policy p )
+{
+	overflow	= p;
+}
+
+int Console::write( const uint8_t *data, int length )
+{
+	if ( !active )
+	{
+		LPUART_WriteBlocking( CONSOLE_UART, data, length );
+		return length;
+	}
+
+	Policy	p	= (DROP != overflow && in_interrupt()) ? DROP : overflow;
+
+	if ( BLOCK == p )
+	{
+		//	writer count is not kept while waiting, so data from interrupts is published meanwhile
+
+		for ( int rest = length; 0 < rest; )
+		{
+			int	n	= capacity - used();
+
+			n	= (rest < n) ? rest : n;
+
+			if ( n && put( data, n, false ) )
+			{
+				data	+= n;
+				rest	-= n;
+			}
+
+			kick();
+		}
+
+		return length;
+	}
+
+	if ( (OVERWRITE == p) && (capacity < (uint32_t)length) )	//	only last part can be kept
+	{
+		atomic_add( &dropped, length - capacity );
+		data	+= length - capacity;
+		length	 = capacity;
+	}
+
+	if ( !put( data, length, OVERWRITE == p ) )
+	{
+		atomic_add( &dropped, length );
+		return 0;
+	}
+
+	kick();
+
+	return length;
+}
+
+//	formatting state is kept on caller's stack, as vprintf() can be called from interrupt context during another call.
+//	StrFormatPrintf() gives only the buffer pointer to the callback, so the buffer is placed at top of the state
+
+typedef struct	_print_chunk	{
+	char	buf[ 32 ];
+	int		printed;
+} print_chunk_t;
+
+static void print_callback( char *buf, int32_t *indicator, char c, int len )
+{
+	print_chunk_t	*pc	= reinterpret_cast<print_chunk_t *>( buf );
+
+	for ( auto i = 0; i < len; i++ )
+	{
+		if ( (int)sizeof( pc->buf ) <= *indicator + 1 )
+		{
+			Console::write( (uint8_t *)buf, *indicator );
+			pc->printed	+= *indicator;
+			*indicator	 = 0;
+		}
+
+		buf[ (*indicator)++ ]	= c;
+	}
+}
+
+int Console::vprintf( const char *format, va_list ap )
+{
+	print_chunk_t	pc;
+
+	pc.printed	= 0;
+
+	int	rest	= StrFormatPrintf( format, ap, pc.buf, print_callback );
+
+	write( (uint8_t *)pc.buf, rest );
+
+	return pc.printed + rest;
+}
+
+void Console::flush( void )
+{
+	if ( !active )
+		return;
+
+	if ( in_interrupt() )
+		return;
+
+	kick();
+
+	while ( sent != committed )
+		;
+
+	while ( !(LPUART_GetStatusFlags( CONSOLE_UART ) & kLPUART_TransmissionCompleteFlag) )
+		;
+}
+
+int Console::pending( void )
+{
+	return committed - sent;
+}
+
+uint32_t Console::dropped_count( void )
+{
+	return dropped;
+}
+
+void Console::clear_count( void )
+{
+	dropped	= 0;
+}
+
+bool Console::running( void )
+{
+	return active;
+}
+
+void Console::irq_handler( void )
+{
+	while ( tx_ready() )
+	{
+		uint32_t	s	= sent;
+
+		if ( s == committed )
+		{
+			LPUART_DisableInterrupts( CONSOLE_UART, kLPUART_TxDataRegEmptyInterruptEnable );
+
+			if ( s == committed )	//	data published by a higher priority writer after the check
+				break;
+
+			kick();
+			continue;
+		}
+
+		//	byte is taken before "sent" moves. If OVERWRITE policy dropped it meanwhile, swap fails and it is not sent
+
+		uint8_t	b	= storage[ s % capacity ];
+
+		if ( compare_and_swap( &sent, s, s + 1 ) )
+			LPUART_WriteByte( CONSOLE_UART, b );
+	}
+}
+
+int console_printf( const char *format, ... )
+{
+	if ( !Console::running() )
+		Console::begin();
+
+	va_list	ap;
+
+	va_start( ap, format );
+	int	r	= Console::vprintf( format, ap );
+	va_end( ap );
+
+	return r;
+}
+
+int console_putchar( int c )
+{
+	uint8_t	b	= c;
+
+	if ( !Console::running() )
+		Console::begin();
+
+	Console::write( &b, 1 );
+
+	return c;
+}
+
+//	LPUART interrupt is used by SDK debug console in its non-blocking mode
+
+#if !defined(DEBUG_CONSOLE_TRANSFER_NON_BLOCKING) && (BOARD_DEBUG_UART_INSTANCE == 0U)
+extern "C" void LPUART0_IRQHandler( void )
+{
+	Console::irq_handler();
+	SDK_ISR_EXIT_BARRIER;
+}
+#endif
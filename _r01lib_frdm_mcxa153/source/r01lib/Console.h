@@ -0,0 +1,106 @@
+/*
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#ifndef R01LIB_CONSOLE_H
+#define R01LIB_CONSOLE_H
+
+#include	<stdint.h>
+#include	<stdarg.h>
+
+#ifndef	R01LIB_CONSOLE_TX_BUFFER_LEN
+#define	R01LIB_CONSOLE_TX_BUFFER_LEN	1024
+#endif
+
+/** Console class
+ *
+ *  @class Console
+ *
+ *	Non-blocking transmit for debug console (LPUART given by BOARD_DEBUG_UART_BASEADDR).
+ *	Output is stored in a lock-free ring buffer and sent by LPUART transmit interrupt,
+ *	so printf() returns without waiting for the UART.
+ *
+ *	When "R01LIB_CONSOLE_NON_BLOCKING" is defined in build setting, printf() and putchar() are
+ *	redirected to console_printf() and console_putchar(). Console starts at first output with DROP policy.
+ *	Without the definition, Console can be used explicitly by begin() and console_printf().
+ *
+ *	Output can be made from interrupt context too. Buffer space is reserved by compare-and-swap (LDREX/STREX)
+ *	and data is copied with interrupts enabled, so console output never masks DRDY or other interrupts.
+ *	BLOCK/OVERWRITE policies work as DROP in interrupt context.
+ *	R01LIB_CONSOLE_TX_BUFFER_LEN must be power of 2.
+ *	Data of a write() call is not split by others in DROP and OVERWRITE policies (printf() output is written in 32 byte chunks).
+ *	LPUART interrupt is set to lowest priority, so it never delays DRDY or other interrupts.
+ *
+ *	Example:
+ *	@code
+ *	Console::begin( Console::DROP );
+ *
+ *	while ( true )
+ *	{
+ *		console_printf( "%lf\r\n", afe.logical_channel[ 0 ].read() );
+ *	}
+ *	@endcode
+ */
+class Console
+{
+public:
+	/** Policy when the buffer is full */
+	enum Policy	{
+		DROP,		//	new data is dropped
+		BLOCK,		//	wait for space (falls back to DROP in interrupt context)
+		OVERWRITE,	//	oldest data is dropped
+	};
+
+	/** Start non-blocking transmit
+	 *
+	 * @param p policy when buffer is full
+	 */
+	static void		begin( Policy p = DROP );
+
+	/** Wait for all data sent and go back to blocking transmit */
+	static void		end( void );
+
+	/** Set policy when buffer is full */
+	static void		policy( Policy p );
+
+	/** Put data into the transmit buffer
+	 *
+	 *	With DROP policy, data is dropped entirely if there is not enough space
+	 *
+	 * @param data pointer to data
+	 * @param length data length in bytes
+	 * @return number of bytes stored
+	 */
+	static int		write( const uint8_t *data, int length );
+
+	/** Formatted output into the transmit buffer. Same format as DbgConsole_Printf() */
+	static int		vprintf( const char *format, va_list ap );
+
+	/** Wait for all data sent */
+	static void		flush( void );
+
+	/** Number of bytes waiting in the buffer */
+	static int		pending( void );
+
+	/** Number of bytes dropped by buffer full */
+	static uint32_t	dropped_count( void );
+
+	/** Clear dropped_count */
+	static void		clear_count( void );
+
+	/** true if non-blocking transmit is running */
+	static bool		running( void );
+
+	/** Transmit interrupt handler. Called from LPUART IRQ handler */
+	static void		irq_handler( void );
+};
+
+/** printf() through Console. Console is started if it's not running */
+int	console_printf( const char *format, ... );
+
+/** putchar() through Console. Console is started if it's not running */
+int	console_putchar( int c );
+
+#endif // R01LIB_CONSOLE_H
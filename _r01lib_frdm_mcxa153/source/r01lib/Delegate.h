@@ -0,0 +1,98 @@
+/*
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#ifndef R01LIB_DELEGATE_H
+#define R01LIB_DELEGATE_H
+
+#include	<stddef.h>
+#include	<new>
+#include	<type_traits>
+
+template<class Signature, size_t Size = sizeof( void * )>
+class Delegate;
+
+/** Delegate class
+ *
+ *  @class Delegate
+ *
+ *	Fixed-size callback holder for interrupt callbacks, replacing std::function.
+ *	A function pointer or a small callable (like "[ this ](){ ... }") is stored in the object itself,
+ *	so no heap is used and calling it costs one indirect call.
+ *	Callable must be trivially copyable and not larger than "Size" bytes. It is checked in compile time.
+ *
+ *	Example:
+ *	@code
+ *	Delegate<void(void)>		cb	= [ this ](){ done(); };
+ *	Delegate<void(status_t)>	fp	= function_name;
+ *
+ *	if ( cb )
+ *		cb();
+ *	@endcode
+ */
+template<class R, class... Args, size_t Size>
+class Delegate<R( Args... ), Size>
+{
+public:
+	constexpr Delegate() : invoke( nullptr ), storage{} {}
+	constexpr Delegate( std::nullptr_t ) : invoke( nullptr ), storage{} {}
+
+	/** Create a Delegate with a function pointer */
+	Delegate( R (*fp)( Args... ) ) : invoke( nullptr ), storage{}
+	{
+		if ( fp )
+			set( fp );
+	}
+
+	/** Create a Delegate with a callable object */
+	template<class F, class = typename std::enable_if<!std::is_same<typename std::decay<F>::type, Delegate>::value>::type>
+	Delegate( const F &f ) : invoke( nullptr ), storage{}
+	{
+		set( f );
+	}
+
+	inline R operator()( Args... args ) const
+	{
+		return invoke( storage, args... );
+	}
+
+	explicit operator bool( void ) const
+	{
+		return nullptr != invoke;
+	}
+
+	bool operator==( std::nullptr_t ) const
+	{
+		return nullptr == invoke;
+	}
+
+	bool operator!=( std::nullptr_t ) const
+	{
+		return nullptr != invoke;
+	}
+
+private:
+	template<class F>
+	void set( const F &f )
+	{
+		static_assert( sizeof( F ) <= Size, "callable is too large for Delegate" );
+		static_assert( alignof( F ) <= alignof( void * ), "callable alignment is not supported by Delegate" );
+		static_assert( std::is_trivially_copyable<F>::value && std::is_trivially_destructible<F>::value, "callable for Delegate must be trivially copyable" );
+
+		new ( storage ) F( f );
+		invoke	= &call<F>;
+	}
+
+	template<class F>
+	static R call( const void *p, Args... args )
+	{
+		return (*static_cast<const F *>( p ))( args... );
+	}
+
+	R		(*invoke)( const void *, Args... );
+	alignas( void * ) unsigned char	storage[ Size ];
+};
+
+#endif // R01LIB_DELEGATE_H
@@ -43,16 +43,26 @@ extern "C" {
 #else
 #define	kRisingEdge		kPORT_InterruptRisingEdge
 #define	kFallingEdge	kPORT_InterruptFallingEdge
-typedef void (*utick_callback_t)(void);
 #endif
 
 
-utick_callback_t	cb_table[ N_GPIO ][ GPIO_BITS ]	= { NULL };
+//	constant initialized, so callbacks can be registered from constructors of global objects
+constinit irq_callback_t	cb_table[ N_GPIO ][ GPIO_BITS ];
+static volatile uint32_t	entry_cycles	= 0;
+
+static inline void irq_entry( void )
+{
+#if defined( DWT )
+	entry_cycles	= DWT->CYCCNT;
+#endif
+}
 
 #if (defined(FSL_FEATURE_PORT_HAS_NO_INTERRUPT) && FSL_FEATURE_PORT_HAS_NO_INTERRUPT)
 
 void irq_handler( int num )
 {
+	irq_entry();
+
 	uint32_t	flags;
 	flags	= GPIO_GpioGetInterruptFlags( gpio_ptr[ num ] );
 	GPIO_GpioClearInterruptFlags( gpio_ptr[ num ], flags );
@@ -72,6 +82,8 @@ void irq_handler( int num )
 	GPIO_Type	*gpios[]	= { GPIOA, GPIOC, GPIOD };
 	uint32_t	flags;
 	
+	irq_entry();
+
 	for ( int i = num; i < 3; i++ )
 	{
 		if ( (flags	= ports[ i ]->ISFR) )
@@ -97,20 +109,25 @@ InterruptIn::InterruptIn( uint8_t pin_num )
 
 InterruptIn::~InterruptIn() {}
 
-void InterruptIn::rise( func_ptr callback )
+void InterruptIn::rise( irq_callback_t callback )
 {
 	regist( callback, kRisingEdge );
 }
 
-void InterruptIn::fall( func_ptr callback )
+void InterruptIn::fall( irq_callback_t callback )
+{
+	regist( callback, kFallingEdge );
+}
+
+uint32_t InterruptIn::irq_entry_cycles( void )
 {
-	regist( *callback, kFallingEdge );
+	return entry_cycles;
 }
 
 #if (defined(FSL_FEATURE_PORT_HAS_NO_INTERRUPT) && FSL_FEATURE_PORT_HAS_NO_INTERRUPT)
-void InterruptIn::regist( func_ptr callback, gpio_interrupt_config_t type )
+void InterruptIn::regist( irq_callback_t callback, gpio_interrupt_config_t type )
 #else
-void InterruptIn::regist( func_ptr callback, port_interrupt_t type )
+void InterruptIn::regist( irq_callback_t callback, port_interrupt_t type )
 #endif
 {
 #if (defined(FSL_FEATURE_PORT_HAS_NO_INTERRUPT) && FSL_FEATURE_PORT_HAS_NO_INTERRUPT)
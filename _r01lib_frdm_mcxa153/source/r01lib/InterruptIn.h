@@ -21,8 +21,10 @@ extern "C" {
 }
 
 #include	"io.h"
+#include	"Delegate.h"
 
 typedef	void (*func_ptr)( void );
+using	irq_callback_t	= Delegate<void(void)>;
 
 class InterruptIn : public DigitalIn
 {	
@@ -40,21 +42,27 @@ public:
 	
 	/** Register callback function which is called by rising edge
 	 *
-	 * @param callback pointer to callback fuction
+	 * @param callback pointer to callback fuction or small callable like "[ this ](){ ... }"
 	 */
-	virtual void	rise( func_ptr callback );
+	virtual void	rise( irq_callback_t callback );
 
 	/** Register callback function which is called by falling edge
 	 *
-	 * @param callback pointer to callback fuction
+	 * @param callback pointer to callback fuction or small callable like "[ this ](){ ... }"
 	 */
-	virtual void	fall( func_ptr callback );
+	virtual void	fall( irq_callback_t callback );
+
+	/** CPU cycle count (DWT) at entry of the last GPIO interrupt, for callback latency measurement
+	 *
+	 * @return cycle count, 0 if the cycle counter is not available
+	 */
+	static uint32_t	irq_entry_cycles( void );
 
 private:
 #if (defined(FSL_FEATURE_PORT_HAS_NO_INTERRUPT) && FSL_FEATURE_PORT_HAS_NO_INTERRUPT)
-	void	regist( func_ptr callback, gpio_interrupt_config_t type );
+	void	regist( irq_callback_t callback, gpio_interrupt_config_t type );
 #else
-	void	regist( func_ptr callback, port_interrupt_t type );
+	void	regist( irq_callback_t callback, port_interrupt_t type );
 #endif
 };
 
@@ -0,0 +1,179 @@
+/*
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#ifndef R01LIB_RINGBUFFER_H
+#define R01LIB_RINGBUFFER_H
+
+#include	<stdint.h>
+
+/** RingBuffer class
+ *
+ *  @class RingBuffer
+ *
+ *	Lock-free single-producer/single-consumer ring buffer on user-given storage.
+ *	Producer (ISR) and consumer (main loop) can run concurrently without disabling interrupt.
+ *	One element of the storage is kept unused to tell full and empty.
+ */
+
+template<class T>
+class RingBuffer
+{
+public:
+	/** Create a RingBuffer instance
+	 *
+	 * @param buffer pointer to storage
+	 * @param size number of elements in the storage
+	 */
+	RingBuffer( T *buffer = nullptr, int size = 0 ) : buf( buffer ), length( size ), head( 0 ), tail( 0 ) {}
+	virtual ~RingBuffer() {}
+
+	/** Set storage and clear
+	 *
+	 * @param buffer pointer to storage
+	 * @param size number of elements in the storage
+	 */
+	void	storage( T *buffer, int size )
+	{
+		buf		= buffer;
+		length	= size;
+		clear();
+	}
+
+	/** Clear buffer. Should be called while producer is stopped */
+	void	clear( void )
+	{
+		head	= 0;
+		tail	= 0;
+	}
+
+	/** Get a pointer to free element for producer (zero-copy push)
+	 *
+	 * @return pointer to the element or nullptr if buffer is full
+	 */
+	T		*reserve( void )
+	{
+		if ( full() )
+			return nullptr;
+
+		return buf + head;
+	}
+
+	/** Publish the element given by reserve() */
+	void	commit( void )
+	{
+		__asm volatile( "" ::: "memory" );
+		head	= next( head );
+	}
+
+	/** Push an element
+	 *
+	 * @param v value
+	 * @return false if buffer is full
+	 */
+	bool	push( const T &v )
+	{
+		T	*p	= reserve();
+
+		if ( !p )
+			return false;
+
+		*p	= v;
+		commit();
+
+		return true;
+	}
+
+	/** Get a pointer to oldest element for consumer (zero-copy pop)
+	 *
+	 * @return pointer to the element or nullptr if buffer is empty
+	 */
+	T		*peek( void )
+	{
+		if ( empty() )
+			return nullptr;
+
+		return buf + tail;
+	}
+
+	/** Release the element given by peek() */
+	void	release( void )
+	{
+		__asm volatile( "" ::: "memory" );
+		tail	= next( tail );
+	}
+
+	/** Pop an element
+	 *
+	 * @param v reference to store the value
+	 * @return false if buffer is empty
+	 */
+	bool	pop( T &v )
+	{
+		T	*p	= peek();
+
+		if ( !p )
+			return false;
+
+		v	= *p;
+		release();
+
+		return true;
+	}
+
+	/** Pop elements
+	 *
+	 * @param dp pointer to array to store values
+	 * @param n maximum number of elements
+	 * @return number of elements popped
+	 */
+	int		pop( T *dp, int n )
+	{
+		int	count	= 0;
+
+		while ( (count < n) && pop( dp[ count ] ) )
+			count++;
+
+		return count;
+	}
+
+	/** Number of elements stored */
+	int		available( void )
+	{
+		int	h	= head;
+		int	t	= tail;
+
+		return (h < t) ? h + length - t : h - t;
+	}
+
+	/** Number of free elements */
+	int		space( void )
+	{
+		return length - 1 - available();
+	}
+
+	bool	empty( void )
+	{
+		return head == tail;
+	}
+
+	bool	full( void )
+	{
+		return next( head ) == tail;
+	}
+
+private:
+	inline int	next( int i )
+	{
+		return (++i == length) ? 0 : i;
+	}
+
+	T				*buf;
+	int				length;
+	volatile int	head;
+	volatile int	tail;
+};
+
+#endif // R01LIB_RINGBUFFER_H
@@ -0,0 +1,194 @@
+/*
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#ifndef	CPU_MCXC444VLH
+
+extern "C" {
+#include	"fsl_common.h"
+}
+
+#include	"SPIBus.h"
+#include	"mcu.h"
+
+/* SPIBus::Device class ******************************************/
+
+SPIBus::Device::Device( SPIBus& b, int cs )
+	: SPI( &b._spi ), bus( b ), chip_select( cs, 1 ), freq( SPI_FREQ ), spi_mode( 0 ), queue( queue_storage, queue_depth )
+{
+	prof	= make_profile( freq, spi_mode );
+	bus.attach( this );
+}
+
+SPIBus::Device::~Device()
+{
+	bus.detach( this );
+}
+
+void SPIBus::Device::frequency( uint32_t frequency )
+{
+	freq	= frequency;
+	prof	= make_profile( freq, spi_mode );
+}
+
+void SPIBus::Device::mode( uint8_t mode )
+{
+	spi_mode	= mode;
+	prof		= make_profile( freq, spi_mode );
+}
+
+status_t SPIBus::Device::write( uint8_t *wp, uint8_t *rp, int length )
+{
+	volatile bool	done	= false;
+	status_t		result	= kStatus_Success;
+	request_t		r		= { wp, rp, length, nullptr, &done, &result };
+
+	if ( __get_IPSR() )		//	waiting in interrupt cannot be served
+		return kStatus_Busy;
+
+	while ( true )
+	{
+		uint32_t	primask	= DisableGlobalIRQ();	//	producers can be main-loop and interrupt
+		bool		queued	= queue.push( r );
+		EnableGlobalIRQ( primask );
+
+		if ( queued )
+			break;
+	}
+
+	bus.dispatch();
+
+	while ( !done )
+		;
+
+	last_status	= result;
+	return result;
+}
+
+status_t SPIBus::Device::write_nonblocking( uint8_t *wp, uint8_t *rp, int length, spi_callback_fp_t callback )
+{
+	request_t	r	= { wp, rp, length, callback, nullptr, nullptr };
+
+	uint32_t	primask	= DisableGlobalIRQ();	//	producers can be main-loop and interrupt
+	bool		queued	= queue.push( r );
+	EnableGlobalIRQ( primask );
+
+	if ( !queued )
+		return kStatus_Busy;
+
+	bus.dispatch();
+
+	return kStatus_Success;
+}
+
+/* SPIBus class ******************************************/
+
+SPIBus::SPIBus( SPI& spi )
+	: _spi( spi ), device_count( 0 ), last_served( -1 ), active( nullptr ), current( { 0, 0 } ), count( 0 )
+{
+}
+
+SPIBus::~SPIBus()
+{
+}
+
+uint32_t SPIBus::transfer_count( void )
+{
+	return count;
+}
+
+void SPIBus::attach( Device *dev )
+{
+	if ( max_devices <= device_count )
+		panic( "SPIBus: too many devices\r\n" );
+
+	devices[ device_count++ ]	= dev;
+}
+
+void SPIBus::detach( Device *dev )
+{
+	for ( auto i = 0; i < device_count; i++ )
+	{
+		if ( devices[ i ] == dev )
+		{
+			for ( auto j = i; j < device_count - 1; j++ )
+				devices[ j ]	= devices[ j + 1 ];
+
+			device_count--;
+			break;
+		}
+	}
+}
+
+void SPIBus::dispatch( void )
+{
+	//	picks next device in round-robin order from last served one
+
+	uint32_t	primask	= DisableGlobalIRQ();
+
+	if ( active )
+	{
+		EnableGlobalIRQ( primask );
+		return;
+	}
+
+	Device	*dev	= nullptr;
+
+	for ( auto n = 1; n <= device_count; n++ )
+	{
+		int	i	= (last_served + n) % device_count;
+
+		if ( !devices[ i ]->queue.empty() )
+		{
+			dev			= devices[ i ];
+			last_served	= i;
+			break;
+		}
+	}
+
+	active	= dev;
+	EnableGlobalIRQ( primask );
+
+	if ( !dev )
+		return;
+
+	if ( (current.ccr != dev->prof.ccr) || (current.tcr != dev->prof.tcr) )
+	{
+		_spi.profile( dev->prof );
+		current	= dev->prof;
+	}
+
+	Device::request_t	*r	= dev->queue.peek();
+
+	dev->chip_select	= 0;
+
+	if ( kStatus_Success != _spi.write_nonblocking( r->wp, r->rp, r->length, [ this ]( status_t status ){ complete( status ); } ) )
+		complete( kStatus_Busy );
+}
+
+void SPIBus::complete( status_t status )
+{
+	Device				*dev	= active;
+	Device::request_t	r		= *(dev->queue.peek());
+
+	dev->chip_select	= 1;
+	dev->queue.release();
+	count++;
+
+	if ( r.result )
+		*r.result	= status;
+
+	if ( r.done )
+		*r.done	= true;
+
+	active	= nullptr;
+
+	if ( r.callback )
+		r.callback( status );
+
+	dispatch();
+}
+
+#endif // !CPU_MCXC444VLH
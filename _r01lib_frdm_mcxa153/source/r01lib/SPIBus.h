@@ -0,0 +1,127 @@
+/*
+ *  @author Tedd OKANO
+ *
+ *  Released under the MIT license License
+ */
+
+#ifndef R01LIB_SPIBUS_H
+#define R01LIB_SPIBUS_H
+
+#ifndef	CPU_MCXC444VLH
+
+#include	"spi.h"
+#include	"io.h"
+#include	"RingBuffer.h"
+
+/** SPIBus class
+ *
+ *  @class SPIBus
+ *
+ *	A class for sharing one SPI with multiple devices.
+ *	Each device has its own chip-select pin (GPIO), frequency and mode.
+ *	Transfers from devices are queued per device and served in round-robin order.
+ *
+ *  Example:
+ *  @code
+ *  SPI					spi( ARD_MOSI, ARD_MISO, ARD_SCK, ARD_CS );
+ *  SPIBus				bus( spi );
+ *  SPIBus::Device		dev0( bus, ARD_CS );
+ *  SPIBus::Device		dev1( bus, D9 );
+ *  NAFE13388_UIM		afe0( dev0 );
+ *  NAFE13388_UIM		afe1( dev1 );
+ *
+ *  int main( void )
+ *  {
+ *  	dev0.frequency( 1'000'000 );
+ *  	dev0.mode( 1 );
+ *  	dev1.frequency( 1'000'000 );
+ *  	dev1.mode( 1 );
+ *  	...
+ *  @endcode
+ */
+
+class SPIBus
+{
+public:
+	/** Device on the SPIBus
+	 *
+	 *	This can be used as a SPI instance.
+	 *	frequency() and mode() are kept as precomputed LPSPI register values (SPI::profile_t)
+	 *	and applied by few register writes when the bus switches to this device
+	 */
+	class Device : public SPI
+	{
+	public:
+		/** Create a Device instance
+		 *
+		 * @param bus SPIBus to attach
+		 * @param cs pin number to connect CS
+		 */
+		Device( SPIBus& bus, int cs );
+		virtual ~Device();
+
+		virtual void		frequency( uint32_t frequency = SPI_FREQ );
+		virtual void		mode( uint8_t mode = 0 );
+
+		/** Data transfer. Waits until the transfer for this device is done */
+		virtual status_t	write( uint8_t *wp, uint8_t *rp, int length );
+
+		/** Non-blocking data transfer. The transfer is queued and started when the bus is available
+		 *
+		 * @return kStatus_Success if queued. kStatus_Busy if the queue is full
+		 */
+		virtual status_t	write_nonblocking( uint8_t *wp, uint8_t *rp, int length, spi_callback_fp_t callback = nullptr );
+
+	private:
+		friend class SPIBus;
+
+		typedef struct	_request	{
+			uint8_t				*wp;
+			uint8_t				*rp;
+			int					length;
+			spi_callback_fp_t	callback;
+			volatile bool		*done;
+			status_t			*result;
+		} request_t;
+
+		static constexpr int	queue_depth	= 5;
+
+		SPIBus&					bus;
+		DigitalOut				chip_select;
+		uint32_t				freq;
+		uint8_t					spi_mode;
+		profile_t				prof;
+		request_t				queue_storage[ queue_depth ];
+		RingBuffer<request_t>	queue;
+	};
+
+	/** Create a SPIBus instance
+	 *
+	 * @param spi SPI instance for the bus
+	 */
+	SPIBus( SPI& spi );
+	virtual ~SPIBus();
+
+	/** Number of transfers done */
+	uint32_t	transfer_count( void );
+
+	static constexpr int	max_devices	= 8;
+
+private:
+	void		attach( Device *dev );
+	void		detach( Device *dev );
+	void		dispatch( void );
+	void		complete( status_t status );
+
+	SPI&				_spi;
+	Device				*devices[ max_devices ];
+	int					device_count;
+	int					last_served;
+	Device				*active;
+	SPI::profile_t		current;
+	volatile uint32_t	count;
+};
+
+#endif // !CPU_MCXC444VLH
+
+#endif // R01LIB_SPIBUS_H
@@ -35,4 +35,17 @@ void Ticker::attach( ticker_callback_fp_t callback, float sec )
 	fp	= callback;
 	UTICK_SetTick( utick_type, kUTICK_Repeat, (uint32_t)(sec * 1000000.0) - 1, _ticker_callback );
 }
+
+void Ticker::detach( void )
+{
+	utick_type->CTRL	= 0;	//	DELAYVAL = 0 stops the timer
+	fp					= nullptr;
+}
+
+bool Ticker::in_use( void )
+{
+	//	DELAYVAL is cleared by detach() and by wait_flag() when they release UTICK
+
+	return UTICK0->CTRL & UTICK_CTRL_DELAYVAL_MASK;
+}
 #endif // !CPU_MCXC444VLH
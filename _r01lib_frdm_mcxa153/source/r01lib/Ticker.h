@@ -9,15 +9,13 @@
 
 #ifndef	CPU_MCXC444VLH
 
-#include <functional>
-
 extern "C" {
 #include	"fsl_utick.h"
 }
 
-#include	<functional>
+#include	"Delegate.h"
 
-using	ticker_callback_fp_t	= std::function<void(void)>;
+using	ticker_callback_fp_t	= Delegate<void(void)>;
 
 /** Ticker class
  *	
@@ -47,6 +45,18 @@ public:
 	 */
 	virtual void	attach( ticker_callback_fp_t callback, float sec );
 
+	/** Stop calling the callback */
+	virtual void	detach( void );
+
+	/** Check UTICK is running
+	 *
+	 *	UTICK is shared by all Ticker instances and wait_flag() timeout.
+	 *	attach() while it runs takes it from the other user
+	 *
+	 * @return true if a Ticker is attached or wait_flag() is waiting
+	 */
+	static bool		in_use( void );
+
 private:
 	UTICK_Type	*utick_type;
 };
@@ -27,6 +27,10 @@ extern "C" {
 #include "obj.h"
 #include "io.h"
 
+#ifdef	CPU_MCXA153VLH
+	#define	US_TICKER_CTIMER	CTIMER2		//	free-running 1MHz counter for us_ticker_read()
+#endif
+
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wprio-ctor-dtor"
 __attribute__((constructor(0)))
@@ -177,6 +181,12 @@ void init_mcu( void )
 
 	RESET_PeripheralReset( kUTICK0_RST_SHIFT_RSTn );
 	
+	/* CTIMER2 for us_ticker_read(), counts 1MHz clock while core sleeps */
+	CLOCK_SetClockDiv( kCLOCK_DivCTIMER2, 1u );
+	CLOCK_AttachClk( kCLK_1M_to_CTIMER2 );
+	CLOCK_EnableClock( kCLOCK_GateCTIMER2 );
+	RESET_PeripheralReset( kCTIMER2_RST_SHIFT_RSTn );
+
 	BOARD_InitPins();
 	BOARD_InitBootClocks();
 	BOARD_InitDebugConsole();
@@ -208,6 +218,18 @@ void init_mcu( void )
 #ifndef	CPU_MCXC444VLH
 	UTICK_Init( UTICK0 );
 #endif
+
+#if defined( DWT )
+	MSDK_EnableCpuCycleCounter();
+#endif
+
+#if defined( US_TICKER_CTIMER )
+	US_TICKER_CTIMER->CTCR	= 0;						//	timer mode
+	US_TICKER_CTIMER->PR	= 0;						//	count every 1MHz clock
+	US_TICKER_CTIMER->MCR	= 0;						//	no match action: free-running
+	US_TICKER_CTIMER->TCR	= CTIMER_TCR_CRST_MASK;
+	US_TICKER_CTIMER->TCR	= CTIMER_TCR_CEN_MASK;
+#endif
 }
 
 void wait( double delayTime_sec )
@@ -225,6 +247,114 @@ void wait_us( unsigned int microseconds )
 	wait( (double)microseconds * 1e-6 );
 }
 
+uint32_t us_ticker_read( void )
+{
+#if defined( US_TICKER_CTIMER )
+	//	microsecond count by free-running CTIMER. It keeps counting while the core is in WFI, wraps in 71 minutes
+
+	return US_TICKER_CTIMER->TC;
+#elif defined( DWT )
+	//	microsecond count extended from CPU cycle counter
+	//	cycle counter wraps in 2^32 / core clock: this needs to be called at least once in this period (44 seconds at 96MHz)
+
+	static uint32_t	last_cycles	= 0;
+	static uint32_t	remainder	= 0;
+	static uint32_t	us			= 0;
+
+	uint32_t	primask		= DisableGlobalIRQ();
+	uint32_t	now			= MSDK_GetCpuCycleCount();
+	uint32_t	cycles_us	= SystemCoreClock / 1000000;
+	uint32_t	cycles		= now - last_cycles + remainder;
+
+	last_cycles	 = now;
+	us			+= cycles / cycles_us;
+	remainder	 = cycles % cycles_us;
+	
+	uint32_t	r	= us;
+	EnableGlobalIRQ( primask );
+
+	return r;
+#else
+	return 0;	//	no cycle counter on this core
+#endif
+}
+
+#ifndef	CPU_MCXC444VLH
+static volatile bool	utick_expired;
+
+static void utick_timeout_cb( void )
+{
+	utick_expired	= true;
+}
+#endif
+
+void wait_sleep( double delayTime_sec )
+{
+	static volatile bool	never	= false;
+
+	wait_flag( never, delayTime_sec );
+}
+
+bool wait_flag( volatile bool &flag, double timeout_sec )
+{
+	//	sleeps by WFI until "flag" is set by interrupt or timeout
+	//	UTICK is used for timeout. If it is used by Ticker, timeout is checked on CPU cycle counter without sleeping
+	
+	constexpr double	min_sleep	= 20e-6;
+
+	if ( flag )
+		return true;
+
+	if ( timeout_sec < min_sleep )
+	{
+		wait( timeout_sec );
+		return flag;
+	}
+
+#ifndef	CPU_MCXC444VLH
+	if ( !(UTICK0->STAT & UTICK_STAT_ACTIVE_MASK) )
+	{
+		utick_expired	= false;
+		UTICK_SetTick( UTICK0, kUTICK_Onetime, (uint32_t)(timeout_sec * 1000000.0) - 1, utick_timeout_cb );
+
+		SCB->SCR	&= ~SCB_SCR_SLEEPDEEP_Msk;
+
+		while ( true )
+		{
+			//	IRQ is disabled to avoid missing wakeup between check and WFI. Pending IRQ still wakes WFI up
+			__disable_irq();
+			
+			if ( flag || utick_expired )
+			{
+				__enable_irq();
+				break;
+			}
+			
+			__DSB();
+			__WFI();
+			__enable_irq();
+		}
+
+		UTICK0->CTRL	= 0;
+		UTICK_ClearStatusFlags( UTICK0 );
+
+		return flag;
+	}
+#endif
+
+#if defined( US_TICKER_CTIMER ) || defined( DWT )
+	uint32_t	start	= us_ticker_read();
+	uint32_t	limit	= (uint32_t)(timeout_sec * 1000000.0);
+
+	while ( !flag && ((us_ticker_read() - start) < limit) )
+		;
+#else
+	wait( timeout_sec );
+#endif
+
+	return flag;
+}
+
 void panic( const char *s )
 {
 	PRINTF( "error: %s", s );
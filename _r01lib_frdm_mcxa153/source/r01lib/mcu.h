@@ -13,6 +13,16 @@ void	init_mcu( void );
 void	wait( double delayTime_sec );
 void	wait_ms( unsigned int milloseconds );
 void	wait_us( unsigned int microseconds );
+
+/** Micro-second time
+ *
+ *	MCXA153: free-running CTIMER2 on 1MHz clock. Keeps counting while the core sleeps, wraps in 2^32 us (71 minutes)
+ *	Other MCUs: extended from DWT cycle counter. It stops in sleep and needs to be called at least once in 2^32 cycles
+ */
+uint32_t	us_ticker_read( void );
+
+void	wait_sleep( double delayTime_sec );
+bool	wait_flag( volatile bool &flag, double timeout_sec );
 void 	panic( const char *s );
 
 
@@ -15,9 +15,14 @@ extern "C" {
 #include	<iomanip>
 
 #if (defined(SDK_DEBUGCONSOLE) && (SDK_DEBUGCONSOLE == DEBUGCONSOLE_REDIRECT_TO_SDK))
+#ifdef	R01LIB_CONSOLE_NON_BLOCKING
+#define printf	console_printf
+#define putchar	console_putchar
+#else
 #define printf	DbgConsole_Printf
-#define scanf	DbgConsole_Scanf
 #define putchar	DbgConsole_Putchar
+#endif
+#define scanf	DbgConsole_Scanf
 #define getchar	DbgConsole_Getchar
 #else
 #define		SEMIHOST_OPERATION
@@ -36,5 +41,10 @@ extern "C" {
 #include	"InterruptIn.h"
 #include	"BusInOut.h"
 #include	"mcu.h"
+#include	"RingBuffer.h"
+#include	"CRC.h"
+#include	"COBS.h"
+#include	"Console.h"
+#include	"SPIBus.h"
 
 #endif // R01LIB_R01LIB_H
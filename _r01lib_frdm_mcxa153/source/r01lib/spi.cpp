@@ -28,7 +28,7 @@ extern "C" {
 #define EXAMPLE_SPI_MASTER_SOURCE_CLOCK kCLOCK_BusClk
 #define EXAMPLE_SPI_MASTER_CLK_FREQ     CLOCK_GetFreq( kCLOCK_BusClk )
 
-SPI::SPI( int mosi, int miso, int sclk, int cs ) : Obj( true ), chip_select( cs )
+SPI::SPI( int mosi, int miso, int sclk, int cs ) : Obj( true ), last_status( kStatus_Success ), chip_select( cs ), xfer_busy( false ), cbf_xfer_done( nullptr )
 {
 	unit_base			= EXAMPLE_SPI_MASTER;
 	master_clk_freq		= EXAMPLE_SPI_MASTER_CLK_FREQ;
@@ -94,6 +94,28 @@ status_t SPI::write( uint8_t *wp, uint8_t *rp, int length )
 	return status;
 }
 
+status_t SPI::write_nonblocking( uint8_t *wp, uint8_t *rp, int length, spi_callback_fp_t callback )
+{
+	//	no transactional driver for this MCU: transfer is done in blocking manner and callback is called after that
+
+	last_status	= write( wp, rp, length );
+	
+	if ( callback )
+		callback( last_status );
+
+	return kStatus_Success;
+}
+
+bool SPI::busy( void )
+{
+	return false;
+}
+
+status_t SPI::wait_transfer_complete( void )
+{
+	return last_status;
+}
+
 
 #else	//	CPU_MCXC444VLH
 
@@ -138,7 +160,7 @@ status_t SPI::write( uint8_t *wp, uint8_t *rp, int length )
 	#error Not supported CPU
 #endif
 
-SPI::SPI( int mosi, int miso, int sclk, int cs ) : Obj( true )
+SPI::SPI( int mosi, int miso, int sclk, int cs ) : Obj( true ), last_status( kStatus_Success ), hw_owner( true ), xfer_busy( false ), cbf_xfer_done( nullptr )
 {
 #ifdef	CPU_MCXN947VDF
 #elif	CPU_MCXN236VDF
@@ -186,6 +208,7 @@ SPI::SPI( int mosi, int miso, int sclk, int cs ) : Obj( true )
 	masterConfig.betweenTransferDelayInNanoSec	= 1000000000U / (masterConfig.baudRate * 2U);
 
 	LPSPI_MasterInit( unit_base, &masterConfig, master_clk_freq );
+	LPSPI_MasterTransferCreateHandle( unit_base, &handle, xfer_done_cb, this );
 
 	frequency( SPI_FREQ );
 	mode( 0 );
@@ -207,9 +230,23 @@ SPI::SPI( int mosi, int miso, int sclk, int cs ) : Obj( true )
 #pragma GCC diagnostic pop
 }
 
+SPI::SPI( SPI *spi ) : Obj( true ), last_status( kStatus_Success ), hw_owner( false ), 
+	unit_base( nullptr ), master_clk_freq( 0 ), master_pcs_4_xfer( 0 ), 
+	xfer_busy( false ), cbf_xfer_done( nullptr )
+{
+	if ( !spi )		//	no hardware (e.g. device simulator)
+		return;
+
+	masterConfig		= spi->masterConfig;
+	unit_base			= spi->unit_base;
+	master_clk_freq		= spi->master_clk_freq;
+	master_pcs_4_xfer	= spi->master_pcs_4_xfer;
+}
+
 SPI::~SPI()
 {
-	LPSPI_Deinit( unit_base );
+	if ( hw_owner )
+		LPSPI_Deinit( unit_base );
 }
 
 void SPI::frequency( uint32_t frequency )
@@ -220,8 +257,7 @@ void SPI::frequency( uint32_t frequency )
 	masterConfig.lastSckToPcsDelayInNanoSec    = 1000000000U / (masterConfig.baudRate * 2U);
 	masterConfig.betweenTransferDelayInNanoSec = 1000000000U / (masterConfig.baudRate * 2U);
 
-	LPSPI_Deinit( unit_base );
-	LPSPI_MasterInit( unit_base, &masterConfig, master_clk_freq );
+	profile( make_profile( frequency, (masterConfig.cpol << 1) | masterConfig.cpha ) );
 }
 
 void SPI::mode( uint8_t mode )
@@ -229,8 +265,73 @@ void SPI::mode( uint8_t mode )
 	masterConfig.cpol	= (lpspi_clock_polarity_t)((mode >> 1) & 0x1);
 	masterConfig.cpha	= (lpspi_clock_phase_t   )((mode >> 0) & 0x1);
 
-	LPSPI_Deinit( unit_base );
-	LPSPI_MasterInit( unit_base, &masterConfig, master_clk_freq );	
+	profile( make_profile( masterConfig.baudRate, mode ) );
+}
+
+SPI::profile_t SPI::make_profile( uint32_t frequency, uint8_t mode )
+{
+	//	same calculation as LPSPI_MasterSetBaudRate() and LPSPI_MasterSetDelayTimes() in SDK
+	//	delays are set to half of SCLK period
+
+	uint32_t	best_prescaler	= 7;
+	uint32_t	best_scaler		= 255;
+	uint32_t	min_diff		= 0xFFFFFFFF;
+
+	for ( uint32_t prescaler = 0; (prescaler < 8) && min_diff; prescaler++ )
+	{
+		for ( uint32_t scaler = 0; (scaler < 256) && min_diff; scaler++ )
+		{
+			uint32_t	real	= master_clk_freq / ((1U << prescaler) * (scaler + 2));
+
+			if ( (real <= frequency) && (frequency - real < min_diff) )
+			{
+				min_diff		= frequency - real;
+				best_prescaler	= prescaler;
+				best_scaler		= scaler;
+			}
+		}
+	}
+
+	uint32_t	clock		= master_clk_freq >> best_prescaler;
+	uint32_t	delay_ns	= 1000000000U / (frequency * 2U);
+	uint32_t	sck_delay	= delay_scaler( delay_ns, clock, 1 );
+	uint32_t	xfer_delay	= delay_scaler( delay_ns, clock, 2 );
+
+	profile_t	p;
+
+	p.ccr	= LPSPI_CCR_SCKDIV( best_scaler ) | LPSPI_CCR_DBT( xfer_delay ) | LPSPI_CCR_PCSSCK( sck_delay ) | LPSPI_CCR_SCKPCS( sck_delay );
+	p.tcr	= LPSPI_TCR_CPOL( (mode >> 1) & 0x1 ) | LPSPI_TCR_CPHA( mode & 0x1 ) |
+			  LPSPI_TCR_LSBF( masterConfig.direction ) | LPSPI_TCR_FRAMESZ( masterConfig.bitsPerFrame - 1U ) |
+			  LPSPI_TCR_PRESCALE( best_prescaler ) | LPSPI_TCR_PCS( masterConfig.whichPcs );
+
+	return p;
+}
+
+void SPI::profile( const profile_t &p )
+{
+	while ( !acquire() )
+		;
+
+	//	CCR can be written only while module is disabled
+
+	LPSPI_Enable( unit_base, false );
+	unit_base->CCR	= p.ccr;
+	unit_base->TCR	= p.tcr;
+	LPSPI_Enable( unit_base, true );
+
+	xfer_busy	= false;	
+}
+
+uint32_t SPI::delay_scaler( uint32_t delay_ns, uint32_t clock, uint32_t min_cycles )
+{
+	//	smallest scaler giving delay not less than delay_ns. delay is (scaler + min_cycles) clocks
+
+	uint64_t	cycles	= ((uint64_t)delay_ns * clock + 999999999U) / 1000000000U;
+
+	if ( cycles <= min_cycles )
+		return 0;
+
+	return std::min( cycles - min_cycles, (uint64_t)255 );
 }
 
 status_t SPI::write( uint8_t *wp, uint8_t *rp, int length )
@@ -242,7 +343,80 @@ status_t SPI::write( uint8_t *wp, uint8_t *rp, int length )
 	masterXfer.dataSize		= length;
 	masterXfer.configFlags	= master_pcs_4_xfer | kLPSPI_MasterPcsContinuous | kLPSPI_MasterByteSwap;
 
-	return LPSPI_MasterTransferBlocking( unit_base, &masterXfer );
+	while ( !acquire() )
+	{
+		if ( __get_IPSR() )		//	in interrupt context, bus owner cannot proceed while waiting
+			return kStatus_LPSPI_Busy;
+	}
+
+	status_t	status	= LPSPI_MasterTransferBlocking( unit_base, &masterXfer );
+	xfer_busy	= false;
+
+	return status;
+}
+
+status_t SPI::write_nonblocking( uint8_t *wp, uint8_t *rp, int length, spi_callback_fp_t callback )
+{
+	while ( !acquire() )
+	{
+		if ( __get_IPSR() )		//	in interrupt context, bus owner cannot proceed while waiting
+			return kStatus_LPSPI_Busy;
+	}
+
+	xfer.txData			= wp;
+	xfer.rxData			= rp;
+	xfer.dataSize		= length;
+	xfer.configFlags	= master_pcs_4_xfer | kLPSPI_MasterPcsContinuous | kLPSPI_MasterByteSwap;
+
+	cbf_xfer_done	= callback;
+
+	status_t	status	= LPSPI_MasterTransferNonBlocking( unit_base, &handle, &xfer );
+	
+	if ( kStatus_Success != status )
+	{
+		xfer_busy	= false;
+		last_status	= status;
+	}
+
+	return status;
+}
+
+bool SPI::busy( void )
+{
+	return xfer_busy;
+}
+
+status_t SPI::wait_transfer_complete( void )
+{
+	while ( xfer_busy )
+		;
+
+	return last_status;
+}
+
+bool SPI::acquire( void )
+{
+	uint32_t	primask	= DisableGlobalIRQ();
+	bool		got		= !xfer_busy;
+
+	xfer_busy	= true;
+	EnableGlobalIRQ( primask );
+
+	return got;
+}
+
+void SPI::xfer_done_cb( LPSPI_Type *base, lpspi_master_handle_t *handle, status_t status, void *userData )
+{
+	SPI	*spi_ptr	= (SPI *)userData;
+	
+	spi_callback_fp_t	cb	= std::move( spi_ptr->cbf_xfer_done );	//	callback may start next transfer
+	
+	spi_ptr->cbf_xfer_done	= nullptr;
+	spi_ptr->last_status	= status;
+	spi_ptr->xfer_busy		= false;
+
+	if ( cb )
+		cb( status );
 }
 
 #endif // CPU_MCXC444VLH
@@ -17,9 +17,14 @@ extern "C" {
 
 #include	"spi.h"
 #include	"io.h"
+#include	"Delegate.h"
+
+#include	<algorithm>
 
 #define	SPI_FREQ		1'000'000UL
 
+using	spi_callback_fp_t	= Delegate<void(status_t)>;
+
 
 /** SPI class
  *	
@@ -62,17 +67,83 @@ public:
 	 */
 	virtual void	mode( uint8_t mode = 0 );
 
+#ifndef	CPU_MCXC444VLH
+	/** LPSPI register values for a frequency and mode setting */
+	typedef struct	_profile	{
+		uint32_t	ccr;
+		uint32_t	tcr;
+	} profile_t;
+
+	/** Calculate register values for frequency and mode
+	 *
+	 *	No register access. The result can be kept and applied by profile() later
+	 *
+	 * @param frequency SCLK frequency
+	 * @param mode selecting mode 0~3
+	 * @return register values
+	 */
+	profile_t				make_profile( uint32_t frequency, uint8_t mode );
+
+	/** Apply register values
+	 *
+	 *	Switches frequency and mode by few register writes, without re-initializing LPSPI
+	 *
+	 * @param p register values given by make_profile()
+	 */
+	void					profile( const profile_t &p );
+#endif
+
 	/** Data transfer on SPI
 	 *  
 	 * @param wp data to write
 	 * @param rp data buffer for read
 	 * @param length transfer length
+	 * @return kStatus_Success if done. kStatus_LPSPI_Busy if called from interrupt while non-blocking transfer is in progress.
+	 *	Waiting in interrupt would never end because completion interrupt cannot preempt the caller
 	 */	
 	virtual status_t		write( uint8_t *wp, uint8_t *rp, int length );
 
+	/** Non-blocking data transfer on SPI
+	 *
+	 *	Starts transfer and returns immediately. The transfer is processed by LPSPI FIFO interrupt.
+	 *	Buffers must be kept until the transfer completes.
+	 *  
+	 * @param wp data to write
+	 * @param rp data buffer for read
+	 * @param length transfer length
+	 * @param callback (option) function called in interrupt context when the transfer completes
+	 * @return kStatus_Success if the transfer started. kStatus_LPSPI_Busy if called from interrupt while bus is in use
+	 */	
+	virtual status_t		write_nonblocking( uint8_t *wp, uint8_t *rp, int length, spi_callback_fp_t callback = nullptr );
+
+	/** Check transfer status
+	 *  
+	 * @return true if non-blocking transfer is in progress
+	 */	
+	bool					busy( void );
+
+	/** Wait non-blocking transfer completion
+	 *  
+	 * @return status of last completed transfer
+	 */	
+	status_t				wait_transfer_complete( void );
+
 	/** variable for reporting last state */
 	status_t				last_status;
 
+#ifndef	CPU_MCXC444VLH
+protected:
+	/** Create a SPI instance which shares the LPSPI of "spi" without initializing it
+	 *	Used by classes which route transfers of multiple devices (e.g. SPIBus::Device)
+	 *
+	 * @param spi pointer to SPI instance owning the hardware. nullptr for the class which has no hardware
+	 */
+	SPI( SPI *spi );
+
+	bool					hw_owner;
+#endif
+
+
 #ifdef	CPU_MCXC444VLH
 protected:
 	DigitalOut				chip_select;
@@ -80,12 +151,22 @@ private:
 	spi_master_config_t		masterConfig;
 	SPI_Type				*unit_base;
 #else
+protected:
 	lpspi_master_config_t	masterConfig;
 	LPSPI_Type				*unit_base;
+	lpspi_master_handle_t	handle;
+	lpspi_transfer_t		xfer;
+
+	static void				xfer_done_cb( LPSPI_Type *base, lpspi_master_handle_t *handle, status_t status, void *userData );
+	bool					acquire( void );
+	static uint32_t			delay_scaler( uint32_t delay_ns, uint32_t clock, uint32_t min_cycles );
 #endif
 	
 	uint32_t				master_clk_freq;
 	uint32_t				master_pcs_4_xfer;
+
+	volatile bool			xfer_busy;
+	spi_callback_fp_t		cbf_xfer_done;
 };
 
 #endif // R01LIB_SPI_H
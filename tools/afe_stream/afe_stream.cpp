@@ -0,0 +1,108 @@
+/** Host side decoder for SampleStream packets
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2026 Tedd OKANO
+ *  Released under the MIT license
+ */
+
+#include	"afe_stream.h"
+#include	"COBS.h"
+#include	"CRC.h"
+
+StreamDecoder::StreamDecoder( callback_t cb_ )
+	: packets( 0 ), crc_errors( 0 ), format_errors( 0 ), lost( 0 ),
+	  cb( cb_ ), length( 0 ), overflow( false ), synced( false ), seq_valid( false ), last_seq( 0 )
+{
+}
+
+int StreamDecoder::feed( const uint8_t *data, size_t n )
+{
+	int	count	= 0;
+
+	for ( size_t i = 0; i < n; i++ )
+	{
+		uint8_t	b	= data[ i ];
+
+		if ( b )
+		{
+			if ( length < (int)sizeof( buffer ) )
+				buffer[ length++ ]	= b;
+			else
+				overflow	= true;
+
+			continue;
+		}
+
+		//	delimiter: first frame is dropped because it may be a partial one
+
+		if ( synced && length )
+		{
+			packet_t	p;
+
+			if ( !overflow && !decode( buffer, length, p ) )
+			{
+				if ( seq_valid )
+					lost	+= (uint16_t)(p.packet_sequence - last_seq - 1);
+
+				last_seq	= p.packet_sequence;
+				seq_valid	= true;
+
+				packets++;
+				count++;
+
+				if ( cb )
+					cb( p );
+			}
+			else if ( overflow )
+			{
+				format_errors++;
+			}
+		}
+
+		synced		= true;
+		length		= 0;
+		overflow	= false;
+	}
+
+	return count;
+}
+
+int StreamDecoder::decode( const uint8_t *frame, int frame_length, packet_t &packet )
+{
+	uint8_t	p[ sizeof( buffer ) ];
+	int		n	= cobs_decode( frame, frame_length, p );
+
+	if ( (n < header_length + 2) || (version != p[ 0 ]) || (max_samples < p[ 1 ]) || (n != header_length + 3 * p[ 1 ] + 2) )
+	{
+		format_errors++;
+		return -1;
+	}
+
+	if ( crc16( p, n - 2 ) != (p[ n - 2 ] | (p[ n - 1 ] << 8)) )
+	{
+		crc_errors++;
+		return -1;
+	}
+
+	auto	get	= [ & ]( int offset, int size )
+	{
+		uint32_t	v	= 0;
+
+		while ( size-- )
+			v	= (v << 8) | p[ offset + size ];
+
+		return v;
+	};
+
+	packet.count			= p[ 1 ];
+	packet.packet_sequence	= get( 2, 2 );
+	packet.sequence			= get( 4, 4 );
+	packet.timestamp		= get( 8, 4 );
+	packet.mask				= get( 12, 2 );
+
+	for ( auto i = 0; i < packet.count; i++ )
+		packet.data[ i ]	= ((int32_t)(get( header_length + 3 * i, 3 ) << 8)) >> 8;
+
+	return 0;
+}
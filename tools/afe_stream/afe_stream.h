@@ -0,0 +1,70 @@
+/** Host side decoder for SampleStream packets
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2026 Tedd OKANO
+ *  Released under the MIT license
+ *
+ *  Decodes the byte stream sent by SampleStream class (r01device/afe/SampleStream.h).
+ *  Bytes are given by feed() in any size. Each complete and valid packet is passed to a callback.
+ */
+
+#ifndef AFE_STREAM_H
+#define AFE_STREAM_H
+
+#include	<stdint.h>
+#include	<stddef.h>
+#include	<functional>
+
+class StreamDecoder
+{
+public:
+	static constexpr uint8_t	version			= 1;
+	static constexpr int		header_length	= 14;
+	static constexpr int		max_samples		= 16;
+	static constexpr int		max_packet		= header_length + 3 * max_samples + 2;
+
+	/** Decoded packet */
+	typedef struct	_packet	{
+		uint16_t	packet_sequence;
+		uint32_t	sequence;		//	frame sequence (DRDY count)
+		uint32_t	timestamp;		//	micro-second
+		uint16_t	mask;			//	logical channels
+		int			count;			//	number of samples
+		int32_t		data[ max_samples ];
+	} packet_t;
+
+	using callback_t	= std::function<void( const packet_t & )>;
+
+	StreamDecoder( callback_t cb );
+
+	/** Give received bytes
+	 *
+	 * @param data received bytes
+	 * @param length number of bytes
+	 * @return number of packets decoded
+	 */
+	int			feed( const uint8_t *data, size_t length );
+
+	/** Decode a frame (COBS encoded, without delimiter)
+	 *
+	 * @return 0 if valid, -1 if not
+	 */
+	int			decode( const uint8_t *frame, int length, packet_t &packet );
+
+	uint32_t	packets;		//	valid packets
+	uint32_t	crc_errors;		//	packets with CRC mismatch
+	uint32_t	format_errors;	//	broken COBS, length or version
+	uint32_t	lost;			//	gaps in packet sequence number
+
+private:
+	callback_t	cb;
+	uint8_t		buffer[ max_packet + max_packet / 254 + 2 ];
+	int			length;
+	bool		overflow;
+	bool		synced;
+	bool		seq_valid;
+	uint16_t	last_seq;
+};
+
+#endif //	AFE_STREAM_H
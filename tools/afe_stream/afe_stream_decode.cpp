@@ -0,0 +1,154 @@
+/** SampleStream to CSV converter
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2026 Tedd OKANO
+ *  Released under the MIT license
+ *
+ *  Reads packets from a serial port (or stdin) and writes CSV to stdout.
+ *  Statistics are shown on stderr at exit (EOF or Ctrl-C).
+ *
+ *	build:
+ *		g++ -std=c++17 -O2 -I../../_r01lib_frdm_mcxa153/source/r01lib afe_stream.cpp afe_stream_decode.cpp -o afe_stream_decode
+ *
+ *	usage:
+ *		afe_stream_decode [-b baud] [device]
+ *		afe_stream_decode -b 921600 /dev/ttyACM0 > log.csv
+ *
+ *	CSV columns: packet sequence, frame sequence, timestamp [us], then ADC code of each logical channel.
+ *	Header line is written at start and each time the channel mask changes.
+ */
+
+#include	<stdio.h>
+#include	<stdlib.h>
+#include	<string.h>
+#include	<signal.h>
+#include	<fcntl.h>
+#include	<unistd.h>
+#include	<termios.h>
+#include	"afe_stream.h"
+
+static volatile sig_atomic_t	stop	= 0;
+
+static speed_t baud_constant( long baud )
+{
+	switch ( baud )
+	{
+		case 9600:		return B9600;
+		case 19200:		return B19200;
+		case 38400:		return B38400;
+		case 57600:		return B57600;
+		case 115200:	return B115200;
+		case 230400:	return B230400;
+		case 460800:	return B460800;
+		case 921600:	return B921600;
+		case 1000000:	return B1000000;
+		case 2000000:	return B2000000;
+		default:		return 0;
+	}
+}
+
+static int open_port( const char *path, long baud )
+{
+	int	fd	= open( path, O_RDONLY | O_NOCTTY );
+
+	if ( fd < 0 )
+		return -1;
+
+	struct termios	t;
+
+	if ( !tcgetattr( fd, &t ) )
+	{
+		speed_t	s	= baud_constant( baud );
+
+		cfmakeraw( &t );
+		t.c_cc[ VMIN ]	= 1;
+		t.c_cc[ VTIME ]	= 0;
+
+		if ( s )
+		{
+			cfsetispeed( &t, s );
+			cfsetospeed( &t, s );
+		}
+
+		tcsetattr( fd, TCSANOW, &t );
+	}
+
+	return fd;
+}
+
+int main( int argc, char *argv[] )
+{
+	long		baud	= 115200;
+	const char	*path	= nullptr;
+	int			opt;
+
+	while ( -1 != (opt = getopt( argc, argv, "b:" )) )
+	{
+		switch ( opt )
+		{
+			case 'b':
+				baud	= strtol( optarg, nullptr, 0 );
+				break;
+			default:
+				fprintf( stderr, "usage: %s [-b baud] [device]\n", argv[ 0 ] );
+				return 1;
+		}
+	}
+
+	if ( optind < argc )
+		path	= argv[ optind ];
+
+	int	fd	= path ? open_port( path, baud ) : STDIN_FILENO;
+
+	if ( fd < 0 )
+	{
+		perror( path );
+		return 1;
+	}
+
+	if ( path && !baud_constant( baud ) )
+		fprintf( stderr, "baud rate %ld is not supported, port setting is kept\n", baud );
+
+	//	no SA_RESTART, so Ctrl-C breaks blocking read()
+
+	struct sigaction	sa	= {};
+
+	sa.sa_handler	= []( int ) { stop = 1; };
+	sigaction( SIGINT, &sa, nullptr );
+
+	int		last_mask	= -1;
+
+	StreamDecoder	decoder( [ & ]( const StreamDecoder::packet_t &p )
+	{
+		if ( p.mask != last_mask )
+		{
+			printf( "packet,sequence,timestamp_us" );
+
+			for ( auto ch = 0; ch < 16; ch++ )
+				if ( p.mask & (1 << ch) )
+					printf( ",ch%d", ch );
+
+			printf( "\n" );
+			last_mask	= p.mask;
+		}
+
+		printf( "%u,%u,%u", p.packet_sequence, p.sequence, p.timestamp );
+
+		for ( auto i = 0; i < p.count; i++ )
+			printf( ",%d", p.data[ i ] );
+
+		printf( "\n" );
+	} );
+
+	uint8_t	buf[ 4096 ];
+	ssize_t	n;
+
+	while ( !stop && (0 < (n = read( fd, buf, sizeof( buf ) ))) )
+		decoder.feed( buf, n );
+
+	fflush( stdout );
+	fprintf( stderr, "packets: %u, lost: %u, CRC errors: %u, format errors: %u\n", decoder.packets, decoder.lost, decoder.crc_errors, decoder.format_errors );
+
+	return 0;
+}
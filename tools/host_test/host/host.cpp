@@ -0,0 +1,324 @@
+/** Host build of r01lib and AFE drivers
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2026 Tedd OKANO
+ *  Released under the MIT license
+ *
+ *  Virtual time, interrupt simulation and MCU functions (mcu.h)
+ */
+
+#include	"host.h"
+#include	"r01lib.h"
+#include	<stdio.h>
+#include	<stdlib.h>
+#include	<unistd.h>
+#include	<algorithm>
+
+extern "C" {
+#include	"board.h"
+#include	"clock_config.h"
+#include	"fsl_lpuart.h"
+#include	"fsl_utick.h"
+}
+
+UTICK_Type	host_utick0;
+
+namespace host
+{
+	typedef struct	_pending	{
+		IRQn_Type					irq;
+		std::function<void(void)>	handler;
+		int							delay;
+	} pending_t;
+
+	static uint64_t					time_us		= 0;
+	static uint32_t					ipsr		= 0;
+	static uint32_t					primask		= 0;
+	static uint32_t					points		= 0;
+	static std::vector<pending_t>	pendings;
+
+	static utick_callback_t			utick_cb	= nullptr;
+	static uint64_t					utick_next	= 0;	//	time of next tick in micro-second
+
+	void reset_io( void );
+	static void enable_point( void );
+
+	void reset( void )
+	{
+		time_us	= 0;
+		ipsr	= 0;
+		primask	= 0;
+		points	= 0;
+		pendings.clear();
+		host_utick0.CTRL	= 0;
+		host_utick0.STAT	= 0;
+		utick_cb			= nullptr;
+		reset_io();
+		lpspi::reset();
+		lpi2c::reset();
+		console::fd	= STDOUT_FILENO;
+	}
+
+	uint64_t now_us( void )
+	{
+		return time_us;
+	}
+
+	void run_isr( IRQn_Type irq, std::function<void(void)> handler )
+	{
+		uint32_t	saved_ipsr		= ipsr;
+		uint32_t	saved_primask	= primask;
+
+		ipsr	= irq + 16;
+		primask	= 0;
+		handler();
+		ipsr	= saved_ipsr;
+		primask	= saved_primask;
+
+		//	return to unmasked thread mode takes pending interrupts (tail-chaining)
+
+		if ( !ipsr && !primask )
+			enable_point();
+	}
+
+	void pend( IRQn_Type irq, std::function<void(void)> handler, int delay )
+	{
+		pendings.push_back( { irq, handler, delay } );
+	}
+
+	static void run_pending( std::function<bool( pending_t & )> due )
+	{
+		//	handlers may make new pending ones. Those are not served in this call
+
+		std::vector<pending_t>	list;
+
+		list.swap( pendings );
+
+		for ( auto &p : list )
+		{
+			if ( due( p ) )
+				run_isr( p.irq, p.handler );
+			else
+				pendings.push_back( p );
+		}
+	}
+
+	int service( IRQn_Type irq )
+	{
+		int	n	= 0;
+
+		run_pending( [ & ]( pending_t &p ) { return (p.irq == irq) && ++n; } );
+
+		return n;
+	}
+
+	int pending( void )
+	{
+		return pendings.size();
+	}
+
+	uint32_t enable_points( void )
+	{
+		return points;
+	}
+
+	static void enable_point( void )
+	{
+		points++;
+		run_pending( []( pending_t &p ) { return (0 <= p.delay) && (0 == p.delay--); } );
+	}
+
+	/** Run UTICK interrupts due until the time. A tick missed while masked is taken once */
+	static void utick_run( uint64_t end )
+	{
+		while ( !ipsr && !primask )
+		{
+			uint32_t	delay	= host_utick0.CTRL & UTICK_CTRL_DELAYVAL_MASK;
+
+			if ( !delay || (end < utick_next) )
+				break;
+
+			time_us	= std::max( time_us, utick_next );
+
+			if ( host_utick0.CTRL & UTICK_CTRL_REPEAT_MASK )
+				utick_next	= std::max( utick_next + delay + 1, time_us + 1 );
+			else
+				host_utick0.CTRL	= 0;
+
+			host_utick0.STAT	= host_utick0.CTRL ? UTICK_STAT_ACTIVE_MASK : 0;
+
+			if ( utick_cb )
+				run_isr( UTICK0_IRQn, utick_cb );
+		}
+	}
+
+	void advance( double sec )
+	{
+		uint64_t	end	= time_us + (uint64_t)(sec * 1e6 + 0.5);
+
+		utick_run( end );
+		time_us	= std::max( time_us, end );
+
+		if ( !ipsr )
+			run_pending( []( pending_t &p ) { return 0 <= p.delay; } );
+	}
+
+	namespace console
+	{
+		int	fd	= STDOUT_FILENO;
+	}
+}
+
+/* SDK functions ******************************************/
+
+extern "C" {
+
+uint32_t DisableGlobalIRQ( void )
+{
+	uint32_t	m	= host::primask;
+
+	host::primask	= 1;
+	return m;
+}
+
+void EnableGlobalIRQ( uint32_t m )
+{
+	host::primask	= m;
+
+	if ( !m && !host::ipsr )
+		host::enable_point();
+}
+
+uint32_t __get_IPSR( void )
+{
+	return host::ipsr;
+}
+
+uint32_t __get_PRIMASK( void )
+{
+	return host::primask;
+}
+
+status_t EnableIRQ( IRQn_Type )
+{
+	return kStatus_Success;
+}
+
+status_t DisableIRQ( IRQn_Type )
+{
+	return kStatus_Success;
+}
+
+void NVIC_SetPriority( IRQn_Type, uint32_t )
+{
+}
+
+uint32_t CLOCK_GetLpspiClkFreq( uint32_t )
+{
+	return 12000000;	//	FRO12M
+}
+
+void UTICK_Init( UTICK_Type *base )
+{
+	base->CTRL	= 0;
+	base->STAT	= 0;
+}
+
+void UTICK_SetTick( UTICK_Type *base, utick_mode_t mode, uint32_t count, utick_callback_t cb )
+{
+	//	1 MHz tick: interrupt comes "count + 1" micro-seconds later
+
+	host::utick_cb		= cb;
+	host::utick_next	= host::time_us + count + 1;
+	base->CTRL			= (count & UTICK_CTRL_DELAYVAL_MASK) | ((kUTICK_Repeat == mode) ? UTICK_CTRL_REPEAT_MASK : 0);
+	base->STAT			= UTICK_STAT_ACTIVE_MASK;
+}
+
+void UTICK_ClearStatusFlags( UTICK_Type *base )
+{
+	base->STAT	&= ~UTICK_STAT_INTR_MASK;
+}
+
+uint32_t CLOCK_GetLpi2cClkFreq( void )
+{
+	return 12000000;	//	FRO12M
+}
+
+void RESET_ReleasePeripheralReset( int )
+{
+}
+
+status_t LPUART_SetBaudRate( LPUART_Type *, uint32_t, uint32_t )
+{
+	return kStatus_Success;
+}
+
+}
+
+/* mcu.h ******************************************/
+
+void init_mcu( void )
+{
+}
+
+void wait( double delayTime_sec )
+{
+	host::advance( delayTime_sec );
+}
+
+void wait_ms( unsigned int milloseconds )
+{
+	wait( (double)milloseconds * 1e-3 );
+}
+
+void wait_us( unsigned int microseconds )
+{
+	wait( (double)microseconds * 1e-6 );
+}
+
+uint32_t us_ticker_read( void )
+{
+	return (uint32_t)host::now_us();
+}
+
+void wait_sleep( double delayTime_sec )
+{
+	wait( delayTime_sec );
+}
+
+bool wait_flag( volatile bool &flag, double timeout_sec )
+{
+	//	time advances in 1 micro-second steps to let pending interrupts set the flag
+
+	for ( uint64_t end = host::now_us() + (uint64_t)(timeout_sec * 1e6); !flag && (host::now_us() < end); )
+		wait( 1e-6 );
+
+	return flag;
+}
+
+void panic( const char *s )
+{
+	fprintf( stderr, "panic: %s\n", s );
+	abort();
+}
+
+/* Console ******************************************/
+
+int Console::write( const uint8_t *data, int length )
+{
+	if ( host::console::fd < 0 )
+		return length;
+
+	for ( int done = 0; done < length; )
+	{
+		ssize_t	n	= ::write( host::console::fd, data + done, length - done );
+
+		if ( n <= 0 )
+			return 0;
+
+		done	+= n;
+	}
+
+	return length;
+}
@@ -0,0 +1,142 @@
+/** Host build of r01lib and AFE drivers
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2026 Tedd OKANO
+ *  Released under the MIT license
+ *
+ *  Replaces MCU hardware with a deterministic model to run library code on Linux.
+ *
+ *	- Time is virtual. It advances only by wait*() calls or host::advance()
+ *	- Interrupts are simulated. A handler runs with __get_IPSR() != 0.
+ *	  Pending handlers run at "interrupt enable points": EnableGlobalIRQ() back to unmasked state in thread mode,
+ *	  return from a handler to unmasked thread mode, or while time advances
+ *	- GPIO levels are kept per pin number. host::edge() drives an input and calls InterruptIn callback
+ *	- LPSPI transfers are served by a mock. Completion interrupt of non-blocking transfer is pending
+ *	  until given latency (in interrupt enable points) passes, or until host::lpspi::complete() is called
+ *	- UTICK (Ticker) runs on virtual time. Its interrupt runs at each tick time passed by wait*() or host::advance()
+ *	  in unmasked thread mode, in time order
+ *	- LPI2C transfers are blocking and served by a target model given to host::lpi2c::device
+ */
+
+#ifndef HOST_HOST_H
+#define HOST_HOST_H
+
+#include	<stdint.h>
+#include	<stddef.h>
+#include	<vector>
+#include	<functional>
+
+extern "C" {
+#include	"fsl_common.h"
+}
+
+namespace host
+{
+	/** Reset time, pending interrupts, pins, LPSPI mock and console output */
+	void		reset( void );
+
+	/** Virtual time in micro-second */
+	uint64_t	now_us( void );
+
+	/** Advance virtual time. Pending interrupts are served */
+	void		advance( double sec );
+
+	/** Run an interrupt handler now
+	 *
+	 * @param irq IRQ number. __get_IPSR() returns irq + 16 while the handler runs
+	 * @param handler interrupt handler
+	 */
+	void		run_isr( IRQn_Type irq, std::function<void(void)> handler );
+
+	/** Make an interrupt pending
+	 *
+	 * @param irq IRQ number
+	 * @param handler interrupt handler
+	 * @param delay number of interrupt enable points to pass before the handler runs. -1 to run only by service( irq )
+	 */
+	void		pend( IRQn_Type irq, std::function<void(void)> handler, int delay = 0 );
+
+	/** Run pending handlers of the IRQ regardless of its delay
+	 *
+	 * @return number of handlers run
+	 */
+	int			service( IRQn_Type irq );
+
+	/** Number of pending handlers */
+	int			pending( void );
+
+	/** Number of interrupt enable points passed */
+	uint32_t	enable_points( void );
+
+	/** GPIO level of a pin */
+	bool		pin( int pin_num );
+
+	/** Drive an input pin and call InterruptIn callback for the edge in interrupt context */
+	void		edge( int pin_num, bool rise );
+
+	namespace lpspi
+	{
+		typedef struct	_transfer	{
+			std::vector<uint8_t>	tx;
+			uint32_t				ccr;
+			uint32_t				tcr;
+			uint32_t				flags;
+			bool					blocking;
+			int						tag;		//	free for on_start hook (e.g. which chip-select is active)
+		} transfer_t;
+
+		/** Transfers in started order */
+		extern std::vector<transfer_t>	log;
+
+		/** Called when a transfer starts */
+		extern std::function<void( transfer_t & )>	on_start;
+
+		/** Device response. Default is loopback (rx = tx) */
+		extern std::function<void( const uint8_t *tx, uint8_t *rx, size_t length )>	device;
+
+		/** Interrupt enable points before completion interrupt of non-blocking transfer. -1 for manual completion
+		 *
+		 *	End of LPSPI_MasterTransferNonBlocking() is the first point. 0 completes the transfer there if called in thread mode
+		 */
+		extern int			latency;
+
+		/** Number of following LPSPI_MasterTransferNonBlocking() calls to fail with kStatus_LPSPI_Busy */
+		extern int			fail_starts;
+
+		/** Number of LPSPI_Enable( false ) calls: register reconfigurations */
+		extern int			reconfigurations;
+
+		/** Non-blocking transfer is in progress */
+		bool		busy( void );
+
+		/** Run completion interrupt of non-blocking transfer now
+		 *
+		 * @param status status given to the callback
+		 * @return false if no transfer is in progress
+		 */
+		bool		complete( status_t status = kStatus_Success );
+
+		void		reset( void );
+	}
+
+	namespace lpi2c
+	{
+		/** Target model. Called with length 0 at START for address ACK, then with data of the transfer
+		 *
+		 *	Write gives all bytes after the address byte. Read fills the buffer.
+		 *	Return false to NACK. Default (nullptr) is no target on the bus
+		 */
+		extern std::function<bool( uint8_t address, bool read, uint8_t *data, size_t length )>	device;
+
+		void		reset( void );
+	}
+
+	namespace console
+	{
+		/** File descriptor for Console::write(). -1 to discard */
+		extern int	fd;
+	}
+}
+
+#endif	//	HOST_HOST_H
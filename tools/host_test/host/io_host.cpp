@@ -0,0 +1,170 @@
+/** Host build of r01lib and AFE drivers
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2026 Tedd OKANO
+ *  Released under the MIT license
+ *
+ *  GPIO (io.h) and InterruptIn on pin levels kept in memory
+ */
+
+#include	"host.h"
+#include	"r01lib.h"
+
+static constexpr int	n_pins	= 256;
+
+static bool				level[ n_pins ];
+static irq_callback_t	cb_rise[ n_pins ];
+static irq_callback_t	cb_fall[ n_pins ];
+
+namespace host
+{
+	void reset_io( void )
+	{
+		for ( auto i = 0; i < n_pins; i++ )
+		{
+			level[ i ]		= false;
+			cb_rise[ i ]	= nullptr;
+			cb_fall[ i ]	= nullptr;
+		}
+	}
+
+	bool pin( int pin_num )
+	{
+		return level[ pin_num ];
+	}
+
+	void edge( int pin_num, bool rise )
+	{
+		level[ pin_num ]	= rise;
+
+		irq_callback_t	cb	= rise ? cb_rise[ pin_num ] : cb_fall[ pin_num ];
+
+		if ( cb )
+			run_isr( 0, cb );
+	}
+}
+
+/* DigitalInOut class ******************************************/
+
+DigitalInOut::DigitalInOut( uint8_t pin_num, bool direction, bool v, int pin_mode )
+	: Obj( true ), _pn( pin_num ), gpio_n( nullptr ), port_n( nullptr ), gpio_pin( pin_num ), _dir( direction ), _value( v )
+{
+	mode( pin_mode );
+	value( (bool)_value );
+}
+
+DigitalInOut::~DigitalInOut(){}
+
+void DigitalInOut::value( bool value )
+{
+	if ( kGPIO_DigitalOutput == _dir )
+		level[ _pn ]	= value;
+
+	_value	= value;
+}
+
+bool DigitalInOut::value( void )
+{
+	if ( kGPIO_DigitalInput == _dir )
+		return level[ _pn ];
+	else
+		return _value;
+}
+
+void DigitalInOut::output( void )
+{
+	_dir	= OUTPUT;
+	direction( _dir );
+}
+
+void DigitalInOut::input( void )
+{
+	_dir	= INPUT;
+	direction( _dir );
+}
+
+void DigitalInOut::direction( bool dir )
+{
+	if ( kGPIO_DigitalOutput == dir )
+		level[ _pn ]	= _value;
+}
+
+void DigitalInOut::pin_mux( int )
+{
+}
+
+void DigitalInOut::mode( int )
+{
+}
+
+uint32_t DigitalInOut::mode( void )
+{
+	return 0;
+}
+
+DigitalInOut& DigitalInOut::operator=( bool v )
+{
+	value( v );
+	return *this;
+}
+
+DigitalInOut& DigitalInOut::operator=( DigitalInOut& )
+{
+	return *this;
+}
+
+DigitalInOut::operator bool()
+{
+	return value();
+}
+
+DigitalOut::DigitalOut( uint8_t pin_num, bool value, int pin_mode )
+	: DigitalInOut( pin_num, kGPIO_DigitalOutput, value, pin_mode )
+{
+}
+
+DigitalOut::~DigitalOut() {}
+
+DigitalIn::DigitalIn( uint8_t pin_num, int pin_mode )
+	: DigitalInOut( pin_num, kGPIO_DigitalInput, 0, pin_mode )
+{
+}
+
+DigitalIn::~DigitalIn() {}
+
+/* InterruptIn class ******************************************/
+
+InterruptIn::InterruptIn( uint8_t pin_num )
+	: DigitalIn( pin_num )
+{
+}
+
+InterruptIn::~InterruptIn()
+{
+	cb_rise[ _pn ]	= nullptr;
+	cb_fall[ _pn ]	= nullptr;
+}
+
+void InterruptIn::rise( irq_callback_t callback )
+{
+	regist( callback, kPORT_InterruptRisingEdge );
+}
+
+void InterruptIn::fall( irq_callback_t callback )
+{
+	regist( callback, kPORT_InterruptFallingEdge );
+}
+
+uint32_t InterruptIn::irq_entry_cycles( void )
+{
+	return 0;	//	no cycle counter
+}
+
+void InterruptIn::regist( irq_callback_t callback, port_interrupt_t type )
+{
+	if ( kPORT_InterruptRisingEdge == type )
+		cb_rise[ _pn ]	= callback;
+	else
+		cb_fall[ _pn ]	= callback;
+}
@@ -0,0 +1,125 @@
+/** Host build of r01lib and AFE drivers
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2026 Tedd OKANO
+ *  Released under the MIT license
+ *
+ *  LPI2C driver mock. Blocking transfers are given to a target model, NACK is returned as SDK driver does
+ */
+
+#include	"host.h"
+
+extern "C" {
+#include	"fsl_lpi2c.h"
+}
+
+LPI2C_Type	host_lpi2c0;
+
+namespace host
+{
+	namespace lpi2c
+	{
+		std::function<bool( uint8_t, bool, uint8_t *, size_t )>	device;
+
+		static uint8_t	target	= 0;
+		static bool		reading	= false;
+		static bool		acked	= false;
+
+		static status_t start( uint8_t address, lpi2c_direction_t dir )
+		{
+			target	= address;
+			reading	= (kLPI2C_Read == dir);
+			acked	= device && device( target, reading, nullptr, 0 );
+
+			return kStatus_Success;
+		}
+
+		void reset( void )
+		{
+			device	= nullptr;
+			target	= 0;
+			reading	= false;
+			acked	= false;
+		}
+	}
+}
+
+using namespace host::lpi2c;
+
+extern "C" {
+
+void LPI2C_MasterGetDefaultConfig( lpi2c_master_config_t *config )
+{
+	config->enableMaster	= true;
+	config->baudRate_Hz		= 100000;
+}
+
+void LPI2C_MasterInit( LPI2C_Type *base, const lpi2c_master_config_t *, uint32_t )
+{
+	base->MCR	= 1;
+}
+
+void LPI2C_MasterDeinit( LPI2C_Type *base )
+{
+	base->MCR	= 0;
+}
+
+void LPI2C_MasterSetBaudRate( LPI2C_Type *, uint32_t, uint32_t )
+{
+}
+
+status_t LPI2C_MasterStart( LPI2C_Type *, uint8_t address, lpi2c_direction_t dir )
+{
+	return start( address, dir );
+}
+
+status_t LPI2C_MasterRepeatedStart( LPI2C_Type *, uint8_t address, lpi2c_direction_t dir )
+{
+	return start( address, dir );
+}
+
+void LPI2C_MasterGetFifoCounts( LPI2C_Type *, size_t *rxCount, size_t *txCount )
+{
+	if ( rxCount )
+		*rxCount	= 0;
+
+	if ( txCount )
+		*txCount	= 0;
+}
+
+uint32_t LPI2C_MasterGetStatusFlags( LPI2C_Type * )
+{
+	return acked ? 0 : kLPI2C_MasterNackDetectFlag;
+}
+
+status_t LPI2C_MasterSend( LPI2C_Type *, void *txBuff, size_t txSize )
+{
+	if ( !acked || reading )
+		return kStatus_LPI2C_Nak;
+
+	if ( txSize && !device( target, false, (uint8_t *)txBuff, txSize ) )
+		return kStatus_LPI2C_Nak;
+
+	return kStatus_Success;
+}
+
+status_t LPI2C_MasterReceive( LPI2C_Type *, void *rxBuff, size_t rxSize )
+{
+	if ( !acked || !reading )
+		return kStatus_LPI2C_Nak;
+
+	if ( !device( target, true, (uint8_t *)rxBuff, rxSize ) )
+		return kStatus_LPI2C_Nak;
+
+	return kStatus_Success;
+}
+
+status_t LPI2C_MasterStop( LPI2C_Type * )
+{
+	acked	= false;
+
+	return kStatus_Success;
+}
+
+}
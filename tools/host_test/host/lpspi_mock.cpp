@@ -0,0 +1,188 @@
+/** Host build of r01lib and AFE drivers
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2026 Tedd OKANO
+ *  Released under the MIT license
+ *
+ *  LPSPI driver mock. Same return values as SDK driver for busy handle
+ */
+
+#include	"host.h"
+
+extern "C" {
+#include	"fsl_lpspi.h"
+}
+
+LPSPI_Type	host_lpspi1;
+
+namespace host
+{
+	namespace lpspi
+	{
+		std::vector<transfer_t>		log;
+		std::function<void( transfer_t & )>	on_start;
+		std::function<void( const uint8_t *, uint8_t *, size_t )>	device;
+		int		latency				= 0;
+		int		fail_starts			= 0;
+		int		reconfigurations	= 0;
+
+		static lpspi_master_handle_t	*active				= nullptr;
+		static status_t					completion_status	= kStatus_Success;
+
+		static void start( LPSPI_Type *base, const lpspi_transfer_t *t, bool blocking )
+		{
+			transfer_t	r;
+
+			r.tx.assign( t->txData, t->txData + t->dataSize );
+			r.ccr		= base->CCR;
+			r.tcr		= base->TCR;
+			r.flags		= t->configFlags;
+			r.blocking	= blocking;
+			r.tag		= -1;
+
+			if ( on_start )
+				on_start( r );
+
+			log.push_back( r );
+		}
+
+		static void transfer( const lpspi_transfer_t *t )
+		{
+			if ( !t->rxData )
+				return;
+
+			if ( device )
+				device( t->txData, t->rxData, t->dataSize );
+			else
+				memmove( t->rxData, t->txData, t->dataSize );
+		}
+
+		static void finish( void )
+		{
+			lpspi_master_handle_t	*h	= active;
+			status_t				s	= completion_status;
+
+			if ( !h )
+				return;
+
+			active				= nullptr;
+			completion_status	= kStatus_Success;
+
+			if ( kStatus_Success == s )
+				transfer( &h->xfer );
+
+			h->busy	= false;
+
+			if ( h->callback )
+				h->callback( LPSPI1, h, s, h->userData );
+		}
+
+		bool busy( void )
+		{
+			return nullptr != active;
+		}
+
+		bool complete( status_t status )
+		{
+			if ( !active )
+				return false;
+
+			completion_status	= status;
+			return 0 < host::service( LPSPI1_IRQn );
+		}
+
+		void reset( void )
+		{
+			log.clear();
+			on_start			= nullptr;
+			device				= nullptr;
+			latency				= 0;
+			fail_starts			= 0;
+			reconfigurations	= 0;
+			active				= nullptr;
+			completion_status	= kStatus_Success;
+		}
+	}
+}
+
+using namespace host::lpspi;
+
+extern "C" {
+
+void LPSPI_MasterGetDefaultConfig( lpspi_master_config_t *config )
+{
+	config->baudRate						= 500000;
+	config->bitsPerFrame					= 8;
+	config->cpol							= kLPSPI_ClockPolarityActiveHigh;
+	config->cpha							= kLPSPI_ClockPhaseFirstEdge;
+	config->direction						= kLPSPI_MsbFirst;
+	config->pcsToSckDelayInNanoSec			= 1000000000U / config->baudRate / 2U;
+	config->lastSckToPcsDelayInNanoSec		= 1000000000U / config->baudRate / 2U;
+	config->betweenTransferDelayInNanoSec	= 1000000000U / config->baudRate / 2U;
+	config->whichPcs						= kLPSPI_Pcs0;
+}
+
+void LPSPI_MasterInit( LPSPI_Type *base, const lpspi_master_config_t *, uint32_t )
+{
+	base->CR	= 1;
+}
+
+void LPSPI_Deinit( LPSPI_Type *base )
+{
+	base->CR	= 0;
+}
+
+void LPSPI_Enable( LPSPI_Type *base, bool enable )
+{
+	if ( !enable )
+		reconfigurations++;
+
+	base->CR	= enable;
+}
+
+void LPSPI_MasterTransferCreateHandle( LPSPI_Type *, lpspi_master_handle_t *handle, lpspi_master_transfer_callback_t callback, void *userData )
+{
+	handle->busy		= false;
+	handle->callback	= callback;
+	handle->userData	= userData;
+}
+
+status_t LPSPI_MasterTransferBlocking( LPSPI_Type *base, lpspi_transfer_t *transfer )
+{
+	if ( active )
+		return kStatus_LPSPI_Busy;
+
+	start( base, transfer, true );
+	host::lpspi::transfer( transfer );
+
+	return kStatus_Success;
+}
+
+status_t LPSPI_MasterTransferNonBlocking( LPSPI_Type *base, lpspi_master_handle_t *handle, lpspi_transfer_t *transfer )
+{
+	if ( handle->busy )
+		return kStatus_LPSPI_Busy;
+
+	if ( 0 < fail_starts )
+	{
+		fail_starts--;
+		return kStatus_LPSPI_Busy;
+	}
+
+	start( base, transfer, false );
+
+	handle->busy	= true;
+	handle->xfer	= *transfer;
+	active			= handle;
+
+	host::pend( LPSPI1_IRQn, finish, latency );
+
+	//	driver enables LPSPI interrupts at last: it is an interrupt enable point in thread mode
+
+	EnableGlobalIRQ( DisableGlobalIRQ() );
+
+	return kStatus_Success;
+}
+
+}
@@ -0,0 +1,17 @@
+/** Host build stub of MCUXpresso SDK header
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2026 Tedd OKANO
+ *  Released under the MIT license
+ */
+
+#ifndef HOST_BOARD_H
+#define HOST_BOARD_H
+
+#include	"fsl_common.h"
+
+#define	BOARD_DEBUG_UART_BASEADDR	((uint32_t)0x400B4000)
+#define	BOARD_DEBUG_UART_CLK_FREQ	12000000U
+
+#endif	//	HOST_BOARD_H
@@ -0,0 +1,29 @@
+/** Host build stub of MCUXpresso SDK header
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2026 Tedd OKANO
+ *  Released under the MIT license
+ */
+
+#ifndef HOST_CLOCK_CONFIG_H
+#define HOST_CLOCK_CONFIG_H
+
+#include	"fsl_common.h"
+
+#define	kLPSPI1_RST_SHIFT_RSTn		1
+#define	kLPI2C0_RST_SHIFT_RSTn		2
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+uint32_t	CLOCK_GetLpspiClkFreq( uint32_t index );
+uint32_t	CLOCK_GetLpi2cClkFreq( void );
+void		RESET_ReleasePeripheralReset( int peripheral );
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif	//	HOST_CLOCK_CONFIG_H
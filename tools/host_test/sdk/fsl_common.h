@@ -0,0 +1,63 @@
+/** Host build stub of MCUXpresso SDK header
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2026 Tedd OKANO
+ *  Released under the MIT license
+ *
+ *  Only the part used by r01lib and AFE drivers. Functions are implemented in host/ directory.
+ */
+
+#ifndef HOST_FSL_COMMON_H
+#define HOST_FSL_COMMON_H
+
+#include	<stdint.h>
+#include	<stdbool.h>
+#include	<stddef.h>
+#include	<string.h>
+#include	<assert.h>
+
+typedef int32_t		status_t;
+typedef int			IRQn_Type;
+
+#define	MAKE_STATUS( group, code )	((((group) * 100) + (code)))
+
+enum	{
+	kStatusGroup_Generic	= 0,
+	kStatusGroup_LPSPI		= 4,
+	kStatusGroup_LPI2C		= 5,
+	kStatusGroup_I3C		= 79,
+};
+
+enum	{
+	kStatus_Success					= MAKE_STATUS( kStatusGroup_Generic, 0 ),
+	kStatus_Fail					= MAKE_STATUS( kStatusGroup_Generic, 1 ),
+	kStatus_ReadOnly				= MAKE_STATUS( kStatusGroup_Generic, 2 ),
+	kStatus_OutOfRange				= MAKE_STATUS( kStatusGroup_Generic, 3 ),
+	kStatus_InvalidArgument			= MAKE_STATUS( kStatusGroup_Generic, 4 ),
+	kStatus_Timeout					= MAKE_STATUS( kStatusGroup_Generic, 5 ),
+	kStatus_NoTransferInProgress	= MAKE_STATUS( kStatusGroup_Generic, 6 ),
+	kStatus_Busy					= MAKE_STATUS( kStatusGroup_Generic, 7 ),
+	kStatus_NoData					= MAKE_STATUS( kStatusGroup_Generic, 8 ),
+};
+
+#define	__NVIC_PRIO_BITS		3
+#define	SDK_ISR_EXIT_BARRIER
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+uint32_t	DisableGlobalIRQ( void );
+void		EnableGlobalIRQ( uint32_t primask );
+uint32_t	__get_IPSR( void );
+uint32_t	__get_PRIMASK( void );
+status_t	EnableIRQ( IRQn_Type irq );
+status_t	DisableIRQ( IRQn_Type irq );
+void		NVIC_SetPriority( IRQn_Type irq, uint32_t priority );
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif	//	HOST_FSL_COMMON_H
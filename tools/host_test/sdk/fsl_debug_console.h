@@ -0,0 +1,14 @@
+/** Host build stub of MCUXpresso SDK header
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2026 Tedd OKANO
+ *  Released under the MIT license
+ */
+
+#ifndef HOST_FSL_DEBUG_CONSOLE_H
+#define HOST_FSL_DEBUG_CONSOLE_H
+
+#include	<stdio.h>
+
+#endif	//	HOST_FSL_DEBUG_CONSOLE_H
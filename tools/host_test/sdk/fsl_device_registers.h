@@ -0,0 +1,14 @@
+/** Host build stub of MCUXpresso SDK header
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2026 Tedd OKANO
+ *  Released under the MIT license
+ */
+
+#ifndef HOST_FSL_DEVICE_REGISTERS_H
+#define HOST_FSL_DEVICE_REGISTERS_H
+
+#include	"fsl_common.h"
+
+#endif	//	HOST_FSL_DEVICE_REGISTERS_H
@@ -0,0 +1,49 @@
+/** Host build stub of MCUXpresso SDK header
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2026 Tedd OKANO
+ *  Released under the MIT license
+ */
+
+#ifndef HOST_FSL_I3C_H
+#define HOST_FSL_I3C_H
+
+#include	"fsl_common.h"
+
+typedef struct	{
+	volatile uint32_t	MCONFIG;
+} I3C_Type;
+
+typedef enum	{ kI3C_TypeI3CSdr = 0, kI3C_TypeI2C = 1, kI3C_TypeI3CDdr = 2 }	i3c_bus_type_t;
+typedef enum	{ kI3C_Write = 0, kI3C_Read = 1 }									i3c_direction_t;
+typedef enum	{ kI3C_IbiNormal = 0, kI3C_IbiHighPriority = 1 }					i3c_ibi_type_t;
+typedef enum	{ kI3C_IbiReady = 0, kI3C_IbiDataBuffNeed = 1, kI3C_IbiAckNackPending = 2 }	i3c_ibi_state_t;
+
+typedef struct _i3c_master_handle	i3c_master_handle_t;
+
+typedef struct	{
+	void	(*slave2Master)( I3C_Type *base, void *userData );
+	void	(*ibiCallback)( I3C_Type *base, i3c_master_handle_t *handle, i3c_ibi_type_t ibiType, i3c_ibi_state_t ibiState );
+	void	(*transferComplete)( I3C_Type *base, i3c_master_handle_t *handle, status_t status, void *userData );
+} i3c_master_transfer_callback_t;
+
+struct _i3c_master_handle	{
+	uint32_t	state;
+};
+
+typedef struct	{
+	uint8_t		dynamicAddr;
+	uint8_t		staticAddr;
+	uint8_t		dcr;
+	uint8_t		bcr;
+	uint16_t	vendorID;
+	uint32_t	partNumber;
+} i3c_device_info_t;
+
+typedef struct	{
+	bool		enableMaster;
+	uint32_t	baudRate_Hz;
+} i3c_master_config_t;
+
+#endif	//	HOST_FSL_I3C_H
@@ -0,0 +1,61 @@
+/** Host build stub of MCUXpresso SDK header
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2026 Tedd OKANO
+ *  Released under the MIT license
+ *
+ *  LPI2C driver API. Transfers are served by the mock in host/lpi2c_mock.cpp.
+ */
+
+#ifndef HOST_FSL_LPI2C_H
+#define HOST_FSL_LPI2C_H
+
+#include	"fsl_common.h"
+
+typedef struct	{
+	volatile uint32_t	MCR;
+} LPI2C_Type;
+
+extern LPI2C_Type	host_lpi2c0;
+
+#define	LPI2C0				(&host_lpi2c0)
+
+enum	{
+	kStatus_LPI2C_Busy			= MAKE_STATUS( kStatusGroup_LPI2C, 0 ),
+	kStatus_LPI2C_Idle			= MAKE_STATUS( kStatusGroup_LPI2C, 1 ),
+	kStatus_LPI2C_Nak			= MAKE_STATUS( kStatusGroup_LPI2C, 2 ),
+};
+
+enum	{
+	kLPI2C_MasterNackDetectFlag	= 1U << 10,
+};
+
+typedef enum	{ kLPI2C_Write = 0, kLPI2C_Read = 1 }	lpi2c_direction_t;
+
+typedef struct	{
+	bool		enableMaster;
+	uint32_t	baudRate_Hz;
+} lpi2c_master_config_t;
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+void		LPI2C_MasterGetDefaultConfig( lpi2c_master_config_t *config );
+void		LPI2C_MasterInit( LPI2C_Type *base, const lpi2c_master_config_t *config, uint32_t srcClock_Hz );
+void		LPI2C_MasterDeinit( LPI2C_Type *base );
+void		LPI2C_MasterSetBaudRate( LPI2C_Type *base, uint32_t sourceClock_Hz, uint32_t baudRate_Hz );
+status_t	LPI2C_MasterStart( LPI2C_Type *base, uint8_t address, lpi2c_direction_t dir );
+status_t	LPI2C_MasterRepeatedStart( LPI2C_Type *base, uint8_t address, lpi2c_direction_t dir );
+void		LPI2C_MasterGetFifoCounts( LPI2C_Type *base, size_t *rxCount, size_t *txCount );
+uint32_t	LPI2C_MasterGetStatusFlags( LPI2C_Type *base );
+status_t	LPI2C_MasterSend( LPI2C_Type *base, void *txBuff, size_t txSize );
+status_t	LPI2C_MasterReceive( LPI2C_Type *base, void *rxBuff, size_t rxSize );
+status_t	LPI2C_MasterStop( LPI2C_Type *base );
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif	//	HOST_FSL_LPI2C_H
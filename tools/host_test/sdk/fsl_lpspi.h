@@ -0,0 +1,103 @@
+/** Host build stub of MCUXpresso SDK header
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2026 Tedd OKANO
+ *  Released under the MIT license
+ *
+ *  LPSPI driver API. Transfers are served by the mock in host/lpspi_mock.cpp.
+ */
+
+#ifndef HOST_FSL_LPSPI_H
+#define HOST_FSL_LPSPI_H
+
+#include	"fsl_common.h"
+
+typedef struct	{
+	volatile uint32_t	CR;
+	volatile uint32_t	CCR;
+	volatile uint32_t	TCR;
+} LPSPI_Type;
+
+extern LPSPI_Type	host_lpspi1;
+
+#define	LPSPI1				(&host_lpspi1)
+#define	LPSPI1_IRQn			((IRQn_Type)59)
+
+enum	{
+	kStatus_LPSPI_Busy			= MAKE_STATUS( kStatusGroup_LPSPI, 0 ),
+	kStatus_LPSPI_Error			= MAKE_STATUS( kStatusGroup_LPSPI, 1 ),
+	kStatus_LPSPI_Idle			= MAKE_STATUS( kStatusGroup_LPSPI, 2 ),
+	kStatus_LPSPI_OutOfRange	= MAKE_STATUS( kStatusGroup_LPSPI, 3 ),
+};
+
+typedef enum	{ kLPSPI_ClockPolarityActiveHigh = 0, kLPSPI_ClockPolarityActiveLow = 1 }	lpspi_clock_polarity_t;
+typedef enum	{ kLPSPI_ClockPhaseFirstEdge = 0, kLPSPI_ClockPhaseSecondEdge = 1 }		lpspi_clock_phase_t;
+typedef enum	{ kLPSPI_MsbFirst = 0, kLPSPI_LsbFirst = 1 }								lpspi_shift_direction_t;
+typedef enum	{ kLPSPI_Pcs0 = 0, kLPSPI_Pcs1 = 1, kLPSPI_Pcs2 = 2, kLPSPI_Pcs3 = 3 }	lpspi_which_pcs_t;
+
+enum	{
+	kLPSPI_MasterPcs0			= 0U << 2,
+	kLPSPI_MasterPcs1			= 1U << 2,
+	kLPSPI_MasterPcsContinuous	= 1U << 20,
+	kLPSPI_MasterByteSwap		= 1U << 22,
+};
+
+typedef struct	{
+	uint32_t				baudRate;
+	uint32_t				bitsPerFrame;
+	lpspi_clock_polarity_t	cpol;
+	lpspi_clock_phase_t		cpha;
+	lpspi_shift_direction_t	direction;
+	uint32_t				pcsToSckDelayInNanoSec;
+	uint32_t				lastSckToPcsDelayInNanoSec;
+	uint32_t				betweenTransferDelayInNanoSec;
+	lpspi_which_pcs_t		whichPcs;
+} lpspi_master_config_t;
+
+typedef struct	{
+	const uint8_t		*txData;
+	uint8_t				*rxData;
+	volatile size_t		dataSize;
+	uint32_t			configFlags;
+} lpspi_transfer_t;
+
+typedef struct _lpspi_master_handle	lpspi_master_handle_t;
+
+typedef void (*lpspi_master_transfer_callback_t)( LPSPI_Type *base, lpspi_master_handle_t *handle, status_t status, void *userData );
+
+struct _lpspi_master_handle	{
+	volatile bool						busy;
+	lpspi_transfer_t					xfer;
+	lpspi_master_transfer_callback_t	callback;
+	void								*userData;
+};
+
+#define	LPSPI_CCR_SCKDIV( x )		(((uint32_t)(x) & 0xFFU) <<  0)
+#define	LPSPI_CCR_DBT( x )			(((uint32_t)(x) & 0xFFU) <<  8)
+#define	LPSPI_CCR_PCSSCK( x )		(((uint32_t)(x) & 0xFFU) << 16)
+#define	LPSPI_CCR_SCKPCS( x )		(((uint32_t)(x) & 0xFFU) << 24)
+#define	LPSPI_TCR_FRAMESZ( x )		(((uint32_t)(x) & 0xFFFU) << 0)
+#define	LPSPI_TCR_LSBF( x )			(((uint32_t)(x) & 0x1U) << 23)
+#define	LPSPI_TCR_PCS( x )			(((uint32_t)(x) & 0x3U) << 24)
+#define	LPSPI_TCR_PRESCALE( x )		(((uint32_t)(x) & 0x7U) << 27)
+#define	LPSPI_TCR_CPHA( x )			(((uint32_t)(x) & 0x1U) << 30)
+#define	LPSPI_TCR_CPOL( x )			(((uint32_t)(x) & 0x1U) << 31)
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+void		LPSPI_MasterGetDefaultConfig( lpspi_master_config_t *config );
+void		LPSPI_MasterInit( LPSPI_Type *base, const lpspi_master_config_t *config, uint32_t srcClock_Hz );
+void		LPSPI_Deinit( LPSPI_Type *base );
+void		LPSPI_Enable( LPSPI_Type *base, bool enable );
+void		LPSPI_MasterTransferCreateHandle( LPSPI_Type *base, lpspi_master_handle_t *handle, lpspi_master_transfer_callback_t callback, void *userData );
+status_t	LPSPI_MasterTransferBlocking( LPSPI_Type *base, lpspi_transfer_t *transfer );
+status_t	LPSPI_MasterTransferNonBlocking( LPSPI_Type *base, lpspi_master_handle_t *handle, lpspi_transfer_t *transfer );
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif	//	HOST_FSL_LPSPI_H
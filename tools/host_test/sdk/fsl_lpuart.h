@@ -0,0 +1,28 @@
+/** Host build stub of MCUXpresso SDK header
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2026 Tedd OKANO
+ *  Released under the MIT license
+ */
+
+#ifndef HOST_FSL_LPUART_H
+#define HOST_FSL_LPUART_H
+
+#include	"fsl_common.h"
+
+typedef struct	{
+	volatile uint32_t	BAUD;
+} LPUART_Type;
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+status_t	LPUART_SetBaudRate( LPUART_Type *base, uint32_t baudRate_Bps, uint32_t srcClock_Hz );
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif	//	HOST_FSL_LPUART_H
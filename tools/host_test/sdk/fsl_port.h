@@ -0,0 +1,41 @@
+/** Host build stub of MCUXpresso SDK header
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2026 Tedd OKANO
+ *  Released under the MIT license
+ */
+
+#ifndef HOST_FSL_PORT_H
+#define HOST_FSL_PORT_H
+
+#include	"fsl_common.h"
+
+typedef struct	{
+	volatile uint32_t	PDOR;
+	volatile uint32_t	PDDR;
+} GPIO_Type;
+
+typedef struct	{
+	volatile uint32_t	PCR[ 32 ];
+} PORT_Type;
+
+typedef enum	{ kGPIO_DigitalInput = 0, kGPIO_DigitalOutput = 1 }	gpio_pin_direction_t;
+
+typedef enum	{
+	kPORT_InterruptOrDMADisabled	= 0x0,
+	kPORT_InterruptRisingEdge		= 0x9,
+	kPORT_InterruptFallingEdge		= 0xA,
+	kPORT_InterruptEitherEdge		= 0xB,
+} port_interrupt_t;
+
+typedef enum	{ kPORT_MuxAlt2 = 2, kPORT_MuxAlt3 = 3 }	port_mux_t;
+
+#define	PORT_PCR_PS_MASK		0x1U
+#define	PORT_PCR_PS( x )		(((uint32_t)(x) << 0) & PORT_PCR_PS_MASK)
+#define	PORT_PCR_PE_MASK		0x2U
+#define	PORT_PCR_PE( x )		(((uint32_t)(x) << 1) & PORT_PCR_PE_MASK)
+#define	PORT_PCR_ODE_MASK		0x20U
+#define	PORT_PCR_ODE( x )		(((uint32_t)(x) << 5) & PORT_PCR_ODE_MASK)
+
+#endif	//	HOST_FSL_PORT_H
@@ -0,0 +1,47 @@
+/** Host build stub of MCUXpresso SDK header
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2026 Tedd OKANO
+ *  Released under the MIT license
+ *
+ *  UTICK driver API. Ticks are made on virtual time by host/host.cpp.
+ */
+
+#ifndef HOST_FSL_UTICK_H
+#define HOST_FSL_UTICK_H
+
+#include	"fsl_common.h"
+
+typedef struct	{
+	volatile uint32_t	CTRL;
+	volatile uint32_t	STAT;
+} UTICK_Type;
+
+extern UTICK_Type	host_utick0;
+
+#define	UTICK0						(&host_utick0)
+#define	UTICK0_IRQn					((IRQn_Type)76)
+
+#define	UTICK_CTRL_DELAYVAL_MASK	0x7FFFFFFFU
+#define	UTICK_CTRL_REPEAT_MASK		0x80000000U
+#define	UTICK_STAT_INTR_MASK		0x1U
+#define	UTICK_STAT_ACTIVE_MASK		0x2U
+
+typedef enum	{ kUTICK_Onetime = 0, kUTICK_Repeat = 1 }	utick_mode_t;
+
+typedef void (*utick_callback_t)( void );
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+void		UTICK_Init( UTICK_Type *base );
+void		UTICK_SetTick( UTICK_Type *base, utick_mode_t mode, uint32_t count, utick_callback_t cb );
+void		UTICK_ClearStatusFlags( UTICK_Type *base );
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif	//	HOST_FSL_UTICK_H
@@ -0,0 +1,12 @@
+/** Host build stub of MCUXpresso SDK header
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2026 Tedd OKANO
+ *  Released under the MIT license
+ */
+
+#ifndef HOST_PIN_MUX_H
+#define HOST_PIN_MUX_H
+
+#endif	//	HOST_PIN_MUX_H
@@ -0,0 +1,93 @@
+/** Minimal test runner for host tests
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2026 Tedd OKANO
+ *  Released under the MIT license
+ *
+ *	TEST( name ) { ... CHECK( condition ); ... }
+ *	int main( void ) { return run_tests(); }
+ *
+ *	Each test starts after host::reset().
+ */
+
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+#include	<stdio.h>
+#include	<vector>
+#include	"host.h"
+
+typedef struct	_test_case	{
+	const char	*name;
+	void		(*fp)( void );
+} test_case_t;
+
+inline std::vector<test_case_t>	&test_cases( void )
+{
+	static std::vector<test_case_t>	cases;
+	return cases;
+}
+
+inline int	&test_failures( void )
+{
+	static int	n	= 0;
+	return n;
+}
+
+struct test_registrar
+{
+	test_registrar( const char *name, void (*fp)( void ) )
+	{
+		test_cases().push_back( { name, fp } );
+	}
+};
+
+#define	TEST( name )	\
+	static void name( void );	\
+	static test_registrar	name##_registrar( #name, name );	\
+	static void name( void )
+
+#define	CHECK( c )	\
+	do {	\
+		if ( !(c) )	\
+		{	\
+			fprintf( stderr, "%s:%d: CHECK( %s ) failed\n", __FILE__, __LINE__, #c );	\
+			test_failures()++;	\
+		}	\
+	} while ( 0 )
+
+#define	CHECK_EQ( a, b )	\
+	do {	\
+		long long	va	= (long long)(a);	\
+		long long	vb	= (long long)(b);	\
+		if ( va != vb )	\
+		{	\
+			fprintf( stderr, "%s:%d: CHECK_EQ( %s, %s ) failed: %lld != %lld\n", __FILE__, __LINE__, #a, #b, va, vb );	\
+			test_failures()++;	\
+		}	\
+	} while ( 0 )
+
+inline int run_tests( void )
+{
+	int	failed	= 0;
+
+	for ( auto &t : test_cases() )
+	{
+		int	before	= test_failures();
+
+		host::reset();
+		t.fp();
+
+		bool	ok	= (before == test_failures());
+
+		printf( "%s %s\n", ok ? "  ok  " : "FAILED", t.name );
+		failed	+= !ok;
+	}
+
+	printf( "%d / %d passed\n", (int)test_cases().size() - failed, (int)test_cases().size() );
+
+	return failed ? 1 : 0;
+}
+
+#endif	//	HOST_TEST_H
@@ -0,0 +1,123 @@
+/** Host test of AFE driver transfer cost per frame on AFE_simulator
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2026 Tedd OKANO
+ *  Released under the MIT license
+ *
+ *	SPI bytes and frames for each read operation are checked against budgets to catch throughput regressions.
+ *	Budgets are current counts. Update them when a change reduces the cost, raise them only on purpose.
+ *	Host CPU time per read is shown for reference.
+ */
+
+#include	"test.h"
+#include	"r01lib.h"
+#include	"afe/NAFE13388_UIM.h"
+#include	"afe/NAFE33352_UIOM.h"
+#include	"afe/AFE_simulator.h"
+#include	<chrono>
+
+typedef struct	_cost	{
+	uint32_t	bytes;
+	uint32_t	frames;
+	double		cpu_ns;
+} cost_t;
+
+/** SPI bytes, SPI frames and host CPU time of one operation */
+template<class F>
+static cost_t measure( AFE_simulator &sim, F f )
+{
+	constexpr int	repeat	= 1000;
+	cost_t			c;
+
+	sim.reset_counters();
+	f();
+	c.bytes		= sim.byte_count();
+	c.frames	= sim.frame_count();
+
+	auto	start	= std::chrono::steady_clock::now();
+
+	for ( auto r = 0; r < repeat; r++ )
+		f();
+
+	std::chrono::duration<double, std::nano>	t	= std::chrono::steady_clock::now() - start;
+	c.cpu_ns	= t.count() / repeat;
+
+	return c;
+}
+
+/** Measure an operation and check it against its budget */
+template<class F>
+static bool check_budget( AFE_simulator &sim, const char *model, const char *operation, uint32_t budget_bytes, uint32_t budget_frames, F f )
+{
+	cost_t	c	= measure( sim, f );
+
+	printf( "  %-9s %-26s %4u bytes (budget %4u)  %2u frames (budget %2u)  %8.1f ns\n", model, operation, c.bytes, budget_bytes, c.frames, budget_frames, c.cpu_ns );
+
+	return (c.bytes <= budget_bytes) && (c.frames <= budget_frames);
+}
+
+static void open_channels( AFE_base &afe, int n, uint16_t cc0, uint16_t cc1, uint16_t cc2, uint16_t cc3 = 0x0000 )
+{
+	afe.close_logical_channel();
+
+	for ( auto ch = 0; ch < n; ch++ )
+		afe.open_logical_channel( ch, cc0, cc1, cc2, cc3 );
+}
+
+TEST( nafe13388_cost_per_frame )
+{
+	AFE_simulator		sim( AFE_simulator::MODEL_NAFE13388 );
+	NAFE13388_UIM		afe( sim );
+	AFE_base::raw_t		data[ 16 ];
+	AFE_base::frame_t	frame;
+
+	afe.begin();
+	afe.use_DRDY_trigger( false );
+
+	open_channels( afe, 1, 0x1070, 0x0084, 0x2900 );
+
+	CHECK( check_budget( sim, "NAFE13388", "read( ch )",               5, 1, [ & ](){ afe.read( 0 ); } ) );
+	CHECK( check_budget( sim, "NAFE13388", "start_and_read( ch )",     9, 3, [ & ](){ afe.start_and_read( 0 ); } ) );
+	CHECK( check_budget( sim, "NAFE13388", "start_and_read( data ) 1",  7, 2, [ & ](){ afe.start_and_read( data ); } ) );
+
+	open_channels( afe, 4, 0x1070, 0x0084, 0x2900 );
+
+	CHECK( check_budget( sim, "NAFE13388", "start_and_read( data ) 4", 16, 2, [ & ](){ afe.start_and_read( data ); } ) );
+
+	open_channels( afe, 16, 0x1070, 0x0084, 0x2900 );
+
+	CHECK( check_budget( sim, "NAFE13388", "start_and_read( data ) 16", 52, 2, [ & ](){ afe.start_and_read( data ); } ) );
+	CHECK( check_budget( sim, "NAFE13388", "start_and_read( frame ) 16", 52, 2, [ & ](){ afe.start_and_read( frame ); } ) );
+}
+
+TEST( nafe33352_cost_per_frame )
+{
+	AFE_simulator		sim( AFE_simulator::MODEL_NAFE33352 );
+	NAFE33352_UIOM		afe( sim );
+	AFE_base::raw_t		data[ 16 ];
+	AFE_base::frame_t	frame;
+
+	afe.begin();
+	afe.use_DRDY_trigger( false );
+
+	open_channels( afe, 1, 0x0008, 0x0084, 0x2900 );
+
+	CHECK( check_budget( sim, "NAFE33352", "read( ch )",               5, 1, [ & ](){ afe.read( 0 ); } ) );
+	CHECK( check_budget( sim, "NAFE33352", "start_and_read( ch )",     9, 3, [ & ](){ afe.start_and_read( 0 ); } ) );
+	CHECK( check_budget( sim, "NAFE33352", "start_and_read( data ) 1",  7, 2, [ & ](){ afe.start_and_read( data ); } ) );
+
+	open_channels( afe, 4, 0x0008, 0x0084, 0x2900 );
+
+	CHECK( check_budget( sim, "NAFE33352", "start_and_read( data ) 4", 16, 2, [ & ](){ afe.start_and_read( data ); } ) );
+
+	open_channels( afe, 8, 0x0008, 0x0084, 0x2900 );
+
+	CHECK( check_budget( sim, "NAFE33352", "start_and_read( data ) 8", 28, 2, [ & ](){ afe.start_and_read( data ); } ) );
+	CHECK( check_budget( sim, "NAFE33352", "start_and_read( frame ) 8", 28, 2, [ & ](){ afe.start_and_read( frame ); } ) );
+}
+
+int main( void )
+{
+	return run_tests();
+}
@@ -0,0 +1,114 @@
+/** Host test of AFE_static against the virtual API of the drivers on AFE_simulator
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2026 Tedd OKANO
+ *  Released under the MIT license
+ *
+ *	Static and virtual paths must give the same data, volt value and SPI traffic for every channel.
+ *	compare_dispatch() needs DWT and gives 0 on host, so host CPU time of both paths is shown for reference.
+ */
+
+#include	"test.h"
+#include	"r01lib.h"
+#include	"afe/NAFE13388_UIM.h"
+#include	"afe/NAFE33352_UIOM.h"
+#include	"afe/AFE_simulator.h"
+#include	"afe/AFE_static.h"
+#include	<chrono>
+
+/** Host CPU time per call */
+template<class F>
+static double time_per_call( F f )
+{
+	constexpr int	repeat	= 10000;
+	volatile double	sink	= 0;
+
+	auto	start	= std::chrono::steady_clock::now();
+
+	for ( auto r = 0; r < repeat; r++ )
+		sink	= sink + f();
+
+	std::chrono::duration<double, std::nano>	t	= std::chrono::steady_clock::now() - start;
+
+	return t.count() / repeat;
+}
+
+/** Same results and same SPI traffic on both paths for each channel */
+template<class A, class S>
+static void compare_paths( const char *model, AFE_simulator &sim, A &afe, S &fast, int channels )
+{
+	for ( auto ch = 0; ch < channels; ch++ )
+	{
+		sim.waveform( ch, AFE_simulator::DC, 1000 * (ch + 1) - 0x4000 );
+
+		sim.reset_counters();
+		AFE_base::raw_t	v_raw	= afe.start_and_read( ch );
+		uint32_t		v_bytes	= sim.byte_count();
+		uint32_t		v_frames	= sim.frame_count();
+
+		sim.reset_counters();
+		AFE_base::raw_t	s_raw	= fast.start_and_read( ch );
+
+		CHECK_EQ( s_raw, v_raw );
+		CHECK_EQ( s_raw, 1000 * (ch + 1) - 0x4000 );
+		CHECK_EQ( sim.byte_count(), v_bytes );
+		CHECK_EQ( sim.frame_count(), v_frames );
+
+		CHECK( fast.raw2v( ch, s_raw ) == afe.raw2v( ch, v_raw ) );
+		CHECK_EQ( fast.raw2nv( ch, s_raw ), afe.raw2nv( ch, v_raw ) );
+
+		AFE_base::volt_t	v_volt	= afe.logical_channel[ ch ];
+		AFE_base::volt_t	s_volt	= fast.channel( ch );
+		AFE_base::raw_t		s_ch	= fast.channel( ch );
+
+		CHECK( s_volt == v_volt );
+		CHECK_EQ( s_ch, v_raw );
+	}
+
+	AFE_base	&a	= afe;
+	auto		c	= fast.compare_dispatch( 0, 10 );
+
+	CHECK_EQ( c.virtual_path, 0 );	//	no DWT on host
+	CHECK_EQ( c.static_path, 0 );
+
+	double	t_virtual	= time_per_call( [ & ](){ a.start( 0 ); return a.raw2v( 0, a.read( 0 ) ); } );
+	double	t_static	= time_per_call( [ & ](){ fast.start( 0 ); return fast.raw2v( 0, fast.read( 0 ) ); } );
+
+	printf( "  %-9s start + read + raw2v: virtual %7.1f ns, static %7.1f ns (host CPU time)\n", model, t_virtual, t_static );
+}
+
+TEST( nafe13388_static_matches_virtual )
+{
+	AFE_simulator		sim( AFE_simulator::MODEL_NAFE13388 );
+	NAFE13388_UIM		afe( sim );
+	NAFE13388_static	fast( afe );
+
+	afe.begin();
+	afe.use_DRDY_trigger( false );
+
+	for ( auto ch = 0; ch < 16; ch++ )
+		afe.logical_channel[ ch ].configure( 0x1010 | ((ch % 8) << 5), 0x0084, 0x2900 );
+
+	compare_paths( "NAFE13388", sim, afe, fast, 16 );
+}
+
+TEST( nafe33352_static_matches_virtual )
+{
+	AFE_simulator		sim( AFE_simulator::MODEL_NAFE33352 );
+	NAFE33352_UIOM		afe( sim );
+	NAFE33352_static	fast( afe );
+
+	afe.begin();
+	afe.use_DRDY_trigger( false );
+
+	for ( auto ch = 0; ch < 8; ch++ )
+		afe.logical_channel[ ch ].configure( 0x0008 * (ch + 1), 0x0084, 0x2900 );
+
+	compare_paths( "NAFE33352", sim, afe, fast, 8 );
+}
+
+int main( void )
+{
+	return run_tests();
+}
@@ -0,0 +1,269 @@
+/** Host test of SampleStream and tools/afe_stream decoder over pseudo terminal
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2026 Tedd OKANO
+ *  Released under the MIT license
+ *
+ *	Packets made by SampleStream are written to the master side of a pty, as the MCU writes to LPUART.
+ *	The slave side is read by StreamDecoder, and by afe_stream_decode command for CSV output.
+ *	Stream includes a packet split over two reads, a packet with broken CRC and a packet not sent.
+ */
+
+#include	"test.h"
+#include	"r01lib.h"
+#include	"afe/SampleStream.h"
+#include	"afe_stream.h"
+#include	"COBS.h"
+#include	<string>
+#include	<fcntl.h>
+#include	<poll.h>
+#include	<pty.h>
+#include	<unistd.h>
+#include	<sys/wait.h>
+
+typedef struct	_pty_pair	{
+	int		master;
+	int		slave;
+	char	name[ 64 ];
+} pty_pair_t;
+
+static bool open_pty( pty_pair_t &p )
+{
+	struct termios	t;
+
+	memset( &t, 0, sizeof( t ) );
+	cfmakeraw( &t );
+
+	return !openpty( &p.master, &p.slave, p.name, &t, nullptr );
+}
+
+/** Packet with same content and sequence number but CRC not matching */
+static std::vector<uint8_t> corrupt_crc( const uint8_t *packet, int length )
+{
+	uint8_t					raw[ SampleStream::encoded_max ]	= {};
+	std::vector<uint8_t>	v( SampleStream::encoded_max );
+	int						n	= cobs_decode( packet, length - 1, raw );
+
+	raw[ SampleStream::header_length ]	^= 0x01;	//	first sample
+
+	v.resize( cobs_encode( raw, n, v.data() ) );
+	v.push_back( 0x00 );
+
+	return v;
+}
+
+/** Read and decode until no data comes for 100 ms */
+static void drain( int fd, StreamDecoder &decoder )
+{
+	uint8_t			buf[ 256 ];
+	struct pollfd	p	= { fd, POLLIN, 0 };
+
+	while ( 0 < poll( &p, 1, 100 ) )
+	{
+		ssize_t	n	= read( fd, buf, sizeof( buf ) );
+
+		if ( n <= 0 )
+			break;
+
+		decoder.feed( buf, n );
+	}
+}
+
+/** Write test stream: 6 packets made, #2 split, #3 broken, #4 not sent
+ *
+ * @param between called between the two parts of the split packet
+ */
+static void write_stream( int fd, std::function<void(void)> between = nullptr )
+{
+	SampleStream		stream;
+	AFE_base::raw_t		data[ 3 ]	= { 0x123456, -1, -0x800000 };
+	uint8_t				buf[ SampleStream::encoded_max ];
+	uint8_t				sync		= 0x00;
+	int					n;
+
+	host::console::fd	= fd;
+
+	//	decoder drops bytes before the first delimiter
+
+	Console::write( &sync, 1 );
+
+	stream.send( data, 0x0003, 1000, 10 );
+	stream.send( data, 0x0003, 1100, 11 );
+
+	n	= stream.encode( buf, data, 0x0003, 1200, 12 );
+	CHECK_EQ( write( fd, buf, n / 2 ), n / 2 );
+
+	if ( between )
+		between();
+
+	CHECK_EQ( write( fd, buf + n / 2, n - n / 2 ), n - n / 2 );
+
+	n	= stream.encode( buf, data, 0x0003, 1300, 13 );
+
+	auto	broken	= corrupt_crc( buf, n );
+	CHECK_EQ( write( fd, broken.data(), broken.size() ), (ssize_t)broken.size() );
+
+	stream.encode( buf, data, 0x0003, 1400, 14 );
+
+	stream.send( data, 0x0007, 1500, 15 );
+
+	CHECK_EQ( stream.packet_count(), 3 );
+}
+
+TEST( decoder_reads_packets_from_pty )
+{
+	pty_pair_t	pty;
+
+	CHECK( open_pty( pty ) );
+
+	std::vector<StreamDecoder::packet_t>	received;
+	StreamDecoder	decoder( [ & ]( const StreamDecoder::packet_t &p ){ received.push_back( p ); } );
+
+	write_stream( pty.master, [ & ]()
+	{
+		drain( pty.slave, decoder );
+		CHECK_EQ( received.size(), 2 );
+	} );
+
+	drain( pty.slave, decoder );
+
+	CHECK_EQ( decoder.packets, 4 );
+	CHECK_EQ( decoder.crc_errors, 1 );
+	CHECK_EQ( decoder.format_errors, 0 );
+	CHECK_EQ( decoder.lost, 2 );
+	CHECK_EQ( received.size(), 4 );
+
+	const uint16_t	packet_sequence[]	= { 0, 1, 2, 5 };
+	const uint32_t	sequence[]			= { 10, 11, 12, 15 };
+
+	for ( size_t i = 0; i < received.size(); i++ )
+	{
+		const auto	&p	= received[ i ];
+
+		CHECK_EQ( p.packet_sequence, packet_sequence[ i ] );
+		CHECK_EQ( p.sequence, sequence[ i ] );
+		CHECK_EQ( p.timestamp, sequence[ i ] * 100 );
+		CHECK_EQ( p.count, (3 == i) ? 3 : 2 );
+		CHECK_EQ( p.data[ 0 ], 0x123456 );
+		CHECK_EQ( p.data[ 1 ], -1 );
+	}
+
+	CHECK_EQ( received[ 3 ].mask, 0x0007 );
+	CHECK_EQ( received[ 3 ].data[ 2 ], -0x800000 );
+
+	close( pty.master );
+	close( pty.slave );
+}
+
+/** True if the process has the file open */
+static bool has_open( pid_t pid, const char *path )
+{
+	char	link[ 64 ];
+	char	target[ 64 ];
+
+	for ( auto fd = 0; fd < 32; fd++ )
+	{
+		snprintf( link, sizeof( link ), "/proc/%d/fd/%d", pid, fd );
+
+		ssize_t	n	= readlink( link, target, sizeof( target ) - 1 );
+
+		if ( 0 < n )
+		{
+			target[ n ]	= '\0';
+
+			if ( !strcmp( target, path ) )
+				return true;
+		}
+	}
+
+	return false;
+}
+
+static std::string read_file( const char *path )
+{
+	std::string	s;
+	char		buf[ 256 ];
+	FILE		*fp	= fopen( path, "r" );
+
+	if ( !fp )
+		return s;
+
+	for ( size_t n; 0 < (n = fread( buf, 1, sizeof( buf ), fp )); )
+		s.append( buf, n );
+
+	fclose( fp );
+
+	return s;
+}
+
+TEST( decode_command_writes_csv )
+{
+	//	afe_stream_decode is built next to this test
+
+	char	dir[ 256 ];
+	ssize_t	n	= readlink( "/proc/self/exe", dir, sizeof( dir ) - 1 );
+
+	CHECK( 0 < n );
+	dir[ n ]	= '\0';
+	*strrchr( dir, '/' )	= '\0';
+
+	std::string	command	= std::string( dir ) + "/afe_stream_decode";
+	std::string	csv		= std::string( dir ) + "/afe_stream.csv";
+	std::string	log		= std::string( dir ) + "/afe_stream.log";
+
+	pty_pair_t	pty;
+
+	CHECK( open_pty( pty ) );
+
+	fflush( stdout );
+
+	pid_t	pid	= fork();
+
+	if ( !pid )
+	{
+		close( pty.master );
+		close( pty.slave );
+		freopen( csv.c_str(), "w", stdout );
+		freopen( log.c_str(), "w", stderr );
+		execl( command.c_str(), command.c_str(), "-b", "921600", pty.name, (char *)nullptr );
+		_exit( 127 );
+	}
+
+	close( pty.slave );
+
+	//	slave stays usable only while the master is open: wait for the command to open it
+
+	for ( auto i = 0; (i < 200) && !has_open( pid, pty.name ); i++ )
+		usleep( 10000 );
+
+	CHECK( has_open( pid, pty.name ) );
+
+	write_stream( pty.master, [](){ usleep( 50000 ); } );
+
+	//	closing master makes read() on slave fail after remaining data
+
+	usleep( 100000 );
+	close( pty.master );
+
+	int	status	= -1;
+
+	waitpid( pid, &status, 0 );
+
+	CHECK( WIFEXITED( status ) && !WEXITSTATUS( status ) );
+
+	CHECK( read_file( csv.c_str() ) ==
+		"packet,sequence,timestamp_us,ch0,ch1\n"
+		"0,10,1000,1193046,-1\n"
+		"1,11,1100,1193046,-1\n"
+		"2,12,1200,1193046,-1\n"
+		"packet,sequence,timestamp_us,ch0,ch1,ch2\n"
+		"5,15,1500,1193046,-1,-8388608\n" );
+
+	CHECK( read_file( log.c_str() ) == "packets: 4, lost: 2, CRC errors: 1, format errors: 0\n" );
+}
+
+int main( void )
+{
+	return run_tests();
+}
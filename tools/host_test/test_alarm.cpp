@@ -0,0 +1,229 @@
+/** Host test of threshold alarm events on AFE_simulator
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2026 Tedd OKANO
+ *  Released under the MIT license
+ *
+ *	Device thresholds: nINT edge starts alarm_service() in interrupt. Its non-blocking transfer chain reads
+ *	over/under status, data of flagged channels and clears the alarm. Register address of each frame is checked.
+ *	MCU thresholds: channel compared on streaming path posts one event per excursion and is re-armed when back in range.
+ */
+
+#include	"test.h"
+#include	"r01lib.h"
+#include	"afe/NAFE13388_UIM.h"
+#include	"afe/NAFE33352_UIOM.h"
+#include	"afe/AFE_simulator.h"
+
+/** Simulator recording register address (or command) and length of each frame */
+class LoggingSimulator : public AFE_simulator
+{
+public:
+	typedef struct	_frame	{
+		uint16_t	addr;
+		int			length;
+	} frame_t;
+
+	LoggingSimulator( Model model ) : AFE_simulator( model ) {}
+
+	virtual status_t write( uint8_t *wp, uint8_t *rp, int length )
+	{
+		uint16_t	word	= ((wp[ 0 ] << 8) | wp[ 1 ]) & 0x7FFF;
+
+		log.push_back( { (uint16_t)((2 == length) ? word >> 1 : (word & 0x3FFE) >> 1), length } );
+
+		return AFE_simulator::write( wp, rp, length );
+	}
+
+	std::vector<frame_t>	log;
+};
+
+/** NAFE13388 without device threshold slot: all channels are compared by MCU */
+class NAFE13388_no_slot : public NAFE13388_UIM
+{
+public:
+	using NAFE13388_UIM::NAFE13388_UIM;
+
+protected:
+	virtual bool hardware_threshold( int, bool, raw_t, raw_t )	{ return false; }
+};
+
+static bool log_is( const LoggingSimulator &sim, const std::vector<LoggingSimulator::frame_t> &expected )
+{
+	if ( sim.log.size() != expected.size() )
+		return false;
+
+	for ( size_t i = 0; i < expected.size(); i++ )
+		if ( (sim.log[ i ].addr != expected[ i ].addr) || (sim.log[ i ].length != expected[ i ].length) )
+			return false;
+
+	return true;
+}
+
+TEST( nafe33352_alarm_service_chain )
+{
+	LoggingSimulator			sim( AFE_simulator::MODEL_NAFE33352 );
+	NAFE33352_UIOM				afe( sim );
+	AFE_base::raw_t				data[ 16 ];
+	AFE_base::alarm_event_t		events[ 8 ];
+	AFE_base::alarm_event_t		e[ 8 ];
+
+	afe.begin();
+	afe.use_DRDY_trigger( false );
+
+	for ( auto ch = 0; ch < 3; ch++ )
+	{
+		afe.logical_channel[ ch ].configure( 0x0008, 0x0084, 0x2900 );
+		CHECK( afe.set_threshold( ch, 500, -500 ) );
+	}
+
+	sim.waveform( 0, AFE_simulator::DC,  1000 );
+	sim.waveform( 1, AFE_simulator::DC, -1000 );
+	sim.waveform( 2, AFE_simulator::DC,     0 );
+
+	afe.start_alarm_events( events, 8, 0xFFFF );
+	afe.start_and_read( data );
+
+	CHECK_EQ( sim.alarm_status(), 0x0003 );
+
+	//	AI_STATUS_OVR --> AI_STATUS_UDR --> AI_DATA0 --> AI_DATA1 --> CMD_CLEAR_ALARM, all in nINT interrupt
+
+	sim.log.clear();
+	host::edge( D7, false );
+
+	CHECK( log_is( sim, { { 0x1026, 4 }, { 0x1027, 4 }, { 0x1030, 5 }, { 0x1031, 5 }, { 0x0012, 2 } } ) );
+	CHECK_EQ( sim.alarm_status(), 0x0000 );
+
+	CHECK_EQ( afe.read_alarm_events( e, 8 ), 2 );
+	CHECK_EQ( e[ 0 ].channel, 0 );
+	CHECK_EQ( e[ 0 ].type, AFE_base::ALARM_OVER );
+	CHECK_EQ( e[ 0 ].data, 1000 );
+	CHECK_EQ( e[ 1 ].channel, 1 );
+	CHECK_EQ( e[ 1 ].type, AFE_base::ALARM_UNDER );
+	CHECK_EQ( e[ 1 ].data, -1000 );
+
+	//	nINT without flagged channel: status is read and cleared, no data read
+
+	sim.log.clear();
+	host::edge( D7, false );
+
+	CHECK( log_is( sim, { { 0x1026, 4 }, { 0x1027, 4 }, { 0x0012, 2 } } ) );
+	CHECK_EQ( afe.alarm_events_available(), 0 );
+	CHECK_EQ( afe.alarm_missed_count(), 0 );
+
+	afe.stop_alarm_events();
+}
+
+TEST( nafe13388_alarm_service_chain )
+{
+	LoggingSimulator			sim( AFE_simulator::MODEL_NAFE13388 );
+	NAFE13388_UIM				afe( sim );
+	AFE_base::raw_t				data[ 16 ];
+	AFE_base::alarm_event_t		events[ 8 ];
+	AFE_base::alarm_event_t		e[ 8 ];
+
+	afe.begin();
+	afe.use_DRDY_trigger( false );
+
+	//	channel 9 checks slot above 8 and status bit in upper byte
+
+	for ( auto ch = 0; ch < 10; ch++ )
+	{
+		afe.logical_channel[ ch ].configure( 0x1070, 0x0084, 0x2900 );
+		CHECK( afe.set_threshold( ch, 500, -500 ) );
+	}
+
+	sim.waveform( 2, AFE_simulator::DC,  1000 );
+	sim.waveform( 9, AFE_simulator::DC, -1000 );
+
+	afe.start_alarm_events( events, 8, 0xFFFF );
+	afe.start_and_read( data );
+
+	CHECK_EQ( sim.alarm_status(), 0x0204 );
+
+	//	CH_STATUS0 --> CH_STATUS1 --> CH_DATA2 --> CH_DATA9 --> CMD_CLEAR_ALARM
+
+	sim.log.clear();
+	host::edge( D3, false );
+
+	CHECK( log_is( sim, { { 0x0035, 4 }, { 0x0036, 4 }, { 0x0042, 5 }, { 0x0049, 5 }, { 0x0012, 2 } } ) );
+	CHECK_EQ( sim.alarm_status(), 0x0000 );
+
+	CHECK_EQ( afe.read_alarm_events( e, 8 ), 2 );
+	CHECK_EQ( e[ 0 ].channel, 2 );
+	CHECK_EQ( e[ 0 ].type, AFE_base::ALARM_OVER );
+	CHECK_EQ( e[ 0 ].data, 1000 );
+	CHECK_EQ( e[ 1 ].channel, 9 );
+	CHECK_EQ( e[ 1 ].type, AFE_base::ALARM_UNDER );
+	CHECK_EQ( e[ 1 ].data, -1000 );
+
+	//	cleared threshold is set to full-scale: no more alarm
+
+	afe.clear_threshold( 2 );
+	afe.start_and_read( data );
+
+	CHECK_EQ( sim.alarm_status(), 0x0200 );
+
+	afe.stop_alarm_events();
+}
+
+TEST( mcu_threshold_rearm )
+{
+	AFE_simulator				sim( AFE_simulator::MODEL_NAFE13388 );
+	NAFE13388_no_slot			afe( sim );
+	AFE_base::frame_t			frames[ 64 ];
+	AFE_base::alarm_event_t		events[ 8 ];
+	AFE_base::alarm_event_t		e[ 8 ];
+
+	afe.begin();
+
+	afe.logical_channel[ 0 ].configure( 0x1070, 0x0084, 0x2900 );
+	CHECK( !afe.set_threshold( 0, 500, -500 ) );
+
+	afe.start_alarm_events( events, 8, 0x0000 );
+
+	sim.DRDY_callback( [](){ host::edge( D4, true ); } );
+	afe.start_streaming( frames, 64 );
+
+	//	one event per excursion, however many frames stay out of range
+
+	const int32_t	level[]		= { 0, 1000, 1000, 0, 1000, 0, -1000, -1000, 0 };
+
+	for ( auto v : level )
+	{
+		sim.waveform( 0, AFE_simulator::DC, v );
+		sim.run( 5 * sim.conversion_time( 0 ) );
+	}
+
+	afe.stop_streaming();
+
+	CHECK( 40 <= afe.frames_available() );
+	CHECK_EQ( afe.overrun_count(), 0 );
+
+	CHECK_EQ( afe.read_alarm_events( e, 8 ), 3 );
+	CHECK_EQ( e[ 0 ].type, AFE_base::ALARM_OVER );
+	CHECK_EQ( e[ 0 ].data, 1000 );
+	CHECK_EQ( e[ 1 ].type, AFE_base::ALARM_OVER );
+	CHECK_EQ( e[ 2 ].type, AFE_base::ALARM_UNDER );
+	CHECK_EQ( e[ 2 ].data, -1000 );
+	CHECK( e[ 0 ].timestamp <= e[ 1 ].timestamp );
+	CHECK( e[ 1 ].timestamp <= e[ 2 ].timestamp );
+
+	//	channel is not compared after the threshold is removed
+
+	afe.clear_threshold( 0 );
+	afe.start_streaming( frames, 64 );
+	sim.waveform( 0, AFE_simulator::DC, 1000 );
+	sim.run( 5 * sim.conversion_time( 0 ) );
+	afe.stop_streaming();
+
+	CHECK_EQ( afe.alarm_events_available(), 0 );
+
+	afe.stop_alarm_events();
+}
+
+int main( void )
+{
+	return run_tests();
+}
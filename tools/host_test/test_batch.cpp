@@ -0,0 +1,146 @@
+/** Host test of SPI_for_AFE batch transfer (r01device/afe/SPI_for_AFE.cpp) on LPSPI mock
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2026 Tedd OKANO
+ *  Released under the MIT license
+ */
+
+#include	"test.h"
+#include	"r01lib.h"
+#include	"afe/SPI_for_AFE.h"
+
+/** Record 3 register writes */
+static void record( SPI_for_AFE &afe )
+{
+	afe.batch_begin();
+	afe.write_r16( 0x0010, 0x1111 );
+	afe.write_r16( 0x0011, 0x2222 );
+	afe.write_r16( 0x0012, 0x3333 );
+}
+
+static int complete_all( void )
+{
+	int	n	= 0;
+
+	while ( host::lpspi::complete() )
+		n++;
+
+	return n;
+}
+
+TEST( batch_frames_chained_from_interrupt )
+{
+	SPI			spi;
+	SPI_for_AFE	afe( spi, false );
+
+	host::lpspi::latency	= -1;
+
+	record( afe );
+	CHECK( host::lpspi::log.empty() );
+
+	afe.batch_end( false );
+	CHECK( afe.batch_busy() );
+
+	CHECK_EQ( complete_all(), 3 );
+	CHECK( !afe.batch_busy() );
+	CHECK_EQ( afe.last_status, kStatus_Success );
+	CHECK_EQ( host::lpspi::log.size(), 3 );
+
+	for ( size_t i = 0; i < host::lpspi::log.size(); i++ )
+	{
+		const auto	&t	= host::lpspi::log[ i ];
+
+		CHECK( !t.blocking );
+		CHECK_EQ( t.tx.size(), 4 );
+		CHECK_EQ( t.tx[ 1 ], (0x10 + i) << 1 );
+		CHECK_EQ( t.tx[ 2 ], 0x11 * (i + 1) );
+	}
+}
+
+TEST( start_failure_in_interrupt_aborts_batch )
+{
+	//	bus taken by higher priority interrupt when the chained start is tried
+
+	SPI			spi;
+	SPI_for_AFE	afe( spi, false );
+
+	host::lpspi::latency	= -1;
+
+	record( afe );
+	afe.batch_end( false );
+
+	host::lpspi::fail_starts	= 1;
+
+	CHECK( host::lpspi::complete() );
+	CHECK( !afe.batch_busy() );
+	CHECK_EQ( afe.last_status, kStatus_LPSPI_Busy );
+	CHECK_EQ( host::lpspi::log.size(), 1 );
+	CHECK( !host::lpspi::busy() );
+
+	//	rest of frames are discarded. Next batch works
+
+	host::lpspi::latency	= 0;
+
+	record( afe );
+	afe.batch_end();
+
+	CHECK( !afe.batch_busy() );
+	CHECK_EQ( afe.last_status, kStatus_Success );
+	CHECK_EQ( host::lpspi::log.size(), 4 );
+	CHECK_EQ( host::lpspi::log[ 1 ].tx[ 1 ], 0x10 << 1 );
+}
+
+TEST( start_failure_in_thread_sends_blocking )
+{
+	SPI			spi;
+	SPI_for_AFE	afe( spi, false );
+
+	host::lpspi::latency		= 0;
+	host::lpspi::fail_starts	= 1;
+
+	record( afe );
+	afe.batch_end();
+
+	CHECK( !afe.batch_busy() );
+	CHECK_EQ( afe.last_status, kStatus_Success );
+	CHECK_EQ( host::lpspi::log.size(), 3 );
+
+	//	frame failed to start is sent by blocking transfer, following ones are chained again
+
+	CHECK( host::lpspi::log[ 0 ].blocking );
+	CHECK( !host::lpspi::log[ 1 ].blocking );
+	CHECK( !host::lpspi::log[ 2 ].blocking );
+}
+
+TEST( flush_for_read_returns_after_abort )
+{
+	//	register read flushes recorded frames and must not wait forever for aborted batch
+
+	SPI			spi;
+	SPI_for_AFE	afe( spi, false );
+
+	host::lpspi::latency	= -1;
+
+	record( afe );
+	host::lpspi::fail_starts	= 1;
+	host::lpspi::latency		= 0;
+
+	host::run_isr( LPSPI1_IRQn, [ & ](){ afe.batch_end( false ); } );
+
+	CHECK( !afe.batch_busy() );
+	CHECK_EQ( afe.last_status, kStatus_LPSPI_Busy );
+
+	afe.batch_begin();
+	afe.write_r16( 0x0013, 0x4444 );
+	afe.read_r16( 0x0014 );
+	afe.batch_end();
+
+	CHECK_EQ( afe.last_status, kStatus_Success );
+	CHECK_EQ( host::lpspi::log.size(), 2 );
+}
+
+int main( void )
+{
+	return run_tests();
+}
@@ -0,0 +1,231 @@
+/** Host test of CurrentLoop on AFE_simulator with a current output model
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2026 Tedd OKANO
+ *  Released under the MIT license
+ *
+ *	Loop current is modeled from AO_DATA with gain and offset error and a compliance limit,
+ *	and read back on logical channel 0 as voltage on the sense resistor. Ticker runs on virtual time.
+ *	Convergence to setpoint, recovery from saturation (anti-windup) and Ticker (UTICK) exclusivity are checked.
+ */
+
+#include	"test.h"
+#include	"r01lib.h"
+#include	"afe/NAFE33352_UIOM.h"
+#include	"afe/AFE_simulator.h"
+#include	"afe/CurrentLoop.h"
+#include	"afe/DACPlayback.h"
+#include	<math.h>
+
+constexpr int		channel		= 0;
+constexpr double	sense		= 250.0;	//	ohm
+constexpr float		rate		= 1000.0;	//	Hz
+
+/** NAFE33352 simulator with loop current read back on a logical channel */
+class LoopSimulator : public AFE_simulator
+{
+public:
+	LoopSimulator() : AFE_simulator( MODEL_NAFE33352 ) {}
+
+	virtual status_t write( uint8_t *wp, uint8_t *rp, int length )
+	{
+		uint16_t	word	= ((wp[ 0 ] << 8) | wp[ 1 ]) & 0x7FFF;
+		uint16_t	addr	= (word & 0x3FFE) >> 1;
+		uint32_t	value	= 0;
+
+		for ( auto i = 2; i < length; i++ )
+			value	= (value << 8) | wp[ i ];
+
+		status_t	r	= AFE_simulator::write( wp, rp, length );
+
+		if ( (5 == length) && !(word & 0x4000) && (addr == static_cast<uint16_t>( NAFE33352_Base::Register24::AO_DATA )) )
+		{
+			ao_writes++;
+			waveform( channel, DC, (int32_t)lround( current( value ) * sense / lsb ) );
+		}
+
+		return r;
+	}
+
+	/** Loop current for AO_DATA */
+	double current( uint32_t code )
+	{
+		double	x	= -(double)((int32_t)(code << 8) >> 8) * full_scale / (double)(1 << 23);
+
+		return std::clamp( gain * x + offset, -compliance, compliance );
+	}
+
+	double		gain		= 0.95;
+	double		offset		= 0.0003;	//	A
+	double		compliance	= 0.030;	//	A: load voltage limit
+	double		full_scale	= 0.00;
+	double		lsb			= 0.00;		//	V per ADC code of the channel
+	uint32_t	ao_writes	= 0;
+};
+
+static void setup( LoopSimulator &sim, NAFE33352_UIOM &afe )
+{
+	afe.begin();
+
+	afe.dac.configure( NAFE33352_Base::DAC::ModeSelect::CURRENT );
+	afe.logical_channel[ channel ].configure( 0x0008, 0x0084, 0x2900 );
+
+	sim.full_scale	= afe.dac.full_scale_range();
+	sim.lsb			= afe.raw2v( channel, 1 );
+
+	sim.DRDY_callback( [](){ host::edge( D4, true ); } );
+}
+
+/** Cycles until the current stays within the tolerance for 20 cycles, or -1 */
+static int settle( CurrentLoop &loop, double target, double tolerance, int limit )
+{
+	int	inside	= 0;
+
+	for ( auto n = 1; n <= limit; n++ )
+	{
+		wait( 1.0 / rate );
+
+		inside	= (fabs( loop.current() - target ) < tolerance) ? inside + 1 : 0;
+
+		if ( 20 == inside )
+			return n - 20;
+	}
+
+	return -1;
+}
+
+TEST( loop_converges_to_setpoint )
+{
+	LoopSimulator	sim;
+	NAFE33352_UIOM	afe( sim );
+	CurrentLoop		loop( afe, channel, sense );
+
+	setup( sim, afe );
+
+	double	dac_lsb	= sim.full_scale / (1 << 17);
+
+	loop.gains( 0.2, 200.0 );
+	loop.setpoint( 0.012 );
+
+	CHECK( loop.start( rate ) );
+
+	//	feed-forward alone is off by gain and offset error: PI removes it
+
+	int	n	= settle( loop, 0.012, 2 * dac_lsb, 500 );
+
+	printf( "  12 mA: settled in %d cycles, %.4f mA, AO_DATA 0x%06lX\n", n, loop.current() * 1e3, (unsigned long)(loop.output_code() & 0xFFFFFF) );
+
+	CHECK( 0 <= n );
+	CHECK( n < 100 );
+
+	//	setpoint change while running: integral is kept
+
+	loop.setpoint( 0.004 );
+	n	= settle( loop, 0.004, 2 * dac_lsb, 500 );
+
+	printf( "   4 mA: settled in %d cycles, %.4f mA\n", n, loop.current() * 1e3 );
+
+	CHECK( 0 <= n );
+	CHECK( n < 100 );
+
+	AFE_base::interval_stats_t	st	= loop.interval_stats();
+
+	loop.stop();
+
+	CHECK_EQ( loop.late_count(), 0 );
+	CHECK_EQ( loop.error_count(), 0 );
+	CHECK_EQ( sim.ao_writes, loop.cycle_count() );
+	CHECK_EQ( st.min, 1000 );
+	CHECK_EQ( st.max, 1000 );
+
+	//	output keeps last value after stop
+
+	uint32_t	cycles	= loop.cycle_count();
+
+	wait( 0.01 );
+	CHECK_EQ( loop.cycle_count(), cycles );
+	CHECK( !Ticker::in_use() );
+}
+
+TEST( loop_recovers_from_saturation )
+{
+	LoopSimulator	sim;
+	NAFE33352_UIOM	afe( sim );
+	CurrentLoop		loop( afe, channel, sense );
+
+	setup( sim, afe );
+
+	double	dac_lsb		= sim.full_scale / (1 << 17);
+	int32_t	code_max	= ((1 << 17) - 1) << 6;
+
+	sim.compliance	= 0.015;
+
+	loop.gains( 0.2, 200.0 );
+	loop.setpoint( 0.020 );		//	over the compliance limit
+	CHECK( loop.start( rate ) );
+
+	wait( 0.5 );
+
+	CHECK_EQ( loop.output_code(), -code_max - (1 << 6) );	//	code_min: DAC code is negative for positive current
+	CHECK( fabs( loop.current() - 0.015 ) < 2 * dac_lsb );
+
+	//	integral is limited while saturated: back in range as soon as the setpoint is reachable
+
+	loop.setpoint( 0.010 );
+
+	int	n	= settle( loop, 0.010, 2 * dac_lsb, 500 );
+
+	printf( "  after 500 ms saturated: settled to 10 mA in %d cycles\n", n );
+
+	CHECK( 0 <= n );
+	CHECK( n < 100 );
+
+	loop.stop();
+}
+
+TEST( ticker_is_not_taken_from_other_user )
+{
+	LoopSimulator	sim;
+	NAFE33352_UIOM	afe( sim );
+	CurrentLoop		loop( afe, channel, sense );
+	DACPlayback		player( afe );
+	int32_t			table[ 4 ];
+	const double	values[ 4 ]	= { 0.000, 0.004, 0.008, 0.012 };
+
+	setup( sim, afe );
+
+	afe.dac.codes( values, table, 4 );
+	player.queue( table, 4 );
+
+	CHECK( player.start( rate, true ) );
+	CHECK( !loop.start( rate ) );
+
+	wait( 0.010 );
+
+	CHECK_EQ( player.update_count(), 10 );
+	CHECK_EQ( loop.cycle_count(), 0 );
+
+	//	restart of own user is allowed
+
+	CHECK( player.start( rate / 2, true ) );
+
+	player.stop();
+
+	loop.setpoint( 0.005 );
+	CHECK( loop.start( rate ) );
+	CHECK( !player.start( rate ) );
+	CHECK( loop.start( rate ) );
+
+	wait( 0.010 );
+
+	CHECK_EQ( loop.cycle_count(), 10 );
+
+	loop.stop();
+	CHECK( !Ticker::in_use() );
+}
+
+int main( void )
+{
+	return run_tests();
+}
@@ -0,0 +1,348 @@
+/** Host test of DACCalibration on AFE_simulator and M24C02 model
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2026 Tedd OKANO
+ *  Released under the MIT license
+ *
+ *	DAC output is modeled from AO_DATA and the coefficient registers, with gain, offset and bow (INL) error.
+ *	It is given to logical channel 0 as DC input, as the read-back through a sense resistor.
+ *	sweep(): fit against least squares in double, calibrated output, coefficients restored if the fit is invalid.
+ *	save()/load(): record round trip and CRC check on an M24C02 model served by the LPI2C mock.
+ */
+
+#include	"test.h"
+#include	"r01lib.h"
+#include	"afe/NAFE33352_UIOM.h"
+#include	"afe/AFE_simulator.h"
+#include	"afe/DACCalibration.h"
+#include	"misc/eeprom/M24C02.h"
+#include	<math.h>
+
+using enum	NAFE33352_Base::Register24;
+
+constexpr int		channel			= 0;
+constexpr double	sense			= 250.0;		//	ohm
+constexpr int32_t	unity_gain		= 0x400000;
+
+static int32_t sign_extend24( uint32_t v )
+{
+	return (int32_t)(v << 8) >> 8;
+}
+
+/** NAFE33352 simulator with DAC output read back on a logical channel
+ *
+ *	Device applies coefficient set 1 on AO_DATA: code * GAIN_COEF1 / 2^22 - OFFSET_COEF1.
+ *	This is the relation DACCalibration uses (as shasta_co_calibration)
+ */
+class DACSimulator : public AFE_simulator
+{
+public:
+	DACSimulator() : AFE_simulator( MODEL_NAFE33352 ) {}
+
+	virtual status_t write( uint8_t *wp, uint8_t *rp, int length )
+	{
+		uint16_t	word	= ((wp[ 0 ] << 8) | wp[ 1 ]) & 0x7FFF;
+		uint16_t	addr	= (word & 0x3FFE) >> 1;
+		uint32_t	value	= 0;
+
+		for ( auto i = 2; i < length; i++ )
+			value	= (value << 8) | wp[ i ];
+
+		status_t	r	= AFE_simulator::write( wp, rp, length );
+
+		if ( (5 == length) && !(word & 0x4000) )
+		{
+			if ( addr == static_cast<uint16_t>( NAFE33352_Base::Register24::AO_DATA ) )
+				ao_data		= value;
+			else if ( addr == static_cast<uint16_t>( GAIN_COEF1 ) )
+				gain_coef	= value;
+			else if ( addr == static_cast<uint16_t>( OFFSET_COEF1 ) )
+				offset_coef	= value;
+			else
+				return r;
+
+			waveform( channel, DC, (int32_t)lround( output( ao_data ) * sense / lsb ) );
+		}
+
+		return r;
+	}
+
+	/** Output current for AO_DATA with present coefficients */
+	double output( uint32_t code )
+	{
+		double	corrected	= (double)sign_extend24( code ) * sign_extend24( gain_coef ) / unity_gain - sign_extend24( offset_coef );
+		double	x			= -corrected * full_scale / (double)(1 << 23);
+
+		return gain * x + offset + bow * x * x;
+	}
+
+	double		gain		= 1.02;
+	double		offset		= 0.0003;	//	A
+	double		bow			= 0.05;		//	A^-1: 20 uA INL at 20 mA
+	double		full_scale	= 0.00;
+	double		lsb			= 0.00;		//	V per ADC code of the channel
+
+	uint32_t	ao_data		= 0;
+	uint32_t	gain_coef	= unity_gain;
+	uint32_t	offset_coef	= 0;
+};
+
+/** M24C02 on I2C: address pointer, sequential read and page write wrapping in 16 bytes */
+class EEPROM_model
+{
+public:
+	EEPROM_model()
+	{
+		memset( mem, 0xFF, sizeof( mem ) );
+
+		host::lpi2c::device	= [ this ]( uint8_t address, bool read, uint8_t *data, size_t length )
+		{
+			if ( address != (0xA0 >> 1) )
+				return false;
+
+			if ( read )
+			{
+				for ( size_t i = 0; i < length; i++ )
+					data[ i ]	= mem[ pointer++ ];
+			}
+			else if ( length )
+			{
+				pointer	= data[ 0 ];
+
+				if ( 1 < length )
+					writes++;
+
+				for ( size_t i = 1; i < length; i++ )
+				{
+					mem[ pointer ]	= data[ i ];
+					pointer			= (pointer & ~(M24C02::page_size - 1)) | ((pointer + 1) & (M24C02::page_size - 1));
+				}
+			}
+
+			return true;
+		};
+	}
+
+	uint8_t		mem[ M24C02::size ];
+	uint8_t		pointer	= 0;
+	int			writes	= 0;
+};
+
+static void setup( DACSimulator &sim, NAFE33352_UIOM &afe )
+{
+	afe.begin();
+	afe.use_DRDY_trigger( false );
+
+	afe.dac.configure( NAFE33352_Base::DAC::ModeSelect::CURRENT );
+	afe.logical_channel[ channel ].configure( 0x0008, 0x0084, 0x2900 );
+
+	sim.full_scale	= afe.dac.full_scale_range();
+	sim.lsb			= afe.raw2v( channel, 1 );
+
+	afe.reg( GAIN_COEF1,   unity_gain );
+	afe.reg( OFFSET_COEF1, 0 );
+}
+
+/** Value read back on the channel */
+static double measured( NAFE33352_UIOM &afe )
+{
+	return afe.raw2v( channel, afe.start_and_read( channel ) ) / sense;
+}
+
+const double	points[]	= { 0.020, -0.020, -0.010, 0.000, 0.010 };	//	sweep() sorts them
+
+TEST( sweep_fit_against_least_squares )
+{
+	DACSimulator	sim;
+	NAFE33352_UIOM	afe( sim );
+	DACCalibration	cal( afe, channel, 1.0 / sense );
+
+	setup( sim, afe );
+
+	CHECK_EQ( cal.sweep( points, 5, 0.001, 2 ), 0 );
+
+	const DACCalibration::result_t	&r	= cal.result();
+
+	//	reference: same DAC codes and ADC codes, fitted in double
+
+	double	x[ 5 ]	= { -0.020, -0.010, 0.000, 0.010, 0.020 };
+	int32_t	code[ 5 ];
+	double	y[ 5 ];
+	double	sx	= 0, sy	= 0, sxx	= 0, sxy	= 0;
+
+	afe.dac.codes( x, code, 5 );
+
+	for ( auto i = 0; i < 5; i++ )
+	{
+		y[ i ]	= lround( (sim.gain * (-(double)code[ i ] * sim.full_scale / (double)(1 << 23)) + sim.offset
+				+ sim.bow * pow( -(double)code[ i ] * sim.full_scale / (double)(1 << 23), 2 )) * sense / sim.lsb ) * sim.lsb / sense;
+
+		sx	+= x[ i ];
+		sy	+= y[ i ];
+		sxx	+= x[ i ] * x[ i ];
+		sxy	+= x[ i ] * y[ i ];
+	}
+
+	double	gain	= (5 * sxy - sx * sy) / (5 * sxx - sx * sx);
+	double	offset	= (sy - gain * sx) / 5;
+
+	printf( "  gain %.6f (reference %.6f), offset %.3f uA (reference %.3f uA), residual max %.3f uA\n",
+			r.gain, gain, r.offset * 1e6, offset * 1e6, r.residual_max * 1e6 );
+
+	CHECK( fabs( r.gain - gain ) < 1e-9 );
+	CHECK( fabs( r.offset - offset ) < 1e-12 );
+	CHECK_EQ( r.points, 5 );
+
+	for ( auto i = 0; i < 5; i++ )
+	{
+		CHECK( r.setpoint[ i ] == (float)x[ i ] );
+		CHECK( fabs( r.inl[ i ] - (y[ i ] - (gain * x[ i ] + offset)) ) < 1e-9 );
+	}
+
+	//	fitted coefficients are written. Output is set to 0 after the sweep
+
+	CHECK_EQ( sim.gain_coef,   (uint32_t)r.gain_coef   & 0xFFFFFF );
+	CHECK_EQ( sim.offset_coef, (uint32_t)r.offset_coef & 0xFFFFFF );
+	CHECK_EQ( lround( unity_gain / r.gain ), r.gain_coef );
+	CHECK( fabs( r.gain - sim.gain ) < 1e-4 );
+	CHECK_EQ( sim.ao_data, 0 );
+
+	//	calibrated output: error is INL without compensation, DAC resolution with it.
+	//	INL table is measured on uncalibrated codes: coefficients move the code of a setpoint along the bow
+
+	double	dac_lsb	= sim.full_scale / (1 << 17);
+
+	for ( auto i = 0; i < 5; i++ )
+	{
+		afe.dac.output( x[ i ] );
+		double	raw			= measured( afe ) - x[ i ];
+
+		afe.dac.output( cal.compensate( x[ i ] ) );
+		double	compensated	= measured( afe ) - x[ i ];
+
+		double	shift		= fabs( sim.bow * (x[ i ] * x[ i ] - pow( (x[ i ] - r.offset) / r.gain, 2 )) );
+
+		printf( "  setpoint %+.3f A: error %+8.3f uA, %+8.3f uA compensated (limit %.3f uA)\n", x[ i ], raw * 1e6, compensated * 1e6, (2 * dac_lsb + shift) * 1e6 );
+
+		CHECK( fabs( raw - r.inl[ i ] ) < 2 * dac_lsb + shift );
+		CHECK( fabs( compensated ) < 2 * dac_lsb + shift );
+	}
+}
+
+TEST( sweep_restores_coefficients_on_failure )
+{
+	DACSimulator	sim;
+	NAFE33352_UIOM	afe( sim );
+	DACCalibration	cal( afe, channel, 1.0 / sense );
+
+	setup( sim, afe );
+
+	afe.reg( GAIN_COEF1,   0x3F0000 );
+	afe.reg( OFFSET_COEF1, 0x000123 );
+
+	//	invalid arguments: no register access
+
+	sim.reset_counters();
+	CHECK_EQ( cal.sweep( points, 1 ), -1 );
+	CHECK_EQ( cal.sweep( points, DACCalibration::max_points + 1 ), -1 );
+	CHECK_EQ( cal.sweep( points, 5, 0.001, 0 ), -1 );
+	CHECK_EQ( sim.frame_count(), 0 );
+
+	//	gain out of GAIN_COEFn range
+
+	sim.gain	= 3.0;
+
+	CHECK_EQ( cal.sweep( points, 5, 0.001, 1 ), -1 );
+	CHECK_EQ( sim.gain_coef,   0x3F0000 );
+	CHECK_EQ( sim.offset_coef, 0x000123 );
+	CHECK_EQ( afe.reg( GAIN_COEF1 ),   0x3F0000 );
+	CHECK_EQ( afe.reg( OFFSET_COEF1 ), 0x000123 );
+	CHECK_EQ( sim.ao_data, 0 );
+
+	//	no output change: all setpoints give same value
+
+	sim.gain	= 0.0;
+
+	CHECK_EQ( cal.sweep( points, 5, 0.001, 1 ), -1 );
+	CHECK_EQ( sim.gain_coef,   0x3F0000 );
+	CHECK_EQ( sim.offset_coef, 0x000123 );
+
+	//	result is not changed
+
+	CHECK( cal.result().gain == 1.00 );
+	CHECK_EQ( cal.result().gain_coef, unity_gain );
+	CHECK_EQ( cal.result().points, 0 );
+}
+
+TEST( save_load_round_trip )
+{
+	DACSimulator	sim;
+	NAFE33352_UIOM	afe( sim );
+	I2C				i2c( I2C_SDA, I2C_SCL );
+	EEPROM_model	model;
+	M24C02			eeprom( i2c );
+	DACCalibration	cal( afe, channel, 1.0 / sense );
+
+	setup( sim, afe );
+
+	CHECK_EQ( DACCalibration::record_size, 154 );
+	CHECK_EQ( cal.sweep( points, 5, 0.001, 1 ), 0 );
+
+	CHECK_EQ( cal.save( eeprom, 0 ), 0 );
+	CHECK_EQ( model.writes, (DACCalibration::record_size + M24C02::page_size - 1) / M24C02::page_size );
+
+	const DACCalibration::result_t	&s	= cal.result();
+	DACCalibration					loaded( afe, channel, 1.0 / sense );
+
+	CHECK_EQ( loaded.load( eeprom, 0 ), 0 );
+
+	const DACCalibration::result_t	&r	= loaded.result();
+
+	CHECK( r.gain   == (float)s.gain );
+	CHECK( r.offset == (float)s.offset );
+	CHECK_EQ( r.gain_coef,   s.gain_coef );
+	CHECK_EQ( r.offset_coef, s.offset_coef );
+	CHECK_EQ( r.points, s.points );
+
+	for ( auto i = 0; i < s.points; i++ )
+	{
+		CHECK( r.setpoint[ i ] == s.setpoint[ i ] );
+		CHECK( r.inl[ i ]      == s.inl[ i ] );
+	}
+
+	//	record of other coefficient set is not taken
+
+	DACCalibration	other( afe, channel, 1.0 / sense, 2 );
+
+	CHECK_EQ( other.load( eeprom, 0 ), -1 );
+
+	//	a bit flip is detected by CRC. Result is not changed
+
+	DACCalibration	broken( afe, channel, 1.0 / sense );
+
+	model.mem[ 40 ]	^= 0x01;
+
+	CHECK_EQ( broken.load( eeprom, 0 ), -1 );
+	CHECK_EQ( broken.result().points, 0 );
+	CHECK_EQ( broken.result().gain_coef, unity_gain );
+
+	//	address must be on a page boundary and the record must fit in the device. Nothing is written if not
+
+	model.writes	= 0;
+
+	CHECK_EQ( cal.save( eeprom, 8 ), -1 );
+	CHECK_EQ( cal.save( eeprom, 112 ), -1 );
+	CHECK_EQ( cal.save( eeprom, -16 ), -1 );
+	CHECK_EQ( model.writes, 0 );
+	CHECK_EQ( loaded.load( eeprom, 160 ), -1 );
+
+	CHECK_EQ( cal.save( eeprom, 96 ), 0 );
+	CHECK_EQ( loaded.load( eeprom, 96 ), 0 );
+	CHECK_EQ( loaded.result().gain_coef, s.gain_coef );
+}
+
+int main( void )
+{
+	return run_tests();
+}
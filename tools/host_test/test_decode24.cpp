@@ -0,0 +1,124 @@
+/** Host test and benchmark of SPI_for_AFE::decode24()
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2026 Tedd OKANO
+ *  Released under the MIT license
+ *
+ *	decode24() is compared with previous decoder: get_data24() called for each sample.
+ */
+
+#include	"test.h"
+#include	"r01lib.h"
+#include	"afe/SPI_for_AFE.h"
+#include	<chrono>
+#include	<random>
+
+struct	decoder_access : SPI_for_AFE
+{
+	using	SPI_for_AFE::get_data24;
+};
+
+/** Previous decoder */
+__attribute__((noinline)) static void decode_per_sample( const uint8_t *src, int32_t *dst, int length )
+{
+	for ( auto i = 0; i < length; i++ )
+		dst[ i ]	= decoder_access::get_data24( (uint8_t *)src + i * 3 );
+}
+
+__attribute__((noinline)) static void decode_block( const uint8_t *src, int32_t *dst, int length )
+{
+	SPI_for_AFE::decode24( src, dst, length );
+}
+
+TEST( decode24_matches_per_sample_decoder )
+{
+	//	random data, every length up to 16 channels, every source alignment
+
+	std::mt19937	rng( 6 );
+	uint8_t			buf[ 3 * 16 + 8 ];
+	int32_t			expect[ 16 ];
+	int32_t			result[ 16 + 1 ];
+	int				mismatch	= 0;
+
+	for ( auto iteration = 0; iteration < 20000; iteration++ )
+	{
+		for ( auto &b : buf )
+			b	= rng();
+
+		int		length	= iteration % 17;
+		int		offset	= (iteration / 17) % 4;
+
+		result[ length ]	= 0x5A5A5A5A;	//	guard
+
+		decode_per_sample( buf + offset, expect, length );
+		decode_block( buf + offset, result, length );
+
+		mismatch	+= !!memcmp( expect, result, length * sizeof( int32_t ) );
+		mismatch	+= (0x5A5A5A5A != result[ length ]);
+	}
+
+	CHECK_EQ( mismatch, 0 );
+}
+
+TEST( decode24_boundary_values )
+{
+	const int32_t	values[]	= { 0, 1, -1, 0x7FFFFF, -0x800000, 0x800000 - 2, -0x7FFFFF, 0x123456, -0x123456, 0x00FF00, -256, 255 };
+	constexpr int	n			= sizeof( values ) / sizeof( values[ 0 ] );
+	uint8_t			buf[ 3 * n ];
+	int32_t			result[ n ];
+
+	for ( auto i = 0; i < n; i++ )
+	{
+		buf[ i * 3 + 0 ]	= values[ i ] >> 16;
+		buf[ i * 3 + 1 ]	= values[ i ] >>  8;
+		buf[ i * 3 + 2 ]	= values[ i ] >>  0;
+	}
+
+	SPI_for_AFE::decode24( buf, result, n );
+
+	for ( auto i = 0; i < n; i++ )
+		CHECK_EQ( result[ i ], values[ i ] );
+}
+
+TEST( decode24_benchmark )
+{
+	constexpr int	repeat	= 200000;
+	std::mt19937	rng( 1 );
+	uint8_t			buf[ 3 * 16 ];
+	int32_t			dst[ 16 ];
+
+	for ( auto &b : buf )
+		b	= rng();
+
+	auto	measure	= [ & ]( void (*f)( const uint8_t *, int32_t *, int ), int length )
+	{
+		volatile int32_t	sink	= 0;
+		auto				start	= std::chrono::steady_clock::now();
+
+		for ( auto r = 0; r < repeat; r++ )
+		{
+			f( buf, dst, length );
+			sink	= sink + dst[ length - 1 ];
+		}
+
+		std::chrono::duration<double, std::nano>	t	= std::chrono::steady_clock::now() - start;
+
+		return t.count() / repeat;
+	};
+
+	printf( "  channels  per-sample [ns/frame]  decode24 [ns/frame]\n" );
+
+	for ( auto length : { 1, 4, 8, 16 } )
+	{
+		double	old_t	= measure( decode_per_sample, length );
+		double	new_t	= measure( decode_block, length );
+
+		printf( "  %8d  %21.2f  %19.2f\n", length, old_t, new_t );
+	}
+}
+
+int main( void )
+{
+	return run_tests();
+}
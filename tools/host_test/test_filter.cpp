@@ -0,0 +1,223 @@
+/** Host test of ChannelFilter stages against double-precision and brute-force references
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2026 Tedd OKANO
+ *  Released under the MIT license
+ *
+ *	Biquad: DC gain of lowpass()/highpass() over fc/fs, and impulse response against the same filter in double.
+ *	CIC: DC gain and output against cascaded moving sums. Median: output against sorting each window.
+ *	All stages run on interleaved multi-channel blocks, channels with different input.
+ */
+
+#include	"test.h"
+#include	"afe/ChannelFilter.h"
+#include	<algorithm>
+#include	<math.h>
+
+static constexpr int	channels	= 3;
+
+/** Deterministic test input in 24 bit range */
+static int32_t random24( uint32_t &seed )
+{
+	seed	= seed * 1664525 + 1013904223;	//	LCG
+	return (int32_t)seed >> 8;
+}
+
+/** Run a stage on a single channel signal, duplicated into all channels with sign and offset changes */
+template<class F>
+static std::vector<int32_t> run( F &filter, const std::vector<int32_t> &x, int block, int ch = 0 )
+{
+	std::vector<int32_t>	y;
+	std::vector<int32_t>	buf( block * channels );
+
+	for ( size_t f = 0; f < x.size(); f += block )
+	{
+		int	n	= std::min( (int)(x.size() - f), block );
+
+		for ( auto i = 0; i < n; i++ )
+			for ( auto c = 0; c < channels; c++ )
+				buf[ i * channels + c ]	= (c == ch) ? x[ f + i ] : -x[ f + i ] / 2 + c;
+
+		n	= filter.process( buf.data(), n, channels );
+
+		for ( auto i = 0; i < n; i++ )
+			y.push_back( buf[ i * channels + ch ] );
+	}
+
+	return y;
+}
+
+TEST( biquad_dc_gain )
+{
+	const double	ratio[]	= { 0.2, 0.05, 0.01, 0.001, 0.0001 };
+	const int32_t	level[]	= { 0x7FFFFF, -0x800000, 12345, -1 };
+
+	for ( auto r : ratio )
+	{
+		Biquad<channels>::coeff_t	lp	= Biquad<channels>::lowpass(  r, 1.0 );
+		Biquad<channels>::coeff_t	hp	= Biquad<channels>::highpass( r, 1.0 );
+
+		CHECK_EQ( (int64_t)lp.b0 + lp.b1 + lp.b2, (1LL << Biquad<channels>::q) + lp.a1 + lp.a2 );
+		CHECK_EQ( (int64_t)hp.b0 + hp.b1 + hp.b2, 0 );
+
+		for ( auto v : level )
+		{
+			Biquad<channels>	low;
+			Biquad<channels>	high;
+
+			low.coefficients( lp );
+			high.coefficients( hp );
+
+			int						settle	= (int)(20.0 / r);
+			std::vector<int32_t>	x( settle, v );
+			auto					yl		= run( low,  x, 64 );
+			auto					yh		= run( high, x, 64 );
+
+			printf( "  fc/fs %-7g input %8d : low-pass %8d, high-pass %3d\n", r, v, yl.back(), yh.back() );
+			CHECK_EQ( yl.back(), v );
+			CHECK_EQ( yh.back(), 0 );
+		}
+	}
+}
+
+TEST( biquad_impulse_response )
+{
+	constexpr int		length	= 2000;
+	constexpr int32_t	impulse	= 1 << 22;
+	const double		ratio[]	= { 0.2, 0.05, 0.01, 0.001, 0.0001 };
+
+	for ( auto r : ratio )
+	{
+		for ( auto high : { false, true } )
+		{
+			//	reference: RBJ design evaluated in double
+
+			double	w		= 2.00 * M_PI * r;
+			double	alpha	= sin( w ) / (2.00 * 0.7071);
+			double	a0		= 1.00 + alpha;
+			double	cw		= cos( w );
+			double	b0		= (high ? (1.00 + cw) : (1.00 - cw)) / 2.00 / a0;
+			double	b[ 3 ]	= { b0, high ? -2.00 * b0 : 2.00 * b0, b0 };
+			double	a[ 2 ]	= { -2.00 * cw / a0, (1.00 - alpha) / a0 };
+
+			Biquad<channels>	filter;
+			filter.coefficients( high ? Biquad<channels>::highpass( r, 1.0 ) : Biquad<channels>::lowpass( r, 1.0 ) );
+
+			std::vector<int32_t>	x( length, 0 );
+			x[ 0 ]	= impulse;
+
+			auto	y		= run( filter, x, 50 );
+			double	x1		= 0, x2 = 0, y1 = 0, y2 = 0;
+			double	error	= 0;
+			double	peak	= 0;
+
+			for ( auto n = 0; n < length; n++ )
+			{
+				double	ref	= b[ 0 ] * x[ n ] + b[ 1 ] * x1 + b[ 2 ] * x2 - a[ 0 ] * y1 - a[ 1 ] * y2;
+
+				x2	= x1;
+				x1	= x[ n ];
+				y2	= y1;
+				y1	= ref;
+
+				error	= std::max( error, fabs( y[ n ] - ref ) );
+				peak	= std::max( peak, fabs( ref ) );
+			}
+
+			//	with error shaping, output rounding stays within a few LSB even for poles near z = 1
+
+			constexpr double	limit	= 2.0;
+
+			printf( "  fc/fs %-7g %s : max error %7.3f LSB (limit %6.3f), peak %9.1f\n", r, high ? "high-pass" : "low-pass ", error, limit, peak );
+			CHECK( error <= limit );
+		}
+	}
+}
+
+/** Brute-force CIC: ORDER moving sums of R samples, every R-th output, rounded division by R ^ ORDER */
+static std::vector<int32_t> cic_reference( const std::vector<int32_t> &x, int R, int order )
+{
+	std::vector<int64_t>	v( x.begin(), x.end() );
+	int64_t					gain	= 1;
+
+	for ( auto s = 0; s < order; s++ )
+	{
+		std::vector<int64_t>	sum( v.size(), 0 );
+
+		for ( size_t n = 0; n < v.size(); n++ )
+			for ( auto k = 0; (k < R) && (k <= (int)n); k++ )
+				sum[ n ]	+= v[ n - k ];
+
+		v		 = sum;
+		gain	*= R;
+	}
+
+	std::vector<int32_t>	y;
+
+	for ( size_t n = R - 1; n < v.size(); n += R )
+		y.push_back( (int32_t)((v[ n ] + ((v[ n ] < 0) ? -gain / 2 : gain / 2)) / gain) );
+
+	return y;
+}
+
+TEST( cic_against_reference )
+{
+	uint32_t				seed	= 1;
+	std::vector<int32_t>	x( 16 * 40 );
+
+	for ( auto &v : x )
+		v	= random24( seed );
+
+	CIC<16, 3, channels>	cic3;
+	CIC<4, 5, channels>		cic5;
+
+	//	block size not multiple of R: decimation phase continues over blocks
+
+	CHECK( run( cic3, x, 37 ) == cic_reference( x, 16, 3 ) );
+	CHECK( run( cic5, x, 10 ) == cic_reference( x, 4, 5 ) );
+
+	//	DC gain: output equals input after the filter is filled
+
+	for ( auto v : { 0x7FFFFF, -0x800000, 1, -1 } )
+	{
+		CIC<16, 3, channels>	cic;
+		std::vector<int32_t>	dc( 16 * 10, v );
+		auto					y	= run( cic, dc, 64 );
+
+		CHECK_EQ( y.size(), 10 );
+
+		for ( size_t i = 3; i < y.size(); i++ )
+			CHECK_EQ( y[ i ], v );
+	}
+}
+
+TEST( median_against_reference )
+{
+	uint32_t				seed	= 7;
+	std::vector<int32_t>	x( 500 );
+
+	for ( auto &v : x )
+		v	= random24( seed ) / 0x10000;	//	narrow range gives equal values in window
+
+	Median<5, channels>	median;
+	auto				y	= run( median, x, 23, 1 );
+
+	//	window is filled by first sample at start
+
+	for ( size_t n = 0; n < x.size(); n++ )
+	{
+		int32_t	w[ 5 ];
+
+		for ( auto k = 0; k < 5; k++ )
+			w[ k ]	= (n < (size_t)k) ? x[ 0 ] : x[ n - k ];
+
+		std::sort( w, w + 5 );
+		CHECK_EQ( y[ n ], w[ 2 ] );
+	}
+}
+
+int main( void )
+{
+	return run_tests();
+}
@@ -0,0 +1,157 @@
+/** Host test of fixed-point raw2nv() against floating-point raw2v()
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2026 Tedd OKANO
+ *  Released under the MIT license
+ *
+ *	Channels are configured through the drivers on AFE_simulator for every gain and input setting.
+ *	Error limit is 1 nV plus 2^-38 of full-scale: fixed_coeff() keeps full-scale below 2^60 in int64 intermediate,
+ *	so the scale has less fractional bits for larger full-scale. The limit is below 5 nV for full-scale up to 1 kV.
+ *	Time per conversion is shown for reference.
+ */
+
+#include	"test.h"
+#include	"r01lib.h"
+#include	"afe/NAFE13388_UIM.h"
+#include	"afe/NAFE33352_UIOM.h"
+#include	"afe/AFE_simulator.h"
+#include	<math.h>
+#include	<chrono>
+#include	<random>
+
+static std::vector<AFE_base::raw_t> test_values( void )
+{
+	constexpr int32_t	max	= (1 << 23) - 1;
+	constexpr int32_t	min	= -(1 << 23);
+
+	std::vector<AFE_base::raw_t>	v	= { min, min + 1, -1000000, -4097, -1, 0, 1, 2, 4095, 1000000, max - 1, max };
+	std::mt19937					rng( 1 );
+
+	for ( auto i = 0; i < 2000; i++ )
+		v.push_back( (int32_t)(rng() & 0xFFFFFF) - (1 << 23) );
+
+	return v;
+}
+
+/** Largest error in nano-volt from rounded raw2v() * 1e9 */
+static double max_error( AFE_base &afe, int ch, const std::vector<AFE_base::raw_t> &values )
+{
+	double	e	= 0;
+
+	for ( auto raw : values )
+	{
+		double	ref	= afe.raw2v( ch, raw ) * 1e9;
+		double	d	= fabs( (double)afe.raw2nv( ch, raw ) - ref );
+
+		//	reference itself has 53 bit precision
+
+		e	= std::max( e, d - fabs( ref ) * 0x1p-52 );
+	}
+
+	return e;
+}
+
+/** Error limit in nano-volt */
+static double error_limit( AFE_base &afe, int ch )
+{
+	double	fs	= std::max( fabs( afe.raw2v( ch, -(1 << 23) ) ), fabs( afe.raw2v( ch, (1 << 23) - 1 ) ) ) * 1e9;
+
+	return 1.0 + fs * 0x1p-38;
+}
+
+/** Time per conversion in nano-second */
+template<class F>
+static double time_per_call( F f, const std::vector<AFE_base::raw_t> &values )
+{
+	constexpr int	repeat	= 200;
+	volatile double	sink	= 0;
+
+	auto	start	= std::chrono::steady_clock::now();
+
+	for ( auto r = 0; r < repeat; r++ )
+		for ( auto raw : values )
+			sink	= sink + (double)f( raw );
+
+	std::chrono::duration<double, std::nano>	t	= std::chrono::steady_clock::now() - start;
+
+	return t.count() / (repeat * values.size());
+}
+
+TEST( nafe13388_all_gains_and_inputs )
+{
+	AFE_simulator	sim( AFE_simulator::MODEL_NAFE13388 );
+	NAFE13388_UIM	afe( sim );
+	auto			values	= test_values();
+
+	afe.begin();
+
+	//	HV input: PGA gain x0.2 ~ x16
+
+	for ( auto gain = 0; gain < 8; gain++ )
+	{
+		uint16_t	cc0	= 0x1010 | (gain << 5);
+
+		afe.logical_channel[ 0 ].configure( cc0, 0x0084, 0x2900, 0x0000 );
+
+		double	e	= max_error( afe, 0, values );
+		double	l	= error_limit( afe, 0 );
+
+		printf( "  NAFE13388 CH_CONFIG0 = 0x%04X (gain x%-4g) : max error %.3f nV (limit %.3f)\n", cc0, NAFE13388_Base::pga_gain[ gain ], e, l );
+		CHECK( e <= l );
+	}
+
+	//	LV input: every multiplexer setting, including the ones with offset
+
+	for ( auto mux = 0; mux < 8; mux++ )
+	{
+		uint16_t	cc0	= mux << 1;
+
+		afe.logical_channel[ 1 ].configure( cc0, 0x0084, 0x2900, 0x0000 );
+
+		double	e	= max_error( afe, 1, values );
+		double	l	= error_limit( afe, 1 );
+
+		printf( "  NAFE13388 CH_CONFIG0 = 0x%04X (LV mux %d)    : max error %.3f nV (limit %.3f)\n", cc0, mux, e, l );
+		CHECK( e <= l );
+	}
+
+	double	t_nv	= time_per_call( [ & ]( AFE_base::raw_t r ){ return afe.raw2nv( 0, r ); }, values );
+	double	t_v		= time_per_call( [ & ]( AFE_base::raw_t r ){ return afe.raw2v( 0, r ); }, values );
+
+	printf( "  host time per conversion: raw2nv() %.2f ns, raw2v() %.2f ns\n", t_nv, t_v );
+}
+
+TEST( nafe33352_all_gains_and_inputs )
+{
+	AFE_simulator	sim( AFE_simulator::MODEL_NAFE33352 );
+	NAFE33352_UIOM	afe( sim );
+	auto			values	= test_values();
+
+	afe.begin();
+
+	//	every input selection with both x16 gain bits
+
+	for ( auto mux = 0; mux < 19; mux++ )
+	{
+		for ( uint16_t gain_bits : { 0x0000, 0x0100, 0x0200 } )
+		{
+			uint16_t	cc0	= (mux << 3) | gain_bits;
+
+			afe.logical_channel[ 0 ].configure( cc0, 0x0084, 0x2900 );
+
+			double	e	= max_error( afe, 0, values );
+			double	l	= error_limit( afe, 0 );
+
+			if ( !gain_bits || (e > l) )
+				printf( "  NAFE33352 AI_CONFIG0 = 0x%04X (mux %2d)    : max error %.3f nV (limit %.3f)\n", cc0, mux, e, l );
+
+			CHECK( e <= l );
+		}
+	}
+}
+
+int main( void )
+{
+	return run_tests();
+}
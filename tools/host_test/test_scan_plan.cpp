@@ -0,0 +1,279 @@
+/** Host test of ScanPlan on a 12-channel mixed-rate requirement
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2026 Tedd OKANO
+ *  Released under the MIT license
+ *
+ *	Four channel groups from 1 kHz to 10 Hz cannot be met by scanning all channels in every cycle.
+ *	Chosen settings, slot masks, per-channel rates and margin are checked against values recomputed from the masks
+ *	and against a double-precision evaluation of every super-cycle length. A super-cycle is run on AFE_simulator.
+ */
+
+#include	"test.h"
+#include	"r01lib.h"
+#include	"afe/NAFE13388_UIM.h"
+#include	"afe/AFE_simulator.h"
+#include	"afe/ScanPlan.h"
+#include	<bit>
+#include	<math.h>
+
+static constexpr int	count	= 12;
+
+/** Requirements in mixed order: planner must sort by rate */
+static void requirements( ScanPlan::requirement *req, double scale = 1.0 )
+{
+	//	output rate, max data rate, SINC, settling
+	const ScanPlan::requirement	group[]	= {
+		{ {}, 1000.0, 48000, 0,  20e-6 },
+		{ {},  100.0, 12000, 0,  50e-6 },
+		{ {},   10.0,  1125, 0, 100e-6 },
+		{ {},   50.0,  4500, 1,  20e-6 },
+	};
+
+	for ( auto i = 0; i < count; i++ )
+	{
+		req[ i ]				= group[ i % 4 ];
+		req[ i ].cc[ 0 ]		= 0x1010 | ((i % 8) << 5);
+		req[ i ].cc[ 1 ]		= 0x0084;
+		req[ i ].cc[ 2 ]		= 0x2900;
+		req[ i ].cc[ 3 ]		= 0x0000;
+		req[ i ].output_rate	*= scale;
+	}
+}
+
+/** Margin of a super-cycle of "s" slots, evaluated in double from conversion times */
+static double reference_margin( ScanPlan &plan, const ScanPlan::requirement *req, int s )
+{
+	double	rate_max	= 0.0;
+	double	period		= 0.0;
+	int		n[ count ];
+
+	for ( auto i = 0; i < count; i++ )
+		rate_max	= std::max( rate_max, req[ i ].output_rate );
+
+	for ( auto i = 0; i < count; i++ )
+	{
+		n[ i ]	= 1;
+
+		while ( (n[ i ] < s) && (n[ i ] < s * req[ i ].output_rate / rate_max) )
+			n[ i ]	*= 2;
+
+		period	+= n[ i ] * plan.conversion_time( i );
+	}
+
+	double	margin	= 1e300;
+
+	for ( auto i = 0; i < count; i++ )
+		margin	= std::min( margin, n[ i ] / period / req[ i ].output_rate );
+
+	return margin;
+}
+
+TEST( settings_meet_requirements )
+{
+	AFE_simulator			sim( AFE_simulator::MODEL_NAFE13388 );
+	NAFE13388_UIM			afe( sim );
+	ScanPlan				plan( afe );
+	ScanPlan::requirement	req[ count ];
+
+	requirements( req );
+	CHECK_EQ( plan.plan( req, count ), 0 );
+
+	for ( auto i = 0; i < count; i++ )
+	{
+		const uint16_t	*cc		= plan.setting( i );
+		uint8_t			rate	= (cc[ 1 ] >> 3) & 0x1F;
+		uint8_t			delay	= (cc[ 2 ] >> 10) & 0x3F;
+
+		CHECK_EQ( cc[ 0 ], req[ i ].cc[ 0 ] );
+		CHECK_EQ( cc[ 3 ], req[ i ].cc[ 3 ] );
+		CHECK_EQ( cc[ 1 ] & 0x0007, req[ i ].sinc );
+		CHECK_EQ( cc[ 2 ] & 0x0200, 0 );		//	ADC_NORMAL_SETTING cleared for single-cycle settling
+		CHECK( plan.conversion_time( i ) == AFE_base::conversion_time( cc[ 1 ], cc[ 2 ] ) );
+
+		//	fastest data rate within the noise limit
+
+		CHECK( 1.0 / AFE_base::conversion_time( rate << 3, 0x0200 ) <= req[ i ].max_data_rate );
+		CHECK( (req[ i ].sinc ? 12 : 0) == rate || req[ i ].max_data_rate < 1.0 / AFE_base::conversion_time( (rate - 1) << 3, 0x0200 ) );
+
+		//	shortest delay covering the settling time
+
+		double	base	= AFE_base::conversion_time( cc[ 1 ], 0x0000 );
+
+		CHECK( req[ i ].settling <= AFE_base::conversion_time( cc[ 1 ], delay << 10 ) - base );
+		CHECK( 0 == delay || AFE_base::conversion_time( cc[ 1 ], (delay - 1) << 10 ) - base < req[ i ].settling );
+	}
+}
+
+TEST( slot_masks_rates_and_margin )
+{
+	AFE_simulator			sim( AFE_simulator::MODEL_NAFE13388 );
+	NAFE13388_UIM			afe( sim );
+	ScanPlan				plan( afe );
+	ScanPlan::requirement	req[ count ];
+
+	requirements( req );
+	CHECK_EQ( plan.plan( req, count ), 0 );
+
+	int		s		= plan.slots();
+	int		req_of[ 16 ];
+	double	t_max	= 0.0;
+
+	//	logical channels are a permutation, faster requirements on lower channel numbers
+
+	for ( auto ch = 0; ch < 16; ch++ )
+		req_of[ ch ]	= -1;
+
+	for ( auto i = 0; i < count; i++ )
+	{
+		CHECK( (0 <= plan.channel( i )) && (plan.channel( i ) < count) );
+		CHECK_EQ( req_of[ plan.channel( i ) ], -1 );
+		req_of[ plan.channel( i ) ]	= i;
+		t_max	= std::max( t_max, plan.conversion_time( i ) );
+	}
+
+	for ( auto ch = 1; ch < count; ch++ )
+		CHECK( req[ req_of[ ch ] ].output_rate <= req[ req_of[ ch - 1 ] ].output_rate );
+
+	//	cycle time and slot load from masks
+
+	double	cycle	= 0.0;
+	double	load_min	= 1e300;
+	double	load_max	= 0.0;
+
+	for ( auto k = 0; k < s; k++ )
+	{
+		uint16_t	m		= plan.slot_mask( k );
+		double		load	= 0.0;
+
+		CHECK_EQ( m & ~((1 << count) - 1), 0 );
+
+		for ( auto ch = 0; ch < count; ch++ )
+			if ( m & (1 << ch) )
+				load	+= plan.conversion_time( req_of[ ch ] );
+
+		cycle		+= load;
+		load_min	 = std::min( load_min, load );
+		load_max	 = std::max( load_max, load );
+	}
+
+	CHECK( fabs( plan.cycle_time() - cycle ) < 1e-12 );
+	CHECK( fabs( plan.frame_rate() - s / cycle ) < 1e-6 );
+	CHECK( load_max - load_min <= t_max );		//	decimated channels are spread over slots
+
+	//	each channel in evenly spaced slots, rate from the number of slots
+
+	double	margin	= 1e300;
+
+	for ( auto i = 0; i < count; i++ )
+	{
+		uint16_t	bit		= 1 << plan.channel( i );
+		int			n		= 0;
+		int			first	= -1;
+
+		for ( auto k = 0; k < s; k++ )
+		{
+			if ( plan.slot_mask( k ) & bit )
+			{
+				first	= (first < 0) ? k : first;
+				n++;
+			}
+		}
+
+		CHECK( std::has_single_bit( (unsigned)n ) );
+		CHECK( first < s / n );
+
+		for ( auto k = first; k < s; k += s / n )
+			CHECK( plan.slot_mask( k ) & bit );
+
+		CHECK( fabs( plan.output_rate( i ) - n / cycle ) < 1e-6 );
+		CHECK( req[ i ].output_rate <= plan.output_rate( i ) );
+
+		margin	= std::min( margin, plan.output_rate( i ) / req[ i ].output_rate );
+	}
+
+	//	chosen super-cycle gives the best margin, and single-slot scan does not meet the requirement
+
+	double	best	= 0.0;
+
+	for ( auto n = 1; n <= ScanPlan::max_slots; n *= 2 )
+		best	= std::max( best, reference_margin( plan, req, n ) );
+
+	printf( "  %d slots, cycle %.3f ms, margin %.3f (single slot: %.3f)\n", s, cycle * 1e3, margin, reference_margin( plan, req, 1 ) );
+
+	for ( auto k = 0; k < s; k++ )
+		printf( "  slot %2d: 0x%03X\n", k, plan.slot_mask( k ) );
+
+	CHECK( 1.0 <= margin );
+	CHECK( fabs( margin - best ) < 1e-9 );
+	CHECK( fabs( margin - reference_margin( plan, req, s ) ) < 1e-9 );
+	CHECK( reference_margin( plan, req, 1 ) < 1.0 );
+}
+
+TEST( infeasible_and_invalid_requirement )
+{
+	AFE_simulator			sim( AFE_simulator::MODEL_NAFE13388 );
+	NAFE13388_UIM			afe( sim );
+	ScanPlan				plan( afe );
+	ScanPlan::requirement	req[ count ];
+
+	requirements( req, 10.0 );
+
+	//	plan is made even if it cannot be met
+
+	CHECK_EQ( plan.plan( req, count ), -1 );
+	CHECK( 0.0 < plan.cycle_time() );
+	CHECK( plan.output_rate( 0 ) < req[ 0 ].output_rate );
+
+	//	out of range: previous plan is kept
+
+	int		s		= plan.slots();
+	double	cycle	= plan.cycle_time();
+
+	CHECK_EQ( plan.plan( req, 0 ), -2 );
+	CHECK_EQ( plan.plan( req, 17 ), -2 );
+	CHECK_EQ( plan.slots(), s );
+	CHECK( plan.cycle_time() == cycle );
+}
+
+TEST( super_cycle_on_simulator )
+{
+	AFE_simulator			sim( AFE_simulator::MODEL_NAFE13388 );
+	NAFE13388_UIM			afe( sim );
+	ScanPlan				plan( afe );
+	ScanPlan::requirement	req[ count ];
+
+	afe.begin();
+	afe.use_DRDY_trigger( false );
+
+	requirements( req );
+	CHECK_EQ( plan.plan( req, count ), 0 );
+
+	plan.apply();
+
+	for ( auto ch = 0; ch < count; ch++ )
+		sim.waveform( ch, AFE_simulator::DC, 1000 * (ch + 1) );
+
+	for ( auto k = 0; k < 2 * plan.slots(); k++ )
+	{
+		AFE_base::raw_t	data[ 16 ];
+		uint16_t		m	= plan.slot_mask( k );
+
+		CHECK_EQ( plan.slot(), k % plan.slots() );
+
+		plan.start();
+		plan.read( data );
+
+		CHECK_EQ( afe.enabled_logical_channels(), std::popcount( m ) );
+
+		for ( auto ch = 0, j = 0; ch < count; ch++ )
+			if ( m & (1 << ch) )
+				CHECK_EQ( data[ j++ ], 1000 * (ch + 1) );
+	}
+}
+
+int main( void )
+{
+	return run_tests();
+}
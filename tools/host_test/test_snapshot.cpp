@@ -0,0 +1,91 @@
+/** Host test of configuration snapshot and warm start on AFE_simulator
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2026 Tedd OKANO
+ *  Released under the MIT license
+ *
+ *	Snapshot taken from a ready device restores the channels without reset.
+ *	If device CRCs cannot be taken, snapshot() fails and leaves the snapshot invalid: warm start falls back to begin().
+ */
+
+#include	"test.h"
+#include	"r01lib.h"
+#include	"afe/NAFE13388_UIM.h"
+#include	"afe/AFE_simulator.h"
+
+/** Simulator which can report "chip not ready" on SYS_STATUS0 */
+class NotReadySimulator : public AFE_simulator
+{
+public:
+	NotReadySimulator() : AFE_simulator( MODEL_NAFE13388 ) {}
+
+	virtual status_t write( uint8_t *wp, uint8_t *rp, int length )
+	{
+		uint16_t	word	= ((wp[ 0 ] << 8) | wp[ 1 ]) & 0x7FFF;
+		status_t	r		= AFE_simulator::write( wp, rp, length );
+
+		if ( not_ready && (4 == length) && (word & 0x4000) && (0x0031 == ((word & 0x3FFE) >> 1)) )
+			rp[ 2 ]	= rp[ 3 ]	= 0;
+
+		return r;
+	}
+
+	bool	not_ready	= false;
+};
+
+TEST( snapshot_and_warm_start )
+{
+	NotReadySimulator			sim;
+	NAFE13388_UIM				afe( sim );
+	AFE_base::snapshot_t		snap;
+
+	afe.begin();
+	afe.use_DRDY_trigger( false );
+
+	for ( auto ch = 0; ch < 4; ch++ )
+		afe.logical_channel[ ch ].configure( 0x1070, 0x0084, 0x2900 );
+
+	CHECK( afe.snapshot( snap ) );
+	CHECK_EQ( snap.magic, AFE_base::snapshot_magic );
+	CHECK_EQ( snap.configured, 0x000F );
+
+	//	driver restarts on the same device: no reset and no replay
+
+	NAFE13388_UIM	restarted( sim );
+
+	CHECK_EQ( restarted.warm_start( snap ), 0 );
+	restarted.use_DRDY_trigger( false );
+
+	sim.waveform( 3, AFE_simulator::DC, 1234 );
+	CHECK_EQ( restarted.start_and_read( 3 ), 1234 );
+}
+
+TEST( snapshot_invalid_without_device_crc )
+{
+	NotReadySimulator			sim;
+	NAFE13388_UIM				afe( sim );
+	AFE_base::snapshot_t		snap;
+
+	afe.begin();
+	afe.use_DRDY_trigger( false );
+	afe.logical_channel[ 0 ].configure( 0x1070, 0x0084, 0x2900 );
+
+	sim.not_ready	= true;
+
+	CHECK( !afe.snapshot( snap ) );
+	CHECK_EQ( snap.magic, 0 );
+
+	//	warm start with it does begin()
+
+	sim.not_ready	= false;
+
+	NAFE13388_UIM	restarted( sim );
+
+	CHECK_EQ( restarted.warm_start( snap ), -1 );
+}
+
+int main( void )
+{
+	return run_tests();
+}
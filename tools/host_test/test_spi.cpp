@@ -0,0 +1,258 @@
+/** Host test of SPI non-blocking transfer (r01lib/spi.cpp) on LPSPI mock
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2026 Tedd OKANO
+ *  Released under the MIT license
+ */
+
+#include	"test.h"
+#include	"r01lib.h"
+
+typedef struct	_context	{
+	SPI			*spi;
+	int			calls;
+	status_t	status;
+	bool		in_isr;
+	int			order;
+	uint8_t		*tx;
+	uint8_t		*rx;
+	status_t	next_start;
+	int			next_calls;
+} context_t;
+
+static int	sequence;
+
+static void done( context_t &c, status_t status )
+{
+	c.calls++;
+	c.status	= status;
+	c.in_isr	= __get_IPSR();
+	c.order		= ++sequence;
+}
+
+TEST( nonblocking_transfer_completes_in_interrupt )
+{
+	SPI			spi;
+	context_t	c	= {};
+	uint8_t		tx[ 4 ]	= { 1, 2, 3, 4 };
+	uint8_t		rx[ 4 ]	= {};
+
+	host::lpspi::latency	= -1;
+
+	CHECK_EQ( spi.write_nonblocking( tx, rx, sizeof( tx ), [ &c ]( status_t s ){ done( c, s ); } ), kStatus_Success );
+	CHECK( spi.busy() );
+	CHECK_EQ( c.calls, 0 );
+
+	CHECK( host::lpspi::complete() );
+	CHECK_EQ( c.calls, 1 );
+	CHECK_EQ( c.status, kStatus_Success );
+	CHECK( c.in_isr );
+	CHECK( !spi.busy() );
+	CHECK( !memcmp( tx, rx, sizeof( tx ) ) );
+	CHECK_EQ( spi.wait_transfer_complete(), kStatus_Success );
+}
+
+TEST( acquire_waits_for_transfer_in_progress )
+{
+	//	main-loop caller spins in acquire() until completion interrupt releases the bus
+
+	SPI			spi;
+	context_t	c	= {};
+	uint8_t		a[ 3 ]	= { 0xA0, 0xA1, 0xA2 };
+	uint8_t		b[ 2 ]	= { 0xB0, 0xB1 };
+	uint8_t		rb[ 2 ]	= {};
+	bool		a_done_at_b_start	= false;
+
+	host::lpspi::latency	= 3;
+	host::lpspi::on_start	= [ & ]( host::lpspi::transfer_t & ){ a_done_at_b_start = (1 == c.calls); };
+
+	CHECK_EQ( spi.write_nonblocking( a, nullptr, sizeof( a ), [ &c ]( status_t s ){ done( c, s ); } ), kStatus_Success );
+
+	uint32_t	points	= host::enable_points();
+
+	CHECK_EQ( spi.write( b, rb, sizeof( b ) ), kStatus_Success );
+	CHECK( 3 <= host::enable_points() - points );
+	CHECK( a_done_at_b_start );
+	CHECK_EQ( c.calls, 1 );
+	CHECK_EQ( host::lpspi::log.size(), 2 );
+	CHECK( host::lpspi::log[ 0 ].tx == std::vector<uint8_t>( a, a + sizeof( a ) ) );
+	CHECK( host::lpspi::log[ 1 ].blocking );
+	CHECK( !memcmp( b, rb, sizeof( b ) ) );
+	CHECK( !spi.busy() );
+}
+
+TEST( acquire_is_exclusive )
+{
+	//	second non-blocking request from main-loop also waits, then starts with its own callback
+
+	SPI			spi;
+	context_t	c0	= {};
+	context_t	c1	= {};
+	uint8_t		tx[ 2 ]	= { 1, 2 };
+
+	host::lpspi::latency	= 1;
+
+	CHECK_EQ( spi.write_nonblocking( tx, nullptr, 1, [ &c0 ]( status_t s ){ done( c0, s ); } ), kStatus_Success );
+	CHECK_EQ( spi.write_nonblocking( tx, nullptr, 2, [ &c1 ]( status_t s ){ done( c1, s ); } ), kStatus_Success );
+
+	CHECK_EQ( c0.calls, 1 );
+	CHECK_EQ( c1.calls, 0 );
+	CHECK( spi.busy() );
+
+	CHECK( host::lpspi::complete() );
+	CHECK_EQ( c1.calls, 1 );
+	CHECK( c0.order < c1.order );
+	CHECK_EQ( host::lpspi::log.size(), 2 );
+}
+
+TEST( interrupt_context_gets_busy )
+{
+	//	interrupt cannot wait for the bus owner: kStatus_LPSPI_Busy without touching the transfer in progress
+
+	SPI			spi;
+	context_t	owner	= {};
+	context_t	isr		= {};
+	uint8_t		tx[ 2 ]	= { 1, 2 };
+	status_t	r		= kStatus_Success;
+
+	host::lpspi::latency	= -1;
+
+	CHECK_EQ( spi.write_nonblocking( tx, nullptr, 2, [ &owner ]( status_t s ){ done( owner, s ); } ), kStatus_Success );
+
+	host::run_isr( 10, [ & ](){ r = spi.write_nonblocking( tx, nullptr, 1, [ &isr ]( status_t s ){ done( isr, s ); } ); } );
+
+	CHECK_EQ( r, kStatus_LPSPI_Busy );
+	CHECK( spi.busy() );
+	CHECK_EQ( host::lpspi::log.size(), 1 );
+
+	CHECK( host::lpspi::complete() );
+	CHECK_EQ( owner.calls, 1 );
+	CHECK_EQ( isr.calls, 0 );
+	CHECK( !spi.busy() );
+
+	//	bus is free: interrupt can start a transfer
+
+	host::run_isr( 10, [ & ](){ r = spi.write_nonblocking( tx, nullptr, 1, [ &isr ]( status_t s ){ done( isr, s ); } ); } );
+
+	CHECK_EQ( r, kStatus_Success );
+	CHECK( host::lpspi::complete() );
+	CHECK_EQ( isr.calls, 1 );
+}
+
+TEST( blocking_write_in_interrupt_gets_busy )
+{
+	//	blocking write() in interrupt cannot wait for non-blocking transfer: completion interrupt never preempts it
+
+	SPI			spi;
+	uint8_t		tx[ 2 ]	= { 1, 2 };
+	uint8_t		rx[ 2 ]	= {};
+	status_t	r		= kStatus_Success;
+
+	host::lpspi::latency	= -1;
+
+	CHECK_EQ( spi.write_nonblocking( tx, nullptr, 2 ), kStatus_Success );
+
+	host::run_isr( 10, [ & ](){ r = spi.write( tx, rx, 2 ); } );
+
+	CHECK_EQ( r, kStatus_LPSPI_Busy );
+	CHECK( spi.busy() );
+	CHECK_EQ( host::lpspi::log.size(), 1 );
+
+	CHECK( host::lpspi::complete() );
+
+	//	bus is free: blocking write in interrupt works
+
+	host::run_isr( 10, [ & ](){ r = spi.write( tx, rx, 2 ); } );
+
+	CHECK_EQ( r, kStatus_Success );
+	CHECK( !memcmp( tx, rx, 2 ) );
+	CHECK( !spi.busy() );
+}
+
+TEST( callback_starts_next_transfer )
+{
+	//	xfer_done_cb releases the bus before calling the callback, so the callback can start next transfer
+
+	SPI			spi;
+	context_t	c	= {};
+	uint8_t		a[ 1 ]	= { 0xA0 };
+	uint8_t		b[ 3 ]	= { 0xB0, 0xB1, 0xB2 };
+	uint8_t		rb[ 3 ]	= {};
+
+	c.spi	= &spi;
+	c.tx	= b;
+	c.rx	= rb;
+
+	host::lpspi::latency	= -1;
+
+	auto	first	= [ &c ]( status_t s )
+	{
+		done( c, s );
+		c.next_start	= c.spi->write_nonblocking( c.tx, c.rx, 3, [ &c ]( status_t s ){ c.next_calls++; c.status = s; } );
+	};
+
+	CHECK_EQ( spi.write_nonblocking( a, nullptr, 1, first ), kStatus_Success );
+	CHECK( host::lpspi::complete() );
+
+	CHECK_EQ( c.calls, 1 );
+	CHECK_EQ( c.next_start, kStatus_Success );
+	CHECK( spi.busy() );
+	CHECK_EQ( host::lpspi::log.size(), 2 );
+
+	CHECK( host::lpspi::complete() );
+	CHECK_EQ( c.calls, 1 );
+	CHECK_EQ( c.next_calls, 1 );
+	CHECK( !spi.busy() );
+	CHECK( !memcmp( b, rb, sizeof( b ) ) );
+	CHECK( !host::lpspi::complete() );
+}
+
+TEST( failed_start_releases_bus )
+{
+	SPI			spi;
+	context_t	c	= {};
+	uint8_t		tx[ 1 ]	= { 1 };
+
+	host::lpspi::latency		= -1;
+	host::lpspi::fail_starts	= 1;
+
+	CHECK_EQ( spi.write_nonblocking( tx, nullptr, 1, [ &c ]( status_t s ){ done( c, s ); } ), kStatus_LPSPI_Busy );
+	CHECK( !spi.busy() );
+	CHECK_EQ( spi.last_status, kStatus_LPSPI_Busy );
+	CHECK_EQ( c.calls, 0 );
+
+	CHECK_EQ( spi.write_nonblocking( tx, nullptr, 1, [ &c ]( status_t s ){ done( c, s ); } ), kStatus_Success );
+	CHECK( host::lpspi::complete( kStatus_LPSPI_Error ) );
+	CHECK_EQ( c.calls, 1 );
+	CHECK_EQ( c.status, kStatus_LPSPI_Error );
+	CHECK_EQ( spi.wait_transfer_complete(), kStatus_LPSPI_Error );
+}
+
+TEST( profile_waits_for_transfer_in_progress )
+{
+	SPI			spi;
+	uint8_t		tx[ 1 ]	= { 1 };
+	context_t	c	= {};
+
+	SPI::profile_t	p	= spi.make_profile( 2'000'000, 3 );
+
+	host::lpspi::latency	= 2;
+
+	CHECK_EQ( spi.write_nonblocking( tx, nullptr, 1, [ &c ]( status_t s ){ done( c, s ); } ), kStatus_Success );
+
+	uint32_t	ccr	= host_lpspi1.CCR;
+
+	spi.profile( p );
+
+	CHECK_EQ( c.calls, 1 );
+	CHECK_EQ( host::lpspi::log[ 0 ].ccr, ccr );
+	CHECK_EQ( host_lpspi1.CCR, p.ccr );
+	CHECK_EQ( host_lpspi1.TCR, p.tcr );
+	CHECK( !spi.busy() );
+}
+
+int main( void )
+{
+	return run_tests();
+}
@@ -0,0 +1,311 @@
+/** Host test of SPIBus scheduling (r01lib/SPIBus.cpp) on LPSPI mock
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2026 Tedd OKANO
+ *  Released under the MIT license
+ */
+
+#include	"test.h"
+#include	"r01lib.h"
+
+static constexpr int	cs_pins[]	= { D7, D8, D9 };
+static constexpr int	n_devices	= sizeof( cs_pins ) / sizeof( cs_pins[ 0 ] );
+
+typedef struct	_counter	{
+	int			calls;
+	int			busy;
+	status_t	last;
+} counter_t;
+
+/** Tag each transfer with the device whose CS is asserted. -2 if not exactly one is
+ *
+ * @param devices number of devices on the bus
+ */
+static void tag_by_chip_select( int devices = n_devices )
+{
+	host::lpspi::on_start	= [ devices ]( host::lpspi::transfer_t &t )
+	{
+		int	n	= 0;
+
+		for ( auto i = 0; i < devices; i++ )
+		{
+			if ( !host::pin( cs_pins[ i ] ) )
+			{
+				t.tag	= i;
+				n++;
+			}
+		}
+
+		if ( 1 != n )
+			t.tag	= -2;
+	};
+}
+
+static void count( counter_t &c, status_t s )
+{
+	c.calls++;
+	c.busy	+= (kStatus_Busy == s);
+	c.last	= s;
+}
+
+static int complete_all( void )
+{
+	int	n	= 0;
+
+	while ( host::lpspi::complete() )
+		n++;
+
+	return n;
+}
+
+static bool all_cs_negated( int devices = n_devices )
+{
+	for ( auto i = 0; i < devices; i++ )
+		if ( !host::pin( cs_pins[ i ] ) )
+			return false;
+
+	return true;
+}
+
+TEST( round_robin_across_devices )
+{
+	SPI				spi;
+	SPIBus			bus( spi );
+	SPIBus::Device	dev0( bus, cs_pins[ 0 ] );
+	SPIBus::Device	dev1( bus, cs_pins[ 1 ] );
+	SPIBus::Device	dev2( bus, cs_pins[ 2 ] );
+	SPIBus::Device	*devs[]	= { &dev0, &dev1, &dev2 };
+	counter_t		c[ n_devices ]	= {};
+	uint8_t			tx[ n_devices ][ 2 ];
+
+	host::lpspi::latency	= -1;
+	tag_by_chip_select();
+
+	//	each device queues 4 requests while the first one is on the bus
+
+	for ( auto i = 0; i < n_devices; i++ )
+	{
+		tx[ i ][ 0 ]	= i;
+
+		for ( auto k = 0; k < 4; k++ )
+		{
+			counter_t	*cp	= &c[ i ];
+			CHECK_EQ( devs[ i ]->write_nonblocking( tx[ i ], nullptr, 2, [ cp ]( status_t s ){ count( *cp, s ); } ), kStatus_Success );
+		}
+	}
+
+	CHECK_EQ( complete_all(), 12 );
+	CHECK_EQ( host::lpspi::log.size(), 12 );
+
+	for ( size_t k = 0; k < host::lpspi::log.size(); k++ )
+	{
+		CHECK_EQ( host::lpspi::log[ k ].tag, k % n_devices );
+		CHECK_EQ( host::lpspi::log[ k ].tx[ 0 ], k % n_devices );
+	}
+
+	for ( auto i = 0; i < n_devices; i++ )
+	{
+		CHECK_EQ( c[ i ].calls, 4 );
+		CHECK_EQ( c[ i ].busy, 0 );
+	}
+
+	CHECK_EQ( bus.transfer_count(), 12 );
+	CHECK( all_cs_negated() );
+	CHECK( !spi.busy() );
+}
+
+TEST( busy_device_does_not_starve_others )
+{
+	//	device with a full queue is served once per round while another device keeps adding requests
+
+	SPI				spi;
+	SPIBus			bus( spi );
+	SPIBus::Device	dev0( bus, cs_pins[ 0 ] );
+	SPIBus::Device	dev1( bus, cs_pins[ 1 ] );
+	uint8_t			tx[ 1 ]	= { 0 };
+
+	host::lpspi::latency	= -1;
+	tag_by_chip_select( 2 );
+
+	for ( auto k = 0; k < 4; k++ )
+		CHECK_EQ( dev0.write_nonblocking( tx, nullptr, 1 ), kStatus_Success );
+
+	for ( auto round = 0; round < 6; round++ )
+	{
+		dev1.write_nonblocking( tx, nullptr, 1 );
+		dev0.write_nonblocking( tx, nullptr, 1 );
+		host::lpspi::complete();
+	}
+
+	complete_all();
+
+	int	longest_run	= 0;
+	int	run			= 0;
+
+	for ( size_t k = 1; k < host::lpspi::log.size(); k++ )
+	{
+		run			= (host::lpspi::log[ k ].tag == host::lpspi::log[ k - 1 ].tag) ? run + 1 : 0;
+		longest_run	= std::max( longest_run, run );
+	}
+
+	CHECK_EQ( longest_run, 0 );
+	CHECK( all_cs_negated( 2 ) );
+}
+
+TEST( profile_switched_only_on_change )
+{
+	SPI				spi;
+	SPIBus			bus( spi );
+	SPIBus::Device	dev0( bus, cs_pins[ 0 ] );
+	SPIBus::Device	dev1( bus, cs_pins[ 1 ] );
+	SPIBus::Device	dev2( bus, cs_pins[ 2 ] );
+	uint8_t			tx[ 1 ]	= { 0 };
+
+	dev2.frequency( 2'000'000 );
+	dev2.mode( 1 );
+
+	SPI::profile_t	p_default	= spi.make_profile( SPI_FREQ, 0 );
+	SPI::profile_t	p_dev2		= spi.make_profile( 2'000'000, 1 );
+
+	host::lpspi::latency	= -1;
+	tag_by_chip_select();
+
+	int	base	= host::lpspi::reconfigurations;
+
+	for ( auto k = 0; k < 2; k++ )
+	{
+		dev0.write_nonblocking( tx, nullptr, 1 );
+		dev1.write_nonblocking( tx, nullptr, 1 );
+		dev2.write_nonblocking( tx, nullptr, 1 );
+	}
+
+	CHECK_EQ( complete_all(), 6 );
+
+	//	order 0, 1, 2, 0, 1, 2: first access, 1 -> 2, 2 -> 0, 1 -> 2
+
+	CHECK_EQ( host::lpspi::reconfigurations - base, 4 );
+
+	for ( auto &t : host::lpspi::log )
+	{
+		const SPI::profile_t	&p	= (2 == t.tag) ? p_dev2 : p_default;
+
+		CHECK_EQ( t.ccr, p.ccr );
+		CHECK_EQ( t.tcr, p.tcr );
+	}
+}
+
+TEST( queue_full_returns_busy )
+{
+	SPI				spi;
+	SPIBus			bus( spi );
+	SPIBus::Device	dev0( bus, cs_pins[ 0 ] );
+	counter_t		c	= {};
+	counter_t		*cp	= &c;
+	uint8_t			tx[ 1 ]	= { 0 };
+
+	host::lpspi::latency	= -1;
+
+	//	queue keeps the request on the bus until it completes. One element of storage is unused
+
+	for ( auto k = 0; k < 4; k++ )
+		CHECK_EQ( dev0.write_nonblocking( tx, nullptr, 1, [ cp ]( status_t s ){ count( *cp, s ); } ), kStatus_Success );
+
+	CHECK_EQ( dev0.write_nonblocking( tx, nullptr, 1, [ cp ]( status_t s ){ count( *cp, s ); } ), kStatus_Busy );
+	CHECK_EQ( host::lpspi::log.size(), 1 );
+
+	CHECK( host::lpspi::complete() );
+	CHECK_EQ( dev0.write_nonblocking( tx, nullptr, 1, [ cp ]( status_t s ){ count( *cp, s ); } ), kStatus_Success );
+
+	CHECK_EQ( complete_all(), 4 );
+	CHECK_EQ( c.calls, 5 );
+	CHECK_EQ( c.busy, 0 );
+	CHECK_EQ( bus.transfer_count(), 5 );
+}
+
+TEST( start_failure_completes_through_queue )
+{
+	//	_spi.write_nonblocking() failure is reported by complete( kStatus_Busy ), which dispatches next request.
+	//	All queued requests are finished in one chain without leaving CS asserted
+
+	SPI				spi;
+	SPIBus			bus( spi );
+	SPIBus::Device	dev0( bus, cs_pins[ 0 ] );
+	SPIBus::Device	dev1( bus, cs_pins[ 1 ] );
+	SPIBus::Device	dev2( bus, cs_pins[ 2 ] );
+	SPIBus::Device	*devs[]	= { &dev0, &dev1, &dev2 };
+	counter_t		c[ n_devices ]	= {};
+	uint8_t			tx[ 1 ]	= { 0 };
+
+	host::lpspi::latency	= -1;
+
+	for ( auto i = 0; i < n_devices; i++ )
+	{
+		for ( auto k = 0; k < 4; k++ )
+		{
+			counter_t	*cp	= &c[ i ];
+			devs[ i ]->write_nonblocking( tx, nullptr, 1, [ cp ]( status_t s ){ count( *cp, s ); } );
+		}
+	}
+
+	host::lpspi::fail_starts	= 100;
+
+	CHECK( host::lpspi::complete() );
+
+	CHECK_EQ( c[ 0 ].calls + c[ 1 ].calls + c[ 2 ].calls, 12 );
+	CHECK_EQ( c[ 0 ].busy, 3 );
+	CHECK_EQ( c[ 1 ].busy, 4 );
+	CHECK_EQ( c[ 2 ].busy, 4 );
+	CHECK_EQ( bus.transfer_count(), 12 );
+	CHECK_EQ( host::lpspi::log.size(), 1 );
+	CHECK( !host::lpspi::busy() );
+	CHECK( !spi.busy() );
+	CHECK( all_cs_negated() );
+
+	//	bus is usable after the failures
+
+	host::lpspi::fail_starts	= 0;
+
+	CHECK_EQ( dev1.write_nonblocking( tx, nullptr, 1 ), kStatus_Success );
+	CHECK( host::lpspi::busy() );
+	CHECK( host::lpspi::complete() );
+	CHECK_EQ( bus.transfer_count(), 13 );
+}
+
+TEST( blocking_write_returns_start_failure )
+{
+	SPI				spi;
+	SPIBus			bus( spi );
+	SPIBus::Device	dev0( bus, cs_pins[ 0 ] );
+	uint8_t			tx[ 2 ]	= { 0x12, 0x34 };
+	uint8_t			rx[ 2 ]	= {};
+
+	host::lpspi::latency		= 0;
+	host::lpspi::fail_starts	= 1;
+
+	CHECK_EQ( dev0.write( tx, rx, 2 ), kStatus_Busy );
+	CHECK_EQ( dev0.last_status, kStatus_Busy );
+
+	CHECK_EQ( dev0.write( tx, rx, 2 ), kStatus_Success );
+	CHECK( !memcmp( tx, rx, 2 ) );
+	CHECK( all_cs_negated( 1 ) );
+}
+
+TEST( blocking_write_in_interrupt_returns_busy )
+{
+	SPI				spi;
+	SPIBus			bus( spi );
+	SPIBus::Device	dev0( bus, cs_pins[ 0 ] );
+	uint8_t			tx[ 1 ]	= { 0 };
+	status_t		r		= kStatus_Success;
+
+	host::run_isr( 10, [ & ](){ r = dev0.write( tx, nullptr, 1 ); } );
+
+	CHECK_EQ( r, kStatus_Busy );
+	CHECK( host::lpspi::log.empty() );
+}
+
+int main( void )
+{
+	return run_tests();
+}
@@ -0,0 +1,204 @@
+/** Host test of ChannelStatistics against double-precision and brute-force references
+ *
+ *  @author  Tedd OKANO
+ *
+ *  Copyright: 2023 - 2026 Tedd OKANO
+ *  Released under the MIT license
+ *
+ *	Mean, standard deviation, RMS and min/max of interleaved channels against two-pass evaluation in long double,
+ *	including small noise on a large offset and full int32 range. Histogram bins against counting each sample.
+ */
+
+#include	"test.h"
+#include	"afe/ChannelStatistics.h"
+#include	<algorithm>
+#include	<numeric>
+#include	<vector>
+#include	<math.h>
+
+static constexpr int	channels	= 4;
+
+/** Deterministic test input */
+static int32_t random32( uint32_t &seed )
+{
+	seed	= seed * 1664525 + 1013904223;	//	LCG
+	return (int32_t)seed;
+}
+
+/** Test signal of a channel */
+static int32_t signal( int ch, uint32_t &seed )
+{
+	switch ( ch )
+	{
+		case 0:		return random32( seed ) >> 8;							//	full 24 bit range
+		case 1:		return 0x7FFF00 + (random32( seed ) >> 26);				//	small noise on a large offset
+		case 2:		return (random32( seed ) < 0) ? INT32_MIN : INT32_MAX;	//	full int32 range
+		default:	return -12345;
+	}
+}
+
+/** Accumulate in blocks of varying size */
+static void feed( ChannelStatistics &st, const std::vector<int32_t> &x )
+{
+	int	frames	= x.size() / channels;
+
+	for ( auto f = 0, block = 1; f < frames; f += block, block = block % 61 + 1 )
+	{
+		std::vector<int32_t>	buf( x.begin() + f * channels, x.begin() + std::min( f + block, frames ) * channels );
+		int						n	= buf.size() / channels;
+
+		CHECK_EQ( st.process( buf.data(), n, channels ), n );
+		CHECK( std::equal( buf.begin(), buf.end(), x.begin() + f * channels ) );
+	}
+}
+
+TEST( summary_against_reference )
+{
+	constexpr int			frames	= 100000;
+	uint32_t				seed	= 1;
+	std::vector<int32_t>	x( frames * channels );
+
+	for ( auto f = 0; f < frames; f++ )
+		for ( auto c = 0; c < channels; c++ )
+			x[ f * channels + c ]	= signal( c, seed );
+
+	ChannelStatistics	st;
+
+	feed( st, x );
+
+	for ( auto c = 0; c < channels; c++ )
+	{
+		//	reference: two-pass in long double
+
+		long double	sum	= 0, sq = 0, dev = 0;
+		int32_t		lo	= INT32_MAX, hi = INT32_MIN;
+
+		for ( auto f = 0; f < frames; f++ )
+		{
+			int32_t	v	= x[ f * channels + c ];
+
+			sum	+= v;
+			sq	+= (long double)v * v;
+			lo	 = std::min( lo, v );
+			hi	 = std::max( hi, v );
+		}
+
+		long double	mean	= sum / frames;
+
+		for ( auto f = 0; f < frames; f++ )
+			dev	+= (x[ f * channels + c ] - mean) * (x[ f * channels + c ] - mean);
+
+		double	stddev	= sqrtl( dev / (frames - 1) );
+		double	rms		= sqrtl( sq / frames );
+
+		ChannelStatistics::summary_t	s	= st.summary( c );
+
+		printf( "  ch %d: mean %16.6f (ref %16.6f), stddev %14.6f (ref %14.6f)\n", c, s.mean, (double)mean, s.stddev, stddev );
+
+		CHECK_EQ( s.count, frames );
+		CHECK_EQ( s.min, lo );
+		CHECK_EQ( s.max, hi );
+		CHECK_EQ( s.p2p, hi - lo );
+		CHECK( fabs( s.mean - mean ) <= 1e-9 * std::max( 1.0, fabs( (double)mean ) ) );
+		CHECK( fabs( s.stddev - stddev ) <= 1e-9 * std::max( 1.0, stddev ) );
+		CHECK( fabs( s.rms - rms ) <= 1e-9 * std::max( 1.0, rms ) );
+	}
+
+	CHECK( st.summary( 3 ).stddev == 0.0 );
+
+	//	channels not in the frame have no data
+
+	ChannelStatistics::summary_t	empty	= st.summary( channels );
+
+	CHECK_EQ( empty.count, 0 );
+	CHECK( 0.0 == empty.mean );
+	CHECK_EQ( empty.p2p, 0 );
+
+	//	reset clears accumulation
+
+	st.reset();
+	CHECK_EQ( st.summary( 0 ).count, 0 );
+
+	int32_t	v	= 100;
+
+	st.process( &v, 1, 1 );
+	CHECK( 100.0 == st.summary( 0 ).mean );
+	CHECK( 0.0 == st.summary( 0 ).stddev );
+	CHECK( 100.0 == st.summary( 0 ).rms );
+}
+
+TEST( histogram_against_reference )
+{
+	constexpr int			frames	= 20000;
+	constexpr int			n_bins	= 64;
+	constexpr int32_t		low[]	= { -32, 0x7FFF00 + 4, -1000, -12345 };
+	constexpr int			shift[]	= {   0,            0,     3,      0 };
+	uint32_t				seed	= 3;
+	std::vector<int32_t>	x( frames * channels );
+
+	for ( auto f = 0; f < frames; f++ )
+	{
+		x[ f * channels + 0 ]	= random32( seed ) >> 25;		//	-64 ~ 63: both sides out of range
+		x[ f * channels + 1 ]	= signal( 1, seed );
+		x[ f * channels + 2 ]	= random32( seed ) >> 22;		//	-512 ~ 511 in 8 code bins
+		x[ f * channels + 3 ]	= signal( 3, seed );
+	}
+
+	ChannelStatistics	st;
+	uint32_t			bins[ channels ][ n_bins ];
+
+	for ( auto c = 0; c < channels; c++ )
+	{
+		std::fill( bins[ c ], bins[ c ] + n_bins, 0xDEADBEEF );
+		st.histogram( c, bins[ c ], n_bins, low[ c ], shift[ c ] );
+	}
+
+	for ( auto repeat = 0; repeat < 2; repeat++ )	//	reset clears bins and keeps histogram settings
+	{
+		st.reset();
+		feed( st, x );
+
+		for ( auto c = 0; c < channels; c++ )
+		{
+			uint32_t	ref[ n_bins ]	= {};
+			uint32_t	under			= 0;
+			uint32_t	over			= 0;
+
+			for ( auto f = 0; f < frames; f++ )
+			{
+				int64_t	i	= (int64_t)x[ f * channels + c ] - low[ c ];
+
+				if ( i < 0 )
+					under++;
+				else if ( (n_bins << shift[ c ]) <= i )
+					over++;
+				else
+					ref[ i >> shift[ c ] ]++;
+			}
+
+			CHECK( std::equal( ref, ref + n_bins, bins[ c ] ) );
+			CHECK_EQ( st.histogram_underflow( c ), under );
+			CHECK_EQ( st.histogram_overflow( c ), over );
+			CHECK_EQ( under + over + std::accumulate( bins[ c ], bins[ c ] + n_bins, 0u ), frames );
+		}
+	}
+
+	CHECK( 0 < st.histogram_underflow( 0 ) );
+	CHECK( 0 < st.histogram_overflow( 0 ) );
+	CHECK_EQ( bins[ 3 ][ 0 ], frames );
+
+	//	disabled histogram is not touched
+
+	st.histogram( 0, nullptr, n_bins, 0 );
+	bins[ 0 ][ 0 ]	= 0xDEADBEEF;
+	feed( st, x );
+
+	CHECK_EQ( bins[ 0 ][ 0 ], 0xDEADBEEF );
+	CHECK_EQ( st.histogram_underflow( 0 ), 0 );
+	CHECK_EQ( st.summary( 0 ).count, 2 * frames );
+}
+
+int main( void )
+{
+	return run_tests();
+}